@@ -0,0 +1,330 @@
+#pragma once
+
+#include "udp.h"
+#include "error_code.h"
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <expected>
+#include <memory>
+#include <utility>
+
+namespace pulse::net::udp {
+
+    class AsyncSocket;
+    class EventLoop;
+
+    // Recycles coroutine frames through per-thread free lists sorted by size, so spawning a task costs
+    // a pointer pop once the pool is warm. Frames larger than kMaxPooledFrame go to the global heap.
+    class FramePool {
+    public:
+        static constexpr size_t kMaxPooledFrame = 4096;
+
+        // nullptr when the heap is exhausted.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        static void* allocate(size_t size) noexcept;
+
+        // Takes frames from any thread; they join that thread's free list.
+        static void deallocate(void* frame, size_t size) noexcept;
+    };
+
+    // A fire-and-forget coroutine, e.g. one per peer. It doesn't start until handed to EventLoop::spawn(),
+    // runs on the loop's thread, and frees its frame when it returns. Exceptions escaping it terminate.
+    // If the frame can't be allocated the Task is empty and spawn() refuses it.
+    class Task {
+    public:
+        struct promise_type {
+            Task get_return_object() noexcept {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            static Task get_return_object_on_allocation_failure() noexcept { return Task(); }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            std::suspend_never final_suspend() noexcept { return {}; }
+            void return_void() noexcept {}
+            void unhandled_exception() noexcept { std::terminate(); }
+
+            static void* operator new(size_t size) noexcept { return FramePool::allocate(size); }
+            static void operator delete(void* frame, size_t size) noexcept { FramePool::deallocate(frame, size); }
+        };
+
+        Task() = default;
+        Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+        Task& operator=(Task&& other) noexcept {
+            std::swap(handle_, other.handle_);
+            return *this;
+        }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        ~Task() {
+            if (handle_) {
+                handle_.destroy(); // Never spawned
+            }
+        }
+
+        explicit operator bool() const noexcept { return static_cast<bool>(handle_); }
+
+    private:
+        friend class EventLoop;
+
+        explicit Task(std::coroutine_handle<> handle) noexcept : handle_(handle) {}
+
+        std::coroutine_handle<> handle_;
+    };
+
+    // A task handed back to its loop by an AsyncSocket destroyed while the task waited on it. The link
+    // lives in the task's awaiter, so handing it over never allocates.
+    struct OrphanedTask {
+        std::coroutine_handle<> handle;
+        OrphanedTask* next = nullptr;
+    };
+
+    // Runs Tasks and resumes them when the sockets they await become ready. Everything except wake()
+    // must be called from the thread that runs poll(); tasks only ever run inside poll().
+    class EventLoop {
+    public:
+        virtual ~EventLoop() = default;
+
+        // Queues `task` to start on the next poll(). Fails with InvalidArgument if the task is empty.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> spawn(Task task) {
+            if (!task) {
+                return make_unexpected(ErrorCode::InvalidArgument, "Task frame could not be allocated");
+            }
+            auto scheduled = schedule(task.handle_);
+            if (scheduled) {
+                task.handle_ = nullptr; // The loop owns it now; on failure ~Task() frees the frame
+            }
+            return scheduled;
+        }
+
+        // Runs queued tasks, then waits up to `timeoutMs` (-1 waits forever, 0 never blocks) for socket
+        // readiness and resumes the tasks waiting on it. It doesn't wait at all if it already ran something
+        // or has work left over. Returns the number of resumptions.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<size_t, Error> poll(int timeoutMs) = 0;
+
+        // Makes a blocked poll() return early. Safe to call from any thread.
+        virtual void wake() = 0;
+
+    protected:
+        friend class AsyncSocket;
+
+        // Resumes `handle` on the next poll(). On failure the handle is left untouched.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<void, Error> schedule(std::coroutine_handle<> handle) = 0;
+
+        // Resumes `task` on the next poll() like schedule(), but can't fail: the loop links it into a list
+        // of its own. `task` must stay put until then.
+        virtual void adopt(OrphanedTask& task) noexcept = 0;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<void, Error> watch(AsyncSocket& socket) = 0;
+
+        // Stops watching `socket`; safe to call while poll() is dispatching it, and never throws, since
+        // ~AsyncSocket() calls it.
+        virtual void unwatch(AsyncSocket& socket) = 0;
+
+        // Asks for (or stops asking for) a wakeup when `socket` has send buffer space again.
+        virtual void watchWritable(AsyncSocket& socket, bool enabled) = 0;
+    };
+
+    // Epoll on Linux. Returns Unsupported elsewhere.
+    [[nodiscard("Don't ask for an event loop and then ignore it.")]]
+    std::expected<std::unique_ptr<EventLoop>, Error> create_event_loop();
+
+    // Awaitable operations on an ISocket, for Tasks running on an EventLoop. Each operation is tried
+    // straight away and only suspends on WouldBlock; the loop retries it when the descriptor is ready
+    // and resumes the task with the outcome. Awaiting never allocates: the pending operation lives in
+    // the awaiting coroutine's frame. Any number of tasks may wait on one socket; they are served in
+    // the order they started waiting.
+    //
+    // The socket must outlive the AsyncSocket, and the AsyncSocket must not outlive its EventLoop.
+    // Destroying the AsyncSocket resumes every waiting task with InvalidSocket on the next poll(), never
+    // from inside the destructor.
+    class AsyncSocket {
+    public:
+        class RecvAwaiter;
+        class SendAwaiter;
+
+        ~AsyncSocket();
+
+        AsyncSocket(const AsyncSocket&) = delete;
+        AsyncSocket& operator=(const AsyncSocket&) = delete;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<AsyncSocket>, Error> Create(EventLoop& loop, ISocket& socket);
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        ISocket& socket() const noexcept { return socket_; }
+
+        // co_await yields what ISocket::recvFrom() would. The zero-copy view follows the same rule: it is
+        // valid until the next receive on this socket, by this task or any other.
+        [[nodiscard("Awaitables do nothing unless you co_await them.")]]
+        RecvAwaiter recv() noexcept;
+
+        // Receives into the caller's buffer, which stays valid across suspensions.
+        [[nodiscard("Awaitables do nothing unless you co_await them.")]]
+        RecvAwaiter recv(ReceivedPacket&& buffer) noexcept;
+
+        // co_await yields what ISocket::sendTo() would. `data` must stay valid until the await completes.
+        [[nodiscard("Awaitables do nothing unless you co_await them.")]]
+        SendAwaiter sendTo(const Addr& addr, const uint8_t* data, size_t length) noexcept;
+
+        [[nodiscard("Awaitables do nothing unless you co_await them.")]]
+        SendAwaiter send(const uint8_t* data, size_t length) noexcept;
+
+    private:
+        // Intrusive FIFO of suspended awaiters.
+        template <typename Awaiter>
+        struct WaitQueue {
+            Awaiter* head = nullptr;
+            Awaiter* tail = nullptr;
+
+            bool empty() const noexcept { return head == nullptr; }
+
+            void push(Awaiter* waiter) noexcept {
+                waiter->next_ = nullptr;
+                (tail ? tail->next_ : head) = waiter;
+                tail = waiter;
+            }
+
+            Awaiter* pop() noexcept {
+                Awaiter* waiter = head;
+                head = waiter->next_;
+                if (head == nullptr) {
+                    tail = nullptr;
+                }
+                return waiter;
+            }
+        };
+
+    public:
+        class RecvAwaiter {
+        public:
+            bool await_ready() noexcept {
+                // Queued waiters mean the socket was drained and hasn't signalled since; don't jump the line.
+                if (!owner_.recv_waiters_.empty()) {
+                    return false;
+                }
+                result_ = attempt();
+                return !wouldBlock();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) noexcept {
+                handle_ = handle;
+                owner_.recv_waiters_.push(this);
+            }
+
+            std::expected<ReceivedPacket, Error> await_resume() noexcept { return std::move(result_); }
+
+        private:
+            friend class AsyncSocket;
+            friend struct WaitQueue<RecvAwaiter>;
+
+            RecvAwaiter(AsyncSocket& owner, ReceivedPacket buffer) noexcept : owner_(owner), buffer_(buffer) {}
+
+            std::expected<ReceivedPacket, Error> attempt() {
+                if (buffer_.data == nullptr) {
+                    return owner_.socket_.recvFrom();
+                }
+                return owner_.socket_.recvFrom(ReceivedPacket(buffer_));
+            }
+
+            bool wouldBlock() const noexcept { return !result_ && result_.error() == ErrorCode::WouldBlock; }
+
+            AsyncSocket& owner_;
+            ReceivedPacket buffer_; // data == nullptr selects the zero-copy recvFrom()
+            std::expected<ReceivedPacket, Error> result_ = make_unexpected(ErrorCode::WouldBlock);
+            std::coroutine_handle<> handle_;
+            RecvAwaiter* next_ = nullptr;
+            OrphanedTask orphan_; // Our link in the loop's list if the socket goes away first
+        };
+
+        class SendAwaiter {
+        public:
+            bool await_ready() noexcept {
+                if (!owner_.send_waiters_.empty()) {
+                    return false;
+                }
+                result_ = attempt();
+                return !wouldBlock();
+            }
+
+            void await_suspend(std::coroutine_handle<> handle) noexcept {
+                handle_ = handle;
+                if (owner_.send_waiters_.empty()) {
+                    owner_.loop_.watchWritable(owner_, true);
+                }
+                owner_.send_waiters_.push(this);
+            }
+
+            std::expected<void, Error> await_resume() noexcept { return std::move(result_); }
+
+        private:
+            friend class AsyncSocket;
+            friend struct WaitQueue<SendAwaiter>;
+
+            SendAwaiter(AsyncSocket& owner, const Addr* addr, const uint8_t* data, size_t length) noexcept
+                : owner_(owner), addr_(addr), data_(data), length_(length) {}
+
+            std::expected<void, Error> attempt() {
+                if (addr_ == nullptr) {
+                    return owner_.socket_.send(data_, length_);
+                }
+                return owner_.socket_.sendTo(*addr_, data_, length_);
+            }
+
+            bool wouldBlock() const noexcept { return !result_ && result_.error() == ErrorCode::WouldBlock; }
+
+            AsyncSocket& owner_;
+            const Addr* addr_; // nullptr selects send() on a connected socket
+            const uint8_t* data_;
+            size_t length_;
+            std::expected<void, Error> result_ = make_unexpected(ErrorCode::WouldBlock);
+            std::coroutine_handle<> handle_;
+            SendAwaiter* next_ = nullptr;
+            OrphanedTask orphan_;
+        };
+
+        // Called by the loop when the descriptor reports readiness: retries the oldest queued operation and,
+        // if it completed, dequeues it and returns the task to resume. A null handle means it would still
+        // block (or nothing is queued). The task must be resumed before the next call, and resuming it may
+        // destroy this AsyncSocket.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        std::coroutine_handle<> completeRecv();
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        std::coroutine_handle<> completeSend();
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        bool hasSendWaiters() const noexcept { return !send_waiters_.empty(); }
+
+    private:
+        AsyncSocket(EventLoop& loop, ISocket& socket) noexcept : loop_(loop), socket_(socket) {}
+
+        EventLoop& loop_;
+        ISocket& socket_;
+        WaitQueue<RecvAwaiter> recv_waiters_;
+        WaitQueue<SendAwaiter> send_waiters_;
+    };
+
+    inline AsyncSocket::RecvAwaiter AsyncSocket::recv() noexcept {
+        return RecvAwaiter(*this, ReceivedPacket{ .data = nullptr, .size = 0, .capacity = 0, .addr = {} });
+    }
+
+    inline AsyncSocket::RecvAwaiter AsyncSocket::recv(ReceivedPacket&& buffer) noexcept {
+        return RecvAwaiter(*this, buffer);
+    }
+
+    inline AsyncSocket::SendAwaiter AsyncSocket::sendTo(const Addr& addr, const uint8_t* data, size_t length) noexcept {
+        return SendAwaiter(*this, &addr, data, length);
+    }
+
+    inline AsyncSocket::SendAwaiter AsyncSocket::send(const uint8_t* data, size_t length) noexcept {
+        return SendAwaiter(*this, nullptr, data, length);
+    }
+
+} // namespace pulse::net::udp
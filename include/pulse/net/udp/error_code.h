@@ -3,6 +3,9 @@
 #include <string>
 #include <string_view>
 #include <exception>
+#include <new>
+#include <system_error>
+#include <type_traits>
 #include <expected>
 
 namespace pulse::net::udp {
@@ -23,47 +26,66 @@ namespace pulse::net::udp {
         SocketCreateFailed,
         SocketConfigFailed,
         WSAStartupFailed,
+        InvalidArgument,
+        Unsupported,
+        PollFailed,
+        PoolExhausted,
+        Truncated,
         Unknown = 9999
     };
     inline constexpr const char* error_to_string(ErrorCode code) noexcept;
 
-    // Error is POD and we therefore allow direct construction because we ensure that the constructor is constexpr.
+    // Error is trivially copyable so the expected-return path never allocates: WouldBlock costs the same as
+    // returning an int. `native` is the errno (or WSAGetLastError()) behind the failure, 0 when there isn't one.
+    // The human-readable message is only built when what() is called.
     struct Error {
     public:
         ErrorCode code;
-        std::string message;
-    
+        int native = 0;
+        const char* detail = nullptr; // Always a string literal; Error never owns memory.
+
         constexpr Error(ErrorCode c) noexcept : code(c) {}
-        Error(ErrorCode c, const std::exception& e) noexcept : code(c), message(concat(c, e.what())) {}
-        Error(ErrorCode c, std::string msg) noexcept : code(c), message(concat(c, std::move(msg))) {}
-    
+        constexpr Error(ErrorCode c, int native_code) noexcept : code(c), native(native_code) {}
+        constexpr Error(ErrorCode c, const char* static_detail) noexcept : code(c), detail(static_detail) {}
+        constexpr Error(ErrorCode c, int native_code, const char* static_detail) noexcept
+            : code(c), native(native_code), detail(static_detail) {}
+        // Only the kind of exception survives; its what() may not outlive the catch block.
+        Error(ErrorCode c, const std::exception& e) noexcept
+            : code(c), detail(dynamic_cast<const std::bad_alloc*>(&e) ? "Out of memory" : "Unexpected exception") {}
+
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
-        std::string_view what() const noexcept {
-            if (!message.empty()) {
+        std::string what() const noexcept {
+            try {
+                std::string message = error_to_string(code);
+                if (detail != nullptr) {
+                    message += ": ";
+                    message += detail;
+                }
+                if (native != 0) {
+                    message += ": ";
+                    message += std::system_category().message(native);
+                    message += " (" + std::to_string(native) + ")";
+                }
                 return message;
-            } else {
-                return error_to_string(code);
+            } catch (...) {
+                return {}; // Formatting can only fail on allocation; there's nothing better to return.
             }
         }
-    
+
         [[nodiscard("If you're going to use this, you should probably do something with it.")]]
         ErrorCode code_value() const noexcept { return code; }
-    
+
+        [[nodiscard("If you're going to use this, you should probably do something with it.")]]
+        int native_value() const noexcept { return native; }
+
         bool operator==(ErrorCode other) const noexcept { return code == other; }
         bool operator!=(ErrorCode other) const noexcept { return code != other; }
-
-    private:
-        static std::string concat(ErrorCode code, const std::string& msg) noexcept {
-            try {
-                return std::string(error_to_string(code)) + ": " + msg;
-            } catch (...) {
-                return std::string(error_to_string(code)); // fallback if even std::string throws (rare but technically possible)
-            }
-        }
     };
 
+    static_assert(std::is_trivially_copyable_v<Error>, "Error must stay cheap enough to return from every recv");
+
     inline std::string to_string(const Error& error) noexcept {
-        return std::string(error.what()); // Always return a copy to be safe
+        return error.what();
     }
 
     template <class T>
@@ -95,6 +117,11 @@ namespace pulse::net::udp {
             case ErrorCode::SocketCreateFailed: return "Socket creation failed";
             case ErrorCode::SocketConfigFailed: return "Socket configuration failed";
             case ErrorCode::WSAStartupFailed: return "WSAStartup failed";
+            case ErrorCode::InvalidArgument: return "Invalid argument";
+            case ErrorCode::Unsupported: return "Not supported on this system";
+            case ErrorCode::PollFailed: return "Poll failed";
+            case ErrorCode::PoolExhausted: return "Packet pool exhausted";
+            case ErrorCode::Truncated: return "Datagram larger than the socket's maximum";
             default: return "Unknown error";
         }
     }
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "socket_factory.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    // What the emulated network does to each datagram. Every decision is made on its own from the sending
+    // socket's random stream: the datagram may be lost, then waits its turn on the sender's link, then
+    // travels for latencyNs ± jitterNs. Rates are probabilities from 0 to 1.
+    struct MemoryNetworkOptions {
+        int64_t latencyNs = 0;
+        int64_t jitterNs = 0;        // Uniform around latencyNs; enough of it reorders datagrams by itself
+        double lossRate = 0.0;
+        double duplicateRate = 0.0;  // The copy arrives together with the original
+        double reorderRate = 0.0;    // Skips the latency, overtaking whatever is still in flight
+        uint64_t bandwidth = 0;      // Payload bytes per second leaving each socket; 0 is unlimited
+
+        // The same seed, with sockets created and used in the same order, makes the same decisions.
+        uint64_t seed = 0;
+
+        // Datagrams each socket can hold, in flight and queued together; more are dropped, like a full
+        // receive buffer. Each socket preallocates this many buffers of its maxDatagramSize.
+        size_t queueCapacity = 4096;
+
+        // Time stands still until advance(), so latency and bandwidth play out the same on every run.
+        // Otherwise the network follows steady_clock.
+        bool manualClock = false;
+    };
+
+    // Totals across every socket the network has created, closed ones included.
+    struct MemoryNetworkStats {
+        uint64_t sent = 0;        // Datagrams handed to the network; duplicates aren't counted
+        uint64_t delivered = 0;   // Datagrams returned by a receive, duplicates included
+        uint64_t lost = 0;
+        uint64_t duplicated = 0;
+        uint64_t reordered = 0;
+        uint64_t overflowed = 0;  // Dropped because the destination's queue was full
+        uint64_t unreachable = 0; // Sent to an address nobody listens on
+    };
+
+    class MemoryFabric;
+
+    // An ISocketFactory whose sockets never enter the kernel, for load and latency tests that should
+    // measure your code rather than the network stack. listen() and dial() create endpoints inside this
+    // process; a send copies the datagram into a buffer from the receiver's own pool and hands it over
+    // through a lock-free queue. Addresses only mean something within one network: a dialed socket gets
+    // an ephemeral port on loopback, and one listening on the wildcard address answers as loopback.
+    //
+    // Sockets keep the ISocket contract, but options that configure the kernel are ignored, pacing and
+    // timestamps are Unsupported, and there is no descriptor to poll: getHandle() is Unsupported. A
+    // socket may send from one thread while another receives. Sockets may outlive the network.
+    class MemoryNetwork final : public ISocketFactory {
+    public:
+        ~MemoryNetwork() override;
+
+        MemoryNetwork(const MemoryNetwork&) = delete;
+        MemoryNetwork& operator=(const MemoryNetwork&) = delete;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<MemoryNetwork>, Error> Create(const MemoryNetworkOptions& options = {});
+
+        using ISocketFactory::listen;
+        using ISocketFactory::dial;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<std::unique_ptr<ISocket>, Error> listen(const Addr& bindAddr) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<std::unique_ptr<ISocket>, Error> dial(const Addr& remoteAddr) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<std::unique_ptr<ISocket>, Error> listenWithOptions(const Addr& bindAddr, const SocketOptions& options) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<std::unique_ptr<ISocket>, Error> dialWithOptions(const Addr& remoteAddr, const SocketOptions& options) override;
+
+        // Peers are spread over the shards by a hash of their address, as SO_REUSEPORT does.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<std::vector<std::unique_ptr<ISocket>>, Error> listenSharded(const Addr& bindAddr, size_t shards, const SocketOptions& options = {}) override;
+
+        // Moves the manual clock forward; does nothing on a network that follows steady_clock.
+        void advance(int64_t nanoseconds) noexcept;
+
+        // Nanoseconds since the network was created, by whichever clock it uses.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        int64_t now() const noexcept;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        MemoryNetworkStats stats() const noexcept;
+
+    private:
+        explicit MemoryNetwork(std::shared_ptr<MemoryFabric> fabric) noexcept;
+
+        std::shared_ptr<MemoryFabric> fabric_;
+    };
+
+} // namespace pulse::net::udp
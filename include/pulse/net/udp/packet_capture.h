@@ -0,0 +1,158 @@
+#pragma once
+
+#include <pulse/net/udp/error_code.h>
+#include <pulse/net/udp/udp_addr.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace pulse::net::udp {
+
+    enum class CaptureFormat {
+        PcapNg, // Records which way each datagram went
+        Pcap,   // Classic libpcap with nanosecond timestamps, for older tools
+    };
+
+    enum class CaptureDirection : uint8_t {
+        Received,
+        Sent,
+    };
+
+    struct PacketCaptureOptions {
+        // The first file; rotation continues with path.1, path.2 and so on.
+        std::string path;
+        CaptureFormat format = CaptureFormat::PcapNg;
+
+        // Payload bytes kept per datagram; the rest is cut off, but its original length is recorded.
+        // IP and UDP headers are rebuilt from the addresses, so they cost nothing here.
+        uint32_t snapLength = 256;
+
+        // Keep one datagram in every sampleEvery, counted per socket and direction.
+        uint32_t sampleEvery = 1;
+
+        // Memory for datagrams waiting to be written. When the writer falls behind, new ones are dropped
+        // and counted rather than slowing the socket down.
+        size_t ringBytes = 4 << 20;
+
+        // Start a new file once the current one reaches rotateBytes (0 never rotates), and delete the
+        // oldest beyond maxFiles (0 keeps them all).
+        uint64_t rotateBytes = 0;
+        size_t maxFiles = 0;
+
+        // How often the writer thread wakes to drain the ring and flush.
+        std::chrono::milliseconds flushInterval{100};
+    };
+
+    struct PacketCaptureStats {
+        uint64_t captured = 0; // Taken into the ring
+        uint64_t dropped = 0;  // Ring full, or the file couldn't be written
+        uint64_t written = 0;  // On disk (or at least handed to the C library)
+        uint64_t files = 0;    // Opened so far, rotation included
+    };
+
+    // Copies datagrams into a preallocated lock-free ring and streams them to pcapng or pcap files from a
+    // background thread, so a busy host can be debugged without tcpdump. Attach one to as many sockets as
+    // you like with SocketOptions::capture; each datagram then costs a copy of up to snapLength bytes
+    // into the ring, and sampling cuts that to a countdown for the ones skipped. Sockets without a
+    // capture pay a null check. setEnabled(false) pauses it without touching the sockets.
+    //
+    // Datagrams are written as raw IPv4 or IPv6 packets (LINKTYPE_RAW) with headers rebuilt from the
+    // socket's local and peer addresses; the UDP checksum is left at zero.
+    class PacketCapture {
+    public:
+        ~PacketCapture(); // Writes whatever is still in the ring and stops the writer thread
+
+        PacketCapture(const PacketCapture&) = delete;
+        PacketCapture& operator=(const PacketCapture&) = delete;
+
+        // Opens the first file and starts the writer thread.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::shared_ptr<PacketCapture>, Error> Create(const PacketCaptureOptions& options);
+
+        // Copies one datagram into the ring; drops it if the ring is full. Safe from any thread. Sockets
+        // call this themselves; it's public for ISocket implementations outside the library.
+        void record(CaptureDirection direction, const Addr& local, const Addr& peer, const uint8_t* data, size_t length) noexcept;
+
+        // Blocks until everything recorded before the call has been written and flushed.
+        void flush();
+
+        void setEnabled(bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+
+        [[nodiscard("Why ask and then ignore the answer?")]]
+        bool enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        uint32_t sampleEvery() const noexcept { return options_.sampleEvery; }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        PacketCaptureStats stats() const noexcept;
+
+    private:
+        // One datagram in the ring, followed by snapLength payload bytes.
+        struct alignas(64) Record {
+            std::atomic<uint64_t> sequence{0};
+            int64_t timestamp_ns = 0; // CLOCK_REALTIME
+            Addr local;
+            Addr peer;
+            uint32_t length = 0;   // As sent or received
+            uint32_t captured = 0; // Bytes that follow
+            CaptureDirection direction = CaptureDirection::Received;
+
+            uint8_t* payload() noexcept { return reinterpret_cast<uint8_t*>(this + 1); }
+            const uint8_t* payload() const noexcept { return reinterpret_cast<const uint8_t*>(this + 1); }
+        };
+
+        struct alignas(64) CacheLine {
+            std::byte bytes[64];
+        };
+
+        explicit PacketCapture(const PacketCaptureOptions& options);
+
+        Record& recordAt(uint64_t position) const noexcept {
+            return *reinterpret_cast<Record*>(reinterpret_cast<std::byte*>(slab_.get()) + (position & mask_) * stride_);
+        }
+
+        void run();
+        void drain();
+        void write(const Record& record);
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> open();
+        void rotate();
+
+        PacketCaptureOptions options_;
+        size_t stride_ = 0;
+        uint64_t capacity_ = 0;
+        uint64_t mask_ = 0;
+        std::unique_ptr<CacheLine[]> slab_;
+        std::atomic<bool> enabled_{true};
+
+        alignas(64) std::atomic<uint64_t> enqueue_{0};
+        alignas(64) std::atomic<uint64_t> dropped_{0};
+
+        // Writer thread.
+        alignas(64) uint64_t dequeue_ = 0;
+        std::atomic<uint64_t> written_{0};
+        std::atomic<uint64_t> files_{0};
+        std::FILE* file_ = nullptr;
+        uint64_t file_bytes_ = 0;
+        std::unique_ptr<uint8_t[]> scratch_; // One record's headers and payload, assembled for fwrite
+
+        std::mutex mutex_;
+        std::condition_variable wake_;    // Stop or flush requested
+        std::condition_variable flushed_; // flushed_to_ moved on
+        bool stopping_ = false;
+        uint64_t flush_target_ = 0; // Positions below this must reach the file before flush() returns
+        uint64_t flushed_to_ = 0;   // Positions below this are written and flushed
+        std::thread writer_;
+    };
+
+} // namespace pulse::net::udp
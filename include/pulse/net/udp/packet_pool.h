@@ -0,0 +1,194 @@
+#pragma once
+
+#include <pulse/net/udp/error_code.h>
+#include <pulse/net/udp/udp_addr.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <utility>
+
+namespace pulse::net::udp {
+
+    class PacketPool;
+    struct PooledReceive;
+
+    struct PacketPoolOptions {
+        // Payload bytes per buffer. Must be at least the socket's maximum datagram size (2048 by default).
+        size_t bufferSize = 2048;
+        size_t bufferCount = 4096;
+        // Back the slab with huge pages where the OS allows it; silently falls back to normal pages.
+        bool hugePages = false;
+    };
+
+    // A reference-counted handle to one buffer in a PacketPool. Copies share the buffer; the buffer goes
+    // back to the pool when the last handle is destroyed, from whichever thread that happens on.
+    class PooledPacket {
+    public:
+        PooledPacket() = default;
+
+        PooledPacket(const PooledPacket& other) noexcept : slot_(other.slot_) {
+            if (slot_) {
+                slot_->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        PooledPacket(PooledPacket&& other) noexcept : slot_(std::exchange(other.slot_, nullptr)) {}
+
+        PooledPacket& operator=(PooledPacket other) noexcept {
+            std::swap(slot_, other.slot_);
+            return *this;
+        }
+
+        ~PooledPacket() {
+            reset();
+        }
+
+        explicit operator bool() const noexcept { return slot_ != nullptr; }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        uint8_t* data() const noexcept { return reinterpret_cast<uint8_t*>(slot_ + 1); }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        size_t size() const noexcept { return slot_->size; }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        size_t capacity() const noexcept;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        const Addr& addr() const noexcept { return slot_->addr; }
+
+        // Kernel receive time in CLOCK_REALTIME nanoseconds, 0 unless the socket has rxTimestamps on.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        int64_t timestampNs() const noexcept { return slot_->timestamp_ns; }
+
+        // For filling a buffer yourself, e.g. to build an outgoing payload.
+        void setSize(size_t size) noexcept { slot_->size = size; }
+        void setAddr(const Addr& addr) noexcept { slot_->addr = addr; }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        uint32_t useCount() const noexcept { return slot_ ? slot_->refs.load(std::memory_order_relaxed) : 0; }
+
+        void reset() noexcept;
+
+    private:
+        friend class PacketPool;
+        friend struct PooledReceive;
+
+        // Sits directly in front of the payload, on its own cache line.
+        struct alignas(64) Slot {
+            std::atomic<uint32_t> refs{0};
+            std::atomic<uint32_t> next_free{0};
+            PacketPool* pool = nullptr;
+            size_t size = 0;
+            Addr addr;
+            int64_t timestamp_ns = 0;
+        };
+        static_assert(sizeof(Slot) == 64, "Packet headers must fit one cache line");
+
+        explicit PooledPacket(Slot* slot) noexcept : slot_(slot) {}
+
+        // Hands the buffer to a raw receive without dropping the reference; Adopt() takes it back.
+        uint8_t* detach() noexcept { return reinterpret_cast<uint8_t*>(std::exchange(slot_, nullptr) + 1); }
+        static PooledPacket Adopt(uint8_t* data) noexcept { return PooledPacket(reinterpret_cast<Slot*>(data) - 1); }
+
+        Slot* slot_ = nullptr;
+    };
+
+    // A fixed set of equally sized, cache-line aligned packet buffers carved out of one slab. acquire() and
+    // release are lock-free and safe from any thread. The pool must outlive every packet it hands out.
+    class PacketPool {
+    public:
+        ~PacketPool();
+
+        PacketPool(const PacketPool&) = delete;
+        PacketPool& operator=(const PacketPool&) = delete;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<PacketPool>, Error> Create(const PacketPoolOptions& options = {});
+
+        // Fails with PoolExhausted when every buffer is in use.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<PooledPacket, Error> acquire() noexcept {
+            uint64_t head = free_head_.load(std::memory_order_acquire);
+            while (true) {
+                const auto index = static_cast<uint32_t>(head);
+                if (index == kNoSlot) {
+                    return make_unexpected(ErrorCode::PoolExhausted);
+                }
+                Slot* slot = slotAt(index);
+                // The tag in the top half makes a stale `next` lose the race instead of corrupting the list.
+                const uint64_t next = ((head >> 32) + 1) << 32 | slot->next_free.load(std::memory_order_relaxed);
+                if (free_head_.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+                    slot->refs.store(1, std::memory_order_relaxed);
+                    slot->size = 0;
+                    slot->timestamp_ns = 0;
+                    available_.fetch_sub(1, std::memory_order_relaxed);
+                    return PooledPacket(slot);
+                }
+            }
+        }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        size_t bufferSize() const noexcept { return buffer_size_; }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        size_t bufferCount() const noexcept { return buffer_count_; }
+
+        // A snapshot; other threads may be acquiring and releasing concurrently.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        size_t available() const noexcept { return available_.load(std::memory_order_relaxed); }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        bool usesHugePages() const noexcept { return huge_pages_; }
+
+    private:
+        friend class PooledPacket;
+        using Slot = PooledPacket::Slot;
+
+        static constexpr uint32_t kNoSlot = UINT32_MAX;
+
+        PacketPool() = default;
+
+        Slot* slotAt(uint32_t index) const noexcept {
+            return reinterpret_cast<Slot*>(slab_ + static_cast<size_t>(index) * stride_);
+        }
+
+        void release(Slot* slot) noexcept {
+            const auto index = static_cast<uint32_t>((reinterpret_cast<uint8_t*>(slot) - slab_) / stride_);
+            uint64_t head = free_head_.load(std::memory_order_relaxed);
+            while (true) {
+                slot->next_free.store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+                const uint64_t next = ((head >> 32) + 1) << 32 | index;
+                if (free_head_.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+            available_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        uint8_t* slab_ = nullptr;
+        size_t slab_size_ = 0;
+        size_t stride_ = 0;
+        size_t buffer_size_ = 0;
+        size_t buffer_count_ = 0;
+        bool huge_pages_ = false;
+
+        alignas(64) std::atomic<uint64_t> free_head_{kNoSlot}; // tag << 32 | index of the first free slot
+        alignas(64) std::atomic<size_t> available_{0};
+    };
+
+    inline size_t PooledPacket::capacity() const noexcept {
+        return slot_->pool->bufferSize();
+    }
+
+    inline void PooledPacket::reset() noexcept {
+        if (slot_ && slot_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            slot_->pool->release(slot_);
+        }
+        slot_ = nullptr;
+    }
+
+} // namespace pulse::net::udp
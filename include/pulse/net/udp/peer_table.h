@@ -0,0 +1,438 @@
+#pragma once
+
+#include "udp_addr.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PULSENET_UDP_PEER_TABLE_SSE2 1
+#endif
+
+namespace pulse::net::udp {
+
+    // Open-addressing map from peer Addr to per-peer session state, built for one lookup per packet.
+    //
+    // The index is a Swiss-table: one control byte per bucket holding 7 bits of the hash, probed 16
+    // buckets at a time (one SSE2 compare where available), so a miss or a hit usually touches a
+    // single cache line of control bytes. Buckets only hold a 32-bit slot number; keys and sessions
+    // live in fixed-size chunks that never move, which is what makes handles and pointers stable
+    // across inserts and rehashes.
+    //
+    // A Handle stays valid until its entry is erased; after that it is detected as stale rather than
+    // aliasing whichever peer reuses the slot. erase(Handle) is O(1) with no probing.
+    //
+    // Not thread-safe. Like the standard containers, growing may throw std::bad_alloc.
+    template <class Session>
+    class PeerTable {
+    public:
+        struct Handle {
+            uint32_t index = std::numeric_limits<uint32_t>::max();
+            uint32_t generation = 0;
+
+            explicit operator bool() const noexcept {
+                return index != std::numeric_limits<uint32_t>::max();
+            }
+            friend bool operator==(const Handle&, const Handle&) = default;
+        };
+
+        PeerTable() = default;
+        explicit PeerTable(size_t expected_peers) {
+            reserve(expected_peers);
+        }
+
+        PeerTable(const PeerTable&) = delete;
+        PeerTable& operator=(const PeerTable&) = delete;
+        // A moved-from table is empty and usable, like a default-constructed one.
+        PeerTable(PeerTable&& other) noexcept
+            : ctrl_(std::exchange(other.ctrl_, nullptr)),
+              buckets_(std::exchange(other.buckets_, nullptr)),
+              capacity_(std::exchange(other.capacity_, 0)),
+              mask_(std::exchange(other.mask_, 0)),
+              growth_left_(std::exchange(other.growth_left_, 0)),
+              size_(std::exchange(other.size_, 0)),
+              chunks_(std::exchange(other.chunks_, {})),
+              slot_count_(std::exchange(other.slot_count_, 0)),
+              free_head_(std::exchange(other.free_head_, kNoSlot)) {}
+
+        PeerTable& operator=(PeerTable&& other) noexcept {
+            if (this != &other) {
+                ctrl_ = std::exchange(other.ctrl_, nullptr);
+                buckets_ = std::exchange(other.buckets_, nullptr);
+                capacity_ = std::exchange(other.capacity_, 0);
+                mask_ = std::exchange(other.mask_, 0);
+                growth_left_ = std::exchange(other.growth_left_, 0);
+                size_ = std::exchange(other.size_, 0);
+                chunks_ = std::exchange(other.chunks_, {});
+                slot_count_ = std::exchange(other.slot_count_, 0);
+                free_head_ = std::exchange(other.free_head_, kNoSlot);
+            }
+            return *this;
+        }
+
+        [[nodiscard("Why ask for the size and then ignore it?")]]
+        size_t size() const noexcept {
+            return size_;
+        }
+
+        [[nodiscard("Why ask and then ignore the answer?")]]
+        bool empty() const noexcept {
+            return size_ == 0;
+        }
+
+        // Returns an invalid Handle when `addr` isn't in the table.
+        [[nodiscard("Why look up a peer and then ignore it?")]]
+        Handle find(const Addr& addr) const noexcept {
+            if (size_ == 0) {
+                return Handle{};
+            }
+            return findHashed(addr, addr.hash());
+        }
+
+        // Finds `addr` or inserts a Session constructed from `args`. The bool is true if it inserted.
+        template <class... Args>
+        std::pair<Handle, bool> tryEmplace(const Addr& addr, Args&&... args) {
+            const size_t hash = addr.hash();
+            if (size_ > 0) {
+                if (Handle existing = findHashed(addr, hash)) {
+                    return {existing, false};
+                }
+            }
+
+            if (growth_left_ == 0) {
+                rehash(nextCapacity());
+            }
+
+            const uint32_t index = allocateSlot();
+            Slot& slot = slotAt(index);
+            try {
+                slot.value.emplace(std::forward<Args>(args)...);
+            } catch (...) {
+                releaseSlot(index);
+                throw;
+            }
+            slot.key = addr;
+
+            const size_t bucket = findInsertBucket(hash);
+            if (ctrl_[bucket] == kEmpty) {
+                --growth_left_;
+            }
+            setCtrl(bucket, h2(hash));
+            buckets_[bucket] = index;
+            slot.bucket = static_cast<uint32_t>(bucket);
+            ++size_;
+
+            return {Handle{index, slot.generation}, true};
+        }
+
+        // tryEmplace() for when only the session matters: finds `addr` or inserts a Session constructed
+        // from `args`, and returns it. The reference stays valid until the entry is erased.
+        template <class... Args>
+        Session& findOrEmplace(const Addr& addr, Args&&... args) {
+            return *get(tryEmplace(addr, std::forward<Args>(args)...).first);
+        }
+
+        // Null for an invalid or stale handle.
+        [[nodiscard("Why look up a session and then ignore it?")]]
+        Session* get(Handle handle) noexcept {
+            Slot* slot = live(handle);
+            return slot ? &*slot->value : nullptr;
+        }
+
+        [[nodiscard("Why look up a session and then ignore it?")]]
+        const Session* get(Handle handle) const noexcept {
+            const Slot* slot = live(handle);
+            return slot ? &*slot->value : nullptr;
+        }
+
+        [[nodiscard("Why look up a session and then ignore it?")]]
+        Session* get(const Addr& addr) noexcept {
+            return get(find(addr));
+        }
+
+        // The peer a handle refers to, or null for an invalid or stale handle.
+        [[nodiscard("Why look up an address and then ignore it?")]]
+        const Addr* addressOf(Handle handle) const noexcept {
+            const Slot* slot = live(handle);
+            return slot ? &slot->key : nullptr;
+        }
+
+        // O(1): the slot knows its bucket, so nothing is probed. Returns false for a stale handle.
+        bool erase(Handle handle) noexcept {
+            Slot* slot = live(handle);
+            if (slot == nullptr) {
+                return false;
+            }
+            setCtrl(slot->bucket, kDeleted);
+            releaseSlot(handle.index);
+            --size_;
+            return true;
+        }
+
+        bool erase(const Addr& addr) noexcept {
+            return erase(find(addr));
+        }
+
+        // Calls `fn(Handle, const Addr&, Session&)` for every peer. `fn` must not insert; it may erase
+        // the entry it is given.
+        template <class Fn>
+        void forEach(Fn&& fn) {
+            for (size_t index = 0; index < slot_count_; ++index) {
+                Slot& slot = slotAt(static_cast<uint32_t>(index));
+                if (slot.value) {
+                    fn(Handle{static_cast<uint32_t>(index), slot.generation}, std::as_const(slot.key), *slot.value);
+                }
+            }
+        }
+
+        void clear() noexcept {
+            for (size_t index = 0; index < slot_count_; ++index) {
+                Slot& slot = slotAt(static_cast<uint32_t>(index));
+                if (slot.value) {
+                    releaseSlot(static_cast<uint32_t>(index));
+                }
+            }
+            if (capacity_ > 0) {
+                std::memset(ctrl_.get(), kEmpty, capacity_ + kGroupWidth - 1);
+                growth_left_ = maxLoad(capacity_);
+            }
+            size_ = 0;
+        }
+
+        // Sizes the index so `peers` entries fit without rehashing.
+        void reserve(size_t peers) {
+            size_t capacity = kGroupWidth;
+            while (maxLoad(capacity) < peers) {
+                capacity *= 2;
+            }
+            if (capacity > capacity_) {
+                rehash(capacity);
+            }
+        }
+
+    private:
+        static constexpr size_t kGroupWidth = 16;
+        static constexpr size_t kChunkShift = 8; // 256 slots per chunk
+        static constexpr size_t kChunkSize = size_t{1} << kChunkShift;
+        static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+
+        // Control bytes: full buckets hold the low 7 hash bits, so only the sentinels have the top bit set.
+        static constexpr uint8_t kEmpty = 0x80;
+        static constexpr uint8_t kDeleted = 0xFE;
+
+        struct Slot {
+            Addr key;
+            uint32_t generation = 0;
+            uint32_t bucket = 0;      // Index bucket while live
+            uint32_t next_free = kNoSlot; // Free-list link while dead
+            std::optional<Session> value;
+        };
+
+        // 16 control bytes starting at any bucket. The table mirrors its first 15 control bytes past
+        // the end, so a group never needs to wrap.
+        class Group {
+        public:
+            explicit Group(const uint8_t* ctrl) noexcept {
+#if defined(PULSENET_UDP_PEER_TABLE_SSE2)
+                ctrl_ = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#else
+                std::memcpy(ctrl_, ctrl, kGroupWidth);
+#endif
+            }
+
+            uint32_t match(uint8_t tag) const noexcept {
+#if defined(PULSENET_UDP_PEER_TABLE_SSE2)
+                return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(tag)), ctrl_)));
+#else
+                uint32_t bits = 0;
+                for (size_t i = 0; i < kGroupWidth; ++i) {
+                    bits |= static_cast<uint32_t>(ctrl_[i] == tag) << i;
+                }
+                return bits;
+#endif
+            }
+
+            uint32_t matchEmpty() const noexcept {
+                return match(kEmpty);
+            }
+
+            // Empty and deleted are the only control bytes with the top bit set.
+            uint32_t matchEmptyOrDeleted() const noexcept {
+#if defined(PULSENET_UDP_PEER_TABLE_SSE2)
+                return static_cast<uint32_t>(_mm_movemask_epi8(ctrl_));
+#else
+                uint32_t bits = 0;
+                for (size_t i = 0; i < kGroupWidth; ++i) {
+                    bits |= static_cast<uint32_t>(ctrl_[i] >> 7) << i;
+                }
+                return bits;
+#endif
+            }
+
+        private:
+#if defined(PULSENET_UDP_PEER_TABLE_SSE2)
+            __m128i ctrl_;
+#else
+            uint8_t ctrl_[kGroupWidth];
+#endif
+        };
+
+        // Triangular probing over groups; visits every group once when the capacity is a power of two.
+        class Probe {
+        public:
+            Probe(size_t hash, size_t mask) noexcept : mask_(mask), offset_(hash & mask) {}
+
+            size_t offset() const noexcept {
+                return offset_;
+            }
+
+            void next() noexcept {
+                index_ += kGroupWidth;
+                offset_ = (offset_ + index_) & mask_;
+            }
+
+        private:
+            size_t mask_;
+            size_t offset_;
+            size_t index_ = 0;
+        };
+
+        static size_t h1(size_t hash) noexcept {
+            return hash >> 7;
+        }
+
+        static uint8_t h2(size_t hash) noexcept {
+            return static_cast<uint8_t>(hash & 0x7F);
+        }
+
+        static size_t maxLoad(size_t capacity) noexcept {
+            return capacity - capacity / 8;
+        }
+
+        Slot& slotAt(uint32_t index) noexcept {
+            return chunks_[index >> kChunkShift][index & (kChunkSize - 1)];
+        }
+
+        const Slot& slotAt(uint32_t index) const noexcept {
+            return chunks_[index >> kChunkShift][index & (kChunkSize - 1)];
+        }
+
+        Slot* live(Handle handle) noexcept {
+            return const_cast<Slot*>(std::as_const(*this).live(handle));
+        }
+
+        const Slot* live(Handle handle) const noexcept {
+            if (handle.index >= slot_count_) {
+                return nullptr;
+            }
+            const Slot& slot = slotAt(handle.index);
+            return (slot.value && slot.generation == handle.generation) ? &slot : nullptr;
+        }
+
+        Handle findHashed(const Addr& addr, size_t hash) const noexcept {
+            const uint8_t tag = h2(hash);
+            for (Probe probe(h1(hash), mask_); ; probe.next()) {
+                const Group group(&ctrl_[probe.offset()]);
+                for (uint32_t bits = group.match(tag); bits != 0; bits &= bits - 1) {
+                    const uint32_t index = buckets_[(probe.offset() + std::countr_zero(bits)) & mask_];
+                    const Slot& slot = slotAt(index);
+                    if (slot.key == addr) {
+                        return Handle{index, slot.generation};
+                    }
+                }
+                if (group.matchEmpty() != 0) {
+                    return Handle{};
+                }
+            }
+        }
+
+        size_t findInsertBucket(size_t hash) const noexcept {
+            for (Probe probe(h1(hash), mask_); ; probe.next()) {
+                const Group group(&ctrl_[probe.offset()]);
+                if (uint32_t bits = group.matchEmptyOrDeleted(); bits != 0) {
+                    return (probe.offset() + std::countr_zero(bits)) & mask_;
+                }
+            }
+        }
+
+        void setCtrl(size_t bucket, uint8_t value) noexcept {
+            ctrl_[bucket] = value;
+            if (bucket < kGroupWidth - 1) {
+                ctrl_[capacity_ + bucket] = value;
+            }
+        }
+
+        uint32_t allocateSlot() {
+            if (free_head_ != kNoSlot) {
+                const uint32_t index = free_head_;
+                free_head_ = slotAt(index).next_free;
+                return index;
+            }
+            if (slot_count_ == chunks_.size() * kChunkSize) {
+                chunks_.push_back(std::make_unique<Slot[]>(kChunkSize));
+            }
+            return static_cast<uint32_t>(slot_count_++);
+        }
+
+        void releaseSlot(uint32_t index) noexcept {
+            Slot& slot = slotAt(index);
+            slot.value.reset();
+            ++slot.generation;
+            slot.next_free = free_head_;
+            free_head_ = index;
+        }
+
+        // Doubles when genuinely full; when tombstones are what ran the budget out, rebuilds in place.
+        size_t nextCapacity() const noexcept {
+            if (capacity_ == 0) {
+                return kGroupWidth;
+            }
+            return (size_ * 2 < maxLoad(capacity_)) ? capacity_ : capacity_ * 2;
+        }
+
+        void rehash(size_t capacity) {
+            auto ctrl = std::make_unique<uint8_t[]>(capacity + kGroupWidth - 1);
+            auto buckets = std::make_unique<uint32_t[]>(capacity);
+            std::memset(ctrl.get(), kEmpty, capacity + kGroupWidth - 1);
+
+            ctrl_ = std::move(ctrl);
+            buckets_ = std::move(buckets);
+            capacity_ = capacity;
+            mask_ = capacity - 1;
+            growth_left_ = maxLoad(capacity) - size_;
+
+            // Sessions stay where they are; only the index is rebuilt.
+            for (size_t index = 0; index < slot_count_; ++index) {
+                Slot& slot = slotAt(static_cast<uint32_t>(index));
+                if (!slot.value) {
+                    continue;
+                }
+                const size_t hash = slot.key.hash();
+                const size_t bucket = findInsertBucket(hash);
+                setCtrl(bucket, h2(hash));
+                buckets_[bucket] = static_cast<uint32_t>(index);
+                slot.bucket = static_cast<uint32_t>(bucket);
+            }
+        }
+
+        std::unique_ptr<uint8_t[]> ctrl_;
+        std::unique_ptr<uint32_t[]> buckets_;
+        size_t capacity_ = 0;
+        size_t mask_ = 0;
+        size_t growth_left_ = 0;
+        size_t size_ = 0;
+
+        std::vector<std::unique_ptr<Slot[]>> chunks_;
+        size_t slot_count_ = 0; // Slots ever handed out; all live slots are below this
+        uint32_t free_head_ = kNoSlot;
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "udp.h"
+#include "error_code.h"
+#include <memory>
+#include <expected>
+#include <functional>
+
+namespace pulse::net::udp {
+
+    // Waits on many ISockets from one thread. Sockets are registered by their getReadHandle() descriptor;
+    // when one becomes readable the reactor drains it until WouldBlock and hands every datagram to
+    // the socket's handler. Nothing spins while idle: poll() sleeps in the kernel until traffic or
+    // wake() arrives.
+    //
+    // Everything except wake() must be called from the thread that runs poll(). A socket must be
+    // removed before it is closed or destroyed.
+    class Reactor {
+    public:
+        // `packet` is the zero-copy view from ISocket::recvFrom() and is only valid during the call.
+        using PacketHandler = std::function<void(ISocket& socket, const ReceivedPacket& packet)>;
+
+        virtual ~Reactor() = default;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<void, Error> add(ISocket& socket, PacketHandler handler) = 0;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<void, Error> remove(ISocket& socket) = 0;
+
+        // Waits up to `timeoutMs` (-1 waits forever, 0 never blocks) and dispatches whatever is ready.
+        // Returns the number of datagrams handed to handlers. A busy socket is drained in slices so
+        // it cannot starve the others; leftovers are picked up by the next poll() without waiting.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<size_t, Error> poll(int timeoutMs) = 0;
+
+        // Makes a blocked poll() return early. Safe to call from any thread.
+        virtual void wake() = 0;
+    };
+
+    // Edge-triggered epoll on Linux. Returns Unsupported elsewhere.
+    [[nodiscard("Don't ask for a reactor and then ignore it.")]]
+    std::expected<std::unique_ptr<Reactor>, Error> create_reactor();
+
+} // namespace pulse::net::udp
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace pulse::net::udp {
+
+    // Bounded lock-free queue for exactly one producer thread and one consumer thread. The producer and
+    // consumer indices sit on their own cache lines, and each side keeps a cached copy of the other's
+    // index, so in steady state a push or pop touches no line the other thread is writing.
+    //
+    // Capacity is rounded up to a power of two. T must be default constructible and move assignable;
+    // slots hold moved-from values between uses. Like the standard containers, construction may throw
+    // std::bad_alloc.
+    template <class T>
+    class SpscRing {
+    public:
+        explicit SpscRing(size_t capacity)
+            : capacity_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)),
+              mask_(capacity_ - 1),
+              slots_(std::make_unique<T[]>(capacity_)) {}
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        // Producer only. Leaves `value` untouched and returns false when the ring is full.
+        [[nodiscard("A full ring didn't take the value; handle it.")]]
+        bool tryPush(T&& value) noexcept(std::is_nothrow_move_assignable_v<T>) {
+            const size_t tail = producer_.index.load(std::memory_order_relaxed);
+            if (tail - producer_.cached_other == capacity_) {
+                producer_.cached_other = consumer_.index.load(std::memory_order_acquire);
+                if (tail - producer_.cached_other == capacity_) {
+                    return false;
+                }
+            }
+            slots_[tail & mask_] = std::move(value);
+            producer_.index.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer only.
+        [[nodiscard("Why pop a value and then ignore it?")]]
+        std::optional<T> tryPop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            const size_t head = consumer_.index.load(std::memory_order_relaxed);
+            if (head == consumer_.cached_other) {
+                consumer_.cached_other = producer_.index.load(std::memory_order_acquire);
+                if (head == consumer_.cached_other) {
+                    return std::nullopt;
+                }
+            }
+            std::optional<T> value(std::move(slots_[head & mask_]));
+            consumer_.index.store(head + 1, std::memory_order_release);
+            return value;
+        }
+
+        // A snapshot from either side; the other thread may change it immediately.
+        [[nodiscard("Why ask for the size and then ignore it?")]]
+        size_t size() const noexcept {
+            const size_t head = consumer_.index.load(std::memory_order_acquire);
+            const size_t tail = producer_.index.load(std::memory_order_acquire);
+            return tail - head;
+        }
+
+        [[nodiscard("Why ask for the capacity and then ignore it?")]]
+        size_t capacity() const noexcept {
+            return capacity_;
+        }
+
+    private:
+        struct alignas(64) Side {
+            std::atomic<size_t> index{0};
+            size_t cached_other = 0; // Last index seen from the other side
+        };
+
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<T[]> slots_;
+        Side producer_;
+        Side consumer_;
+    };
+
+    // Bounded lock-free queue for any number of producers and consumers (Vyukov's array queue). Each slot
+    // carries a sequence number that says whose turn it is, so producers and consumers only contend on
+    // their own index with a single compare-exchange and never wait on one another unless the ring is
+    // full or empty.
+    //
+    // Capacity is rounded up to a power of two. Same requirements on T as SpscRing.
+    template <class T>
+    class MpmcRing {
+    public:
+        explicit MpmcRing(size_t capacity)
+            : capacity_(std::bit_ceil(capacity < 2 ? size_t{2} : capacity)),
+              mask_(capacity_ - 1),
+              cells_(std::make_unique<Cell[]>(capacity_)) {
+            for (size_t i = 0; i < capacity_; ++i) {
+                cells_[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpmcRing(const MpmcRing&) = delete;
+        MpmcRing& operator=(const MpmcRing&) = delete;
+
+        // Leaves `value` untouched and returns false when the ring is full.
+        [[nodiscard("A full ring didn't take the value; handle it.")]]
+        bool tryPush(T&& value) noexcept(std::is_nothrow_move_assignable_v<T>) {
+            size_t position = enqueue_.load(std::memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells_[position & mask_];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+                if (lag == 0) {
+                    if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (lag < 0) {
+                    return false; // The consumer a lap behind hasn't emptied this cell yet.
+                } else {
+                    position = enqueue_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        [[nodiscard("Why pop a value and then ignore it?")]]
+        std::optional<T> tryPop() noexcept(std::is_nothrow_move_constructible_v<T>) {
+            size_t position = dequeue_.load(std::memory_order_relaxed);
+            while (true) {
+                Cell& cell = cells_[position & mask_];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto lag = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+                if (lag == 0) {
+                    if (dequeue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        std::optional<T> value(std::move(cell.value));
+                        cell.sequence.store(position + capacity_, std::memory_order_release);
+                        return value;
+                    }
+                } else if (lag < 0) {
+                    return std::nullopt;
+                } else {
+                    position = dequeue_.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // A snapshot; producers and consumers may change it immediately.
+        [[nodiscard("Why ask for the size and then ignore it?")]]
+        size_t size() const noexcept {
+            const size_t head = dequeue_.load(std::memory_order_acquire);
+            const size_t tail = enqueue_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+
+        [[nodiscard("Why ask for the capacity and then ignore it?")]]
+        size_t capacity() const noexcept {
+            return capacity_;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence{0};
+            T value{};
+        };
+
+        const size_t capacity_;
+        const size_t mask_;
+        std::unique_ptr<Cell[]> cells_;
+        alignas(64) std::atomic<size_t> enqueue_{0};
+        alignas(64) std::atomic<size_t> dequeue_{0};
+    };
+
+} // namespace pulse::net::udp
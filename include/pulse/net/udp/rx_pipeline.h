@@ -0,0 +1,128 @@
+#pragma once
+
+#include "udp.h"
+#include "packet_pool.h"
+#include "ring.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    enum class DispatchPolicy {
+        PeerHash,   // Each peer's datagrams always go to the same worker, in order (one SPSC ring per worker)
+        RoundRobin, // Datagrams are dealt to workers in turn (one SPSC ring per worker)
+        Shared,     // One MPMC ring every worker pops from; the least busy worker takes the next datagram
+    };
+
+    enum class OverflowPolicy {
+        Drop,  // A datagram for a full ring goes straight back to the pool and is counted as dropped
+        Stall, // pump() holds on to it and stops reading until there's room; the kernel buffer absorbs the rest
+    };
+
+    struct RxPipelineOptions {
+        size_t workers = 1;
+        size_t queueCapacity = 1024; // Per ring, rounded up to a power of two
+        DispatchPolicy dispatch = DispatchPolicy::PeerHash;
+        OverflowPolicy overflow = OverflowPolicy::Drop;
+        size_t batchSize = 32;       // Datagrams read per pump(), at most 64
+    };
+
+    struct RxPipelineStats {
+        uint64_t received = 0;      // Read off the socket
+        uint64_t dispatched = 0;    // Handed to a worker's ring
+        uint64_t dropped = 0;       // Thrown away because the ring was full (OverflowPolicy::Drop)
+        uint64_t stalls = 0;        // pump() calls that didn't read because a ring was full (OverflowPolicy::Stall)
+        uint64_t poolExhausted = 0; // pump() calls that couldn't read because workers held every buffer
+    };
+
+    // Per-ring view of the same numbers. With DispatchPolicy::Shared every worker reports the one ring.
+    struct RxQueueStats {
+        uint64_t dispatched = 0;
+        uint64_t dropped = 0;
+        size_t depth = 0; // Datagrams waiting right now
+    };
+
+    // The hand-off between a thread that reads a socket and a pool of workers that handle what it reads.
+    // The I/O thread calls pump(), which receives a batch straight into PacketPool buffers and pushes each
+    // datagram onto a bounded lock-free ring chosen by the dispatch policy; worker `i` calls pop(i). Only
+    // handles move through the rings, never payloads, and nothing on either side takes a lock.
+    //
+    // pump() must only ever be called from one thread at a time, and pop(i) likewise for each i (any
+    // thread may pop under DispatchPolicy::Shared). The socket and pool must outlive the pipeline.
+    class RxPipeline {
+    public:
+        RxPipeline(const RxPipeline&) = delete;
+        RxPipeline& operator=(const RxPipeline&) = delete;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<RxPipeline>, Error> Create(ISocket& socket, PacketPool& pool, const RxPipelineOptions& options = {});
+
+        // Reads one batch and dispatches it. Returns how many datagrams reached a worker's ring, which
+        // can be 0 while stalled. Socket errors come back as they are: WouldBlock when there's nothing to
+        // read, PoolExhausted when workers are holding every buffer.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> pump();
+
+        // Worker side. Empty when nothing is waiting for `worker`.
+        [[nodiscard("Why pop a packet and then ignore it?")]]
+        std::optional<PooledPacket> pop(size_t worker) noexcept;
+
+        // Pops up to `packets.size()` datagrams for `worker`; returns how many.
+        size_t popBatch(size_t worker, std::span<PooledPacket> packets) noexcept;
+
+        [[nodiscard("Why ask and then ignore the answer?")]]
+        size_t workers() const noexcept { return workers_; }
+
+        // Snapshots; safe from any thread.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        RxPipelineStats stats() const noexcept;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        RxQueueStats queueStats(size_t worker) const noexcept;
+
+    private:
+        struct Queue {
+            explicit Queue(size_t capacity, bool shared);
+
+            std::unique_ptr<SpscRing<PooledPacket>> spsc;
+            std::unique_ptr<MpmcRing<PooledPacket>> mpmc;
+            std::atomic<uint64_t> dispatched{0};
+            std::atomic<uint64_t> dropped{0};
+        };
+
+        RxPipeline(ISocket& socket, PacketPool& pool, const RxPipelineOptions& options);
+
+        size_t route(const PooledPacket& packet) noexcept;
+        bool push(Queue& queue, PooledPacket& packet) noexcept;
+        // Retries datagrams held back by a full ring, oldest first. Returns how many went out.
+        size_t flushPending() noexcept;
+
+        Queue& queueFor(size_t worker) noexcept { return *queues_[queues_.size() == 1 ? 0 : worker]; }
+        const Queue& queueFor(size_t worker) const noexcept { return *queues_[queues_.size() == 1 ? 0 : worker]; }
+
+        ISocket& socket_;
+        PacketPool& pool_;
+        size_t workers_;
+        DispatchPolicy dispatch_;
+        OverflowPolicy overflow_;
+        size_t next_worker_ = 0;
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<PooledPacket> batch_;
+        std::vector<PooledPacket> pending_; // Stall only: read but not yet dispatched, in arrival order
+        std::vector<size_t> pending_workers_;
+        std::vector<bool> blocked_;
+
+        std::atomic<uint64_t> received_{0};
+        std::atomic<uint64_t> stalls_{0};
+        std::atomic<uint64_t> pool_exhausted_{0};
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "udp.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    // Backends for Socket<Backend>.
+    struct NativeBackend {};  // The platform's own sockets, what get_socket_factory() hands out by default
+    struct IoUringBackend {}; // io_uring (Linux 6.0+); Listen/Dial return Unsupported when it isn't built in
+
+    // A socket whose backend is fixed at compile time. It has the same operations as ISocket, with the same
+    // semantics, but none of them is virtual. Each call goes straight to the backend's implementation, so a
+    // per-packet loop pays a direct call instead of a vtable load and an indirect branch, and with LTO
+    // (-DCMAKE_INTERPROCEDURAL_OPTIMIZATION=ON) the compiler can inline through it.
+    //
+    // ISocket is the type-erased form of the same object: erased() lends it out to code that takes an
+    // ISocket&, and release() gives up the static type for good. Moving is cheap; a moved-from Socket is
+    // empty, and any call on it is undefined.
+    template <class Backend>
+    class Socket {
+    public:
+        Socket(Socket&&) noexcept = default;
+        Socket& operator=(Socket&&) noexcept = default;
+        ~Socket() = default;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<Socket, Error> Listen(const Addr& bindAddr, const SocketOptions& options = {});
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::vector<Socket>, Error> ListenSharded(const Addr& bindAddr, size_t shards, const SocketOptions& options = {});
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<Socket, Error> Dial(const Addr& remoteAddr, const SocketOptions& options = {});
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> sendTo(const Addr& addr, const uint8_t* data, size_t length);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> send(const uint8_t* data, size_t length);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendBatch(std::span<OutgoingPacket> packets);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segmentSize);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFrom();
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFrom(ReceivedPacket&& packet);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatch(std::span<ReceivedPacket> packets);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<PooledPacket, Error> recvPooled(PacketPool& pool) {
+            return PooledReceive::one(*this, pool);
+        }
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatchPooled(PacketPool& pool, std::span<PooledPacket> packets) {
+            return PooledReceive::batch(*this, pool, packets);
+        }
+
+        // The spin budget is the backend's, so waits through either form teach the same one.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFromUntil(std::chrono::steady_clock::time_point deadline) {
+            return DeadlineReceive::until(*this, impl_->spinBudget(), deadline, [&] { return recvFrom(); });
+        }
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFromUntil(ReceivedPacket&& packet, std::chrono::steady_clock::time_point deadline) {
+            return DeadlineReceive::until(*this, impl_->spinBudget(), deadline, [&] { return recvFrom(ReceivedPacket(packet)); });
+        }
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatchUntil(std::span<ReceivedPacket> packets, std::chrono::steady_clock::time_point deadline) {
+            return DeadlineReceive::until(*this, impl_->spinBudget(), deadline, [&] { return recvBatch(packets); });
+        }
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> readTxTimestamps(std::span<TxTimestamp> timestamps);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<SocketMetrics, Error> metrics() const;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> setPacingRate(const Addr& addr, uint64_t bytesPerSecond);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int64_t, Error> flushPaced();
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int, Error> getHandle() const;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int, Error> getReadHandle() const;
+
+        void close();
+
+        // The same socket behind the virtual interface, for reactors, pipelines and anything else that
+        // takes ISocket&. Valid as long as this Socket is.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        ISocket& erased() noexcept { return *impl_; }
+
+        // Hands the socket over to type-erased ownership; this Socket is empty afterwards.
+        [[nodiscard("Dropping the released socket closes it.")]]
+        std::unique_ptr<ISocket> release() && noexcept { return std::move(impl_); }
+
+    private:
+        explicit Socket(std::unique_ptr<ISocket> impl) noexcept : impl_(std::move(impl)) {}
+
+        // The backend's final class, through which every call above is direct.
+        auto& impl() const noexcept;
+
+        std::unique_ptr<ISocket> impl_;
+    };
+
+    using NativeSocket = Socket<NativeBackend>;
+    using IoUringSocket = Socket<IoUringBackend>;
+
+    // Instantiated once, inside the library, where the backends' classes are visible.
+    extern template class Socket<NativeBackend>;
+    extern template class Socket<IoUringBackend>;
+
+} // namespace pulse::net::udp
@@ -2,7 +2,10 @@
 
 #include "udp_addr.h"
 #include "error_code.h"
+#include "socket_options.h"
+#include <cstdint>
 #include <memory>
+#include <vector>
 #include <expected>
 
 namespace pulse::net::udp {
@@ -17,6 +20,38 @@ namespace pulse::net::udp {
 
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         virtual std::expected<std::unique_ptr<ISocket>, Error> dial(const Addr& remoteAddr) = 0;
+
+        // listen() and dial() with per-socket settings, applied before bind/connect; see SocketOptions.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<std::unique_ptr<ISocket>, Error> listen(const Addr& bindAddr, const SocketOptions& options) {
+            return listenWithOptions(bindAddr, options);
+        }
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<std::unique_ptr<ISocket>, Error> dial(const Addr& remoteAddr, const SocketOptions& options) {
+            return dialWithOptions(remoteAddr, options);
+        }
+
+        // What the option-taking listen() and dial() call. Factories that don't override them would have
+        // to ignore the options, so they return Unsupported instead.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<std::unique_ptr<ISocket>, Error> listenWithOptions(const Addr& /*bindAddr*/, const SocketOptions& /*options*/) {
+            return make_unexpected(ErrorCode::Unsupported, "SocketOptions");
+        }
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<std::unique_ptr<ISocket>, Error> dialWithOptions(const Addr& /*remoteAddr*/, const SocketOptions& /*options*/) {
+            return make_unexpected(ErrorCode::Unsupported, "SocketOptions");
+        }
+
+        // Binds `shards` sockets to the same address with SO_REUSEPORT. The kernel hashes each flow
+        // to one of them, so a given peer always lands on the same socket; give each its own worker
+        // thread (pinned, ideally) to spread ingress across cores. Port 0 picks one ephemeral port for
+        // the whole group. Linux only; Unsupported elsewhere, and from factories that don't override it.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<std::vector<std::unique_ptr<ISocket>>, Error> listenSharded(const Addr& /*bindAddr*/, size_t /*shards*/, const SocketOptions& /*options*/ = {}) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
     };
 
     // Free function for user convenience
@@ -25,4 +60,34 @@ namespace pulse::net::udp {
     void set_socket_factory(ISocketFactory * factory);
     void reset_socket_factory(); // Resets to default factory (if any)
 
+    // io_uring backend (Linux 6.0+). Pass it to set_socket_factory() to make it the default.
+    // Returns Unsupported when the library was built without it or the running kernel lacks it.
+    [[nodiscard("Don't ask for a socket factory and then ignore it.")]]
+    std::expected<ISocketFactory *, Error> get_io_uring_socket_factory();
+
+    enum class XdpMode {
+        Auto,    // Native zero-copy if the driver has it, then native copy mode, then Generic
+        Native,  // The driver's own XDP hook; zero-copy where supported, copy mode otherwise
+        Generic, // SKB mode: works on any interface (veth included), at roughly kernel-socket speed
+    };
+
+    struct XdpOptions {
+        XdpMode mode = XdpMode::Auto;
+        // Entries in each AF_XDP ring, a power of two. Each socket gets twice this many 4 KiB frames of
+        // UMEM: one ring's worth for receiving and one for sending.
+        uint32_t ringSize = 2048;
+    };
+
+    // AF_XDP backend (Linux 5.9+, CAP_NET_ADMIN and CAP_BPF or root). Frames for the socket's address
+    // and port skip the kernel stack: an XDP program on the interface redirects them into shared
+    // memory, and Ethernet, IPv4 and UDP are parsed and built in user space. listen() needs the
+    // interface's own IPv4 address rather than 0.0.0.0. listenSharded(addr, n) opens one socket per
+    // receive queue 0..n-1. Only one listen, dial or sharded group per interface at a time, since it
+    // owns the interface's XDP hook; the kernel frees a closed socket's queue asynchronously, so an
+    // immediate re-listen can briefly fail with BindFailed (EBUSY). Sends need the next hop in the neighbour table or a datagram
+    // received from it first; a destination whose next hop isn't there is looked up again at most
+    // every 100 ms. Returns Unsupported when the library was built without it.
+    [[nodiscard("Don't ask for a socket factory and then ignore it.")]]
+    std::expected<std::unique_ptr<ISocketFactory>, Error> create_xdp_socket_factory(const XdpOptions& options = {});
+
 } // namespace pulse::net::udp
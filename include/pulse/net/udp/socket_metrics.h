@@ -0,0 +1,44 @@
+#pragma once
+
+#include "error_code.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace pulse::net::udp {
+
+    // One slot per ErrorCode from InvalidAddress through Truncated, plus a last one for Unknown.
+    // Keep in step with ErrorCode.
+    inline constexpr size_t kErrorCodeSlots = static_cast<size_t>(ErrorCode::Truncated) + 1;
+
+    inline constexpr size_t error_slot(ErrorCode code) noexcept {
+        const auto value = static_cast<size_t>(code);
+        return value >= 1 && value < kErrorCodeSlots ? value - 1 : kErrorCodeSlots - 1;
+    }
+
+    // What one socket has done since it was created, as returned by ISocket::metrics() for sockets
+    // created with SocketOptions::metrics. Counters only ever grow; diff two snapshots to get rates.
+    struct SocketMetrics {
+        uint64_t packetsReceived = 0;
+        uint64_t bytesReceived = 0;
+        uint64_t packetsSent = 0;
+        uint64_t bytesSent = 0;
+
+        uint64_t recvWouldBlock = 0; // Receives that found nothing queued
+        uint64_t sendWouldBlock = 0; // Sends that found the socket buffer full
+        uint64_t partialSends = 0;
+
+        // Datagrams the kernel dropped because the receive queue was full (SO_RXQ_OVFL, Linux only). The
+        // kernel reports the total along with the next datagram it does deliver, so this lags until then.
+        uint64_t kernelDrops = 0;
+
+        // Every other failed receive or send, by ErrorCode; a batch counts each failed datagram.
+        std::array<uint64_t, kErrorCodeSlots> errors{};
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        uint64_t errorCount(ErrorCode code) const noexcept {
+            return errors[error_slot(code)];
+        }
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace pulse::net::udp {
+
+    class PacketCapture;
+
+    // Largest payload a UDP datagram can carry over IPv4.
+    inline constexpr size_t kMaxDatagramSize = 65507;
+
+    enum class PacingMode {
+        Auto,      // Kernel where the egress interface has fq or etf (Linux), otherwise Userspace
+        Kernel,    // SO_TXTIME departure times plus SO_MAX_PACING_RATE (Linux); Unsupported if refused
+        Userspace, // Early datagrams wait in the socket; release them with ISocket::flushPaced()
+    };
+
+    // Per-socket settings, fixed when the socket is created by listen() or dial(). Unset options keep the
+    // system default. Each one that is set is applied before bind/connect; the first the OS refuses fails
+    // the whole call with SocketConfigFailed (or Unsupported), the option's name in `Error::detail` and
+    // the OS error in `Error::native`.
+    struct SocketOptions {
+        // Largest datagram the socket receives, 1 to kMaxDatagramSize. Every receive buffer handed to the
+        // socket must be at least this big. Longer datagrams are consumed and reported as Truncated.
+        size_t maxDatagramSize = 2048;
+
+        // SO_RCVBUF / SO_SNDBUF in bytes. Linux doubles the value and caps it at net.core.rmem_max/wmem_max.
+        std::optional<int> receiveBufferSize{};
+        std::optional<int> sendBufferSize{};
+
+        // SO_BUSY_POLL: microseconds to spin on the device queue in a blocking receive (Linux). Raising
+        // it above net.core.busy_read needs CAP_NET_ADMIN.
+        std::optional<int> busyPollMicros{};
+        // SO_PREFER_BUSY_POLL: prefer busy polling over softirq processing (Linux 5.11+).
+        bool preferBusyPoll = false;
+
+        // SO_PRIORITY: queueing priority for outgoing packets (Linux). 0-6 without CAP_NET_ADMIN.
+        std::optional<int> priority{};
+        // IP_TOS, or IPV6_TCLASS on IPv6 sockets. DSCP lives in the top six bits: tos = dscp << 2.
+        std::optional<uint8_t> tos{};
+        // SO_INCOMING_CPU: the CPU whose receive queue this socket prefers in a SO_REUSEPORT group (Linux).
+        std::optional<int> incomingCpu{};
+
+        // SO_TIMESTAMPING (Linux). rxTimestamps stamps every datagram as the kernel receives it and reports
+        // the time in ReceivedPacket::timestampNs. txTimestamps stamps every datagram as it leaves for the
+        // device; read the stamps back with ISocket::readTxTimestamps(). Software stamps, CLOCK_REALTIME.
+        bool rxTimestamps = false;
+        bool txTimestamps = false;
+
+        // Keep per-socket packet, byte and error counters, read with ISocket::metrics(). On Linux this also
+        // turns on SO_RXQ_OVFL so datagrams the kernel dropped on a full receive queue are counted.
+        bool metrics = false;
+
+        // UDP_GRO on listening sockets (Linux 5.0+; ignored where the kernel refuses it). The kernel hands
+        // over runs of datagrams from one sender in a single read, which the socket splits again, so a flood
+        // of small datagrams costs far fewer syscalls. The reads land in a 1 MiB arena per socket: recvFrom()
+        // returns views into it, but receives into your own buffers (including pooled ones) copy out of it.
+        bool receiveCoalescing = false;
+
+        // Paced sending, so a tick's worth of datagrams is spread out instead of leaving in one burst.
+        // pacingRate is the socket's budget in payload bytes per second; 0 sets no socket-wide cap and
+        // leaves only the per-destination limits from ISocket::setPacingRate(). Unset turns pacing off.
+        // Kernel pacing stamps every datagram with its departure time and hands it over at once; the
+        // egress interface needs the fq qdisc (or etf) to honour the stamps, so Auto only picks it when
+        // it can see one there, which a socket bound to a wildcard address never can. Userspace pacing
+        // keeps early datagrams in a queue of up to pacingQueueSize and sends them from flushPaced() and
+        // later sends; the queue is allocated up front and may hold at most 256 MiB of maxDatagramSize
+        // slots. Either way sends never block: a full queue is WouldBlock. Default backend only.
+        std::optional<uint64_t> pacingRate{};
+        PacingMode pacingMode = PacingMode::Auto;
+        size_t pacingQueueSize = 1024;
+
+        // Copy the datagrams this socket sends and receives into a capture file; see
+        // <pulse/net/udp/packet_capture.h>. Null, the default, costs nothing beyond a pointer check.
+        std::shared_ptr<PacketCapture> capture{};
+
+        // SO_REUSEADDR / SO_REUSEPORT. listenSharded() always sets reusePort.
+        bool reuseAddress = false;
+        bool reusePort = false;
+    };
+
+} // namespace pulse::net::udp
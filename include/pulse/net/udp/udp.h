@@ -3,12 +3,17 @@
 #include "udp_addr.h"
 #include "error_code.h"
 #include "socket_factory.h"
+#include "packet_pool.h"
+#include "socket_metrics.h"
 #include <vector>
 #include <memory>
 #include <cstdint>
 #include <optional>
 #include <utility>
 #include <expected>
+#include <span>
+#include <algorithm>
+#include <chrono>
 
 namespace pulse::net::udp {
 
@@ -17,6 +22,42 @@ namespace pulse::net::udp {
         size_t size; // Size of the received data
         size_t capacity; // Size of the allocated buffer
         Addr addr;
+        int64_t timestampNs = 0; // Kernel receive time (CLOCK_REALTIME) with SocketOptions::rxTimestamps, else 0
+    };
+
+    struct OutgoingPacket {
+        const uint8_t* data;
+        size_t size; // Size of the payload to send
+        Addr addr;
+        std::expected<void, Error> result; // Outcome of this packet, filled in by sendBatch()
+    };
+
+    // When a sent datagram left the host, as reported by the kernel with SocketOptions::txTimestamps.
+    struct TxTimestamp {
+        uint32_t id; // Counts send calls from 0 after the socket is created; a segmented send counts once per kernel call
+        int64_t timestampNs; // CLOCK_REALTIME
+    };
+
+    // How long a receive with a deadline spins on the socket before parking, learned from how long
+    // datagrams have recently taken to turn up. A busy socket spins for about twice the usual gap, so
+    // the next datagram is caught without a wakeup; a quiet one parks straight away.
+    class SpinBudget {
+    public:
+        static constexpr int64_t kMaxSpinNs = 50'000;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        std::chrono::nanoseconds spin() const noexcept { return std::chrono::nanoseconds(spin_ns_); }
+
+        // `waitedNs` is how long the last wait took until a datagram came, or until it gave up. Waits far
+        // longer than any spin all count the same, so one long silence is forgotten after a few datagrams.
+        void record(int64_t waitedNs) noexcept {
+            average_ns_ += (std::min(waitedNs, 4 * kMaxSpinNs) - average_ns_) / 8;
+            spin_ns_ = 2 * average_ns_ <= kMaxSpinNs ? 2 * average_ns_ : 0;
+        }
+
+    private:
+        int64_t average_ns_ = kMaxSpinNs / 4;
+        int64_t spin_ns_ = kMaxSpinNs / 2;
     };
 
     class ISocket {
@@ -31,20 +72,312 @@ namespace pulse::net::udp {
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         virtual std::expected<void, Error> send(const uint8_t* data, size_t length) = 0;
 
-        /// Receives a packet. The returned `data` pointer is valid only until the next recvFrom() call on the same thread.
+        /// Sends each packet to its own `addr` in as few system calls as the platform allows and records
+        /// the outcome in that packet's `result`. Sending stops at the first WouldBlock, which is recorded
+        /// on that packet and on every packet after it. Returns the number of packets sent; fails as a
+        /// whole only when the socket itself is unusable. The default calls sendTo() per packet and stops
+        /// at the first error of any kind, recording it on the rest; if nothing was sent by then and the
+        /// error isn't WouldBlock, it fails as a whole.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<size_t, Error> sendBatch(std::span<OutgoingPacket> packets);
+
+        /// Sends `length` bytes to `addr` as consecutive datagrams of `segmentSize` bytes; the last one may
+        /// be shorter. Where the kernel supports UDP segmentation offload the buffer crosses the stack once
+        /// per 64 segments, otherwise it falls back to a batched send. Returns the number of datagrams sent
+        /// from the start of the buffer, which is less than requested if the socket buffer filled up or a
+        /// send failed part way through; the error then comes from the next call. Segments bigger than the
+        /// path allows are InvalidArgument. The default makes one sendTo() call per segment.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<size_t, Error> sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segmentSize);
+
+        /// Receives a packet. The returned `data` pointer is valid only until the next receive call on the same socket.
+        /// Datagrams longer than the socket's maxDatagramSize are consumed and reported as Truncated.
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         virtual std::expected<ReceivedPacket, Error> recvFrom() = 0;
 
-        /// Receives a packet from a connected address using a given buffer.
+        /// Receives a packet from a connected address using a given buffer, which must hold maxDatagramSize bytes.
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         virtual std::expected<ReceivedPacket, Error> recvFrom(ReceivedPacket&& packet) = 0;
 
+        /// Receives up to `packets.size()` datagrams in as few system calls as the platform allows.
+        /// Every entry must supply its own `data` buffer of at least maxDatagramSize bytes. On success the
+        /// first N entries have `size` and `addr` filled in, where N is the returned count. Entries may be
+        /// reordered, so always read the buffer through `packets[i].data`. Returns WouldBlock if nothing is
+        /// queued. Oversized datagrams are left out of the batch and reported as Truncated, by the next call
+        /// if the batch already holds other datagrams. The default calls recvFrom(ReceivedPacket&&) per entry,
+        /// and can't hold a Truncated report back for the next call.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<size_t, Error> recvBatch(std::span<ReceivedPacket> packets);
+
+        /// Receives one datagram straight into a buffer taken from `pool`. Unlike recvFrom(), the packet stays
+        /// valid until its last handle goes away, so it can be queued or passed to another thread without a copy.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<PooledPacket, Error> recvPooled(PacketPool& pool);
+
+        /// recvBatch() into pooled buffers. Fills the first N handles, where N is the returned count; the
+        /// rest are reset. Fails with PoolExhausted if the pool has no buffers left at all.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatchPooled(PacketPool& pool, std::span<PooledPacket> packets);
+
+        /// recvFrom() that waits for a datagram until `deadline`, then fails with Timeout. It spins on the
+        /// socket for as long as its SpinBudget says, then parks in poll() on getReadHandle(); with
+        /// SocketOptions::busyPollMicros the kernel busy-polls the device queue while parked, where
+        /// net.core.busy_poll allows. Sockets without a descriptor to poll (MemoryNetwork) back off in
+        /// short sleeps instead. Errors other than WouldBlock come straight back. Not for a socket whose
+        /// receives another thread is also waiting on.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFromUntil(std::chrono::steady_clock::time_point deadline);
+
+        /// recvFrom(ReceivedPacket&&) that waits until `deadline`, like recvFromUntil(deadline).
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFromUntil(ReceivedPacket&& packet, std::chrono::steady_clock::time_point deadline);
+
+        /// recvBatch() that waits until `deadline` for at least one datagram, like recvFromUntil(deadline).
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatchUntil(std::span<ReceivedPacket> packets, std::chrono::steady_clock::time_point deadline);
+
+        /// Drains kernel transmit timestamps from the socket's error queue into `timestamps`, oldest first.
+        /// Returns the number written, or WouldBlock if none are queued yet. The socket must have been
+        /// created with SocketOptions::txTimestamps; backends that can't report them return Unsupported.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<size_t, Error> readTxTimestamps(std::span<TxTimestamp> /*timestamps*/) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        /// A snapshot of the socket's counters. The socket must have been created with SocketOptions::metrics,
+        /// otherwise this fails with InvalidArgument; backends that don't keep counters return Unsupported.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<SocketMetrics, Error> metrics() const {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        /// Caps what this socket sends to `addr` at `bytesPerSecond` payload bytes, on top of the socket-wide
+        /// SocketOptions::pacingRate; 0 lifts the cap. The socket must have been created with pacingRate
+        /// set, otherwise this fails with InvalidArgument; backends that can't pace return Unsupported.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<void, Error> setPacingRate(const Addr& /*addr*/, uint64_t /*bytesPerSecond*/) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        /// Userspace pacing: sends every queued datagram that is due. Returns the nanoseconds until the
+        /// next one is, for a timer, or -1 when nothing is queued (always, for sockets that don't queue).
+        /// A datagram the OS refuses is dropped and its error returned, including one that a send released
+        /// since the last call; WouldBlock leaves it queued. Backends that queue plain sends to submit them
+        /// together (io_uring) submit them here too, and report their failures the same way.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<int64_t, Error> flushPaced() {
+            return -1;
+        }
+
         // Returns underlying socket fd/handle if needed
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         virtual std::expected<int, Error> getHandle() const = 0;
 
+        // Descriptor that polls readable when a receive may succeed; what an event loop should wait on.
+        // Usually getHandle(), but backends that receive somewhere else (an io_uring completion queue)
+        // hand back that instead.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        virtual std::expected<int, Error> getReadHandle() const {
+            return getHandle();
+        }
+
+        // Where recvFromUntil() keeps what it learns about this socket's arrival gaps from one wait to
+        // the next. Sockets that don't keep one spin for the starting budget every time.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        virtual SpinBudget* spinBudget() noexcept {
+            return nullptr;
+        }
+
         // Close the socket
         virtual void close() = 0;
     };
 
+    // The pooled receives behind ISocket::recvPooled() and recvBatchPooled(), written once for any socket
+    // type with recvFrom(ReceivedPacket&&) and recvBatch(), so Socket<Backend> gets them without a virtual call.
+    struct PooledReceive {
+        template <class Socket>
+        static std::expected<PooledPacket, Error> one(Socket& socket, PacketPool& pool) {
+            auto packet = pool.acquire();
+            if (!packet) {
+                return packet;
+            }
+            auto received = socket.recvFrom(ReceivedPacket{ .data = packet->data(), .size = 0, .capacity = packet->capacity(), .addr = {} });
+            if (!received) {
+                return std::unexpected(received.error());
+            }
+            packet->setSize(received->size);
+            packet->setAddr(received->addr);
+            packet->slot_->timestamp_ns = received->timestampNs;
+            return packet;
+        }
+
+        template <class Socket>
+        static std::expected<size_t, Error> batch(Socket& socket, PacketPool& pool, std::span<PooledPacket> packets) {
+            constexpr size_t kMaxPooledBatch = 64;
+            ReceivedPacket views[kMaxPooledBatch];
+
+            size_t acquired = 0;
+            for (; acquired < std::min(packets.size(), kMaxPooledBatch); ++acquired) {
+                auto packet = pool.acquire();
+                if (!packet) {
+                    break;
+                }
+                views[acquired] = ReceivedPacket{ .data = packet->detach(), .size = 0, .capacity = pool.bufferSize(), .addr = {} };
+            }
+            for (auto& packet : packets) {
+                packet.reset();
+            }
+            if (acquired == 0) {
+                return packets.empty() ? std::expected<size_t, Error>(0) : make_unexpected(ErrorCode::PoolExhausted);
+            }
+
+            auto received = socket.recvBatch(std::span<ReceivedPacket>(views, acquired));
+            const size_t count = received ? *received : 0;
+
+            // recvBatch() may reorder entries, but every buffer is still in `views` exactly once.
+            for (size_t i = 0; i < acquired; ++i) {
+                auto packet = PooledPacket::Adopt(views[i].data);
+                if (i < count) {
+                    packet.setSize(views[i].size);
+                    packet.setAddr(views[i].addr);
+                    packet.slot_->timestamp_ns = views[i].timestampNs;
+                    packets[i] = std::move(packet);
+                }
+            }
+            return received;
+        }
+    };
+
+    // The waits behind ISocket::recvFromUntil() and recvBatchUntil(), shared with Socket<Backend> the same
+    // way PooledReceive is.
+    struct DeadlineReceive {
+        using Clock = std::chrono::steady_clock;
+
+        // Calls `receive` until it returns something other than WouldBlock, or `deadline` passes.
+        template <class Socket, class Receive>
+        static auto until(Socket& socket, SpinBudget* learned, Clock::time_point deadline, Receive receive) -> decltype(receive()) {
+            auto result = receive();
+            if (result || result.error() != ErrorCode::WouldBlock) {
+                return result; // Already queued: no clock read, nothing learned
+            }
+            SpinBudget fixed;
+            SpinBudget& budget = learned ? *learned : fixed;
+            const auto start = Clock::now();
+            const auto spin_end = std::min(start + budget.spin(), deadline);
+            auto now = start;
+            while (now < spin_end) {
+                result = receive();
+                now = Clock::now();
+                if (result || result.error() != ErrorCode::WouldBlock) {
+                    budget.record((now - start).count());
+                    return result;
+                }
+            }
+
+            const auto handle = socket.getReadHandle();
+            auto backoff = std::chrono::microseconds(50);
+            while (true) {
+                if (now >= deadline) {
+                    budget.record((now - start).count());
+                    return make_unexpected(ErrorCode::Timeout);
+                }
+                if (handle) {
+                    if (auto parked = park(*handle, deadline); !parked) {
+                        return std::unexpected(parked.error());
+                    }
+                } else {
+                    pause(std::min<Clock::duration>(backoff, deadline - now));
+                    backoff = std::min<std::chrono::microseconds>(backoff * 2, std::chrono::milliseconds(1));
+                }
+                result = receive();
+                now = Clock::now();
+                if (result || result.error() != ErrorCode::WouldBlock) {
+                    budget.record((now - start).count());
+                    return result;
+                }
+            }
+        }
+
+        // Blocks until `handle` polls readable or `deadline` passes, whichever is first. Interrupted
+        // waits return early; the caller just tries again.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<void, Error> park(int handle, Clock::time_point deadline);
+
+        // Sleeps for `duration`; out of line so this header doesn't need <thread>.
+        static void pause(Clock::duration duration);
+    };
+
+    inline std::expected<ReceivedPacket, Error> ISocket::recvFromUntil(std::chrono::steady_clock::time_point deadline) {
+        return DeadlineReceive::until(*this, spinBudget(), deadline, [&] { return recvFrom(); });
+    }
+
+    inline std::expected<ReceivedPacket, Error> ISocket::recvFromUntil(ReceivedPacket&& packet, std::chrono::steady_clock::time_point deadline) {
+        return DeadlineReceive::until(*this, spinBudget(), deadline, [&] { return recvFrom(ReceivedPacket(packet)); });
+    }
+
+    inline std::expected<size_t, Error> ISocket::recvBatchUntil(std::span<ReceivedPacket> packets, std::chrono::steady_clock::time_point deadline) {
+        return DeadlineReceive::until(*this, spinBudget(), deadline, [&] { return recvBatch(packets); });
+    }
+
+    inline std::expected<size_t, Error> ISocket::sendBatch(std::span<OutgoingPacket> packets) {
+        size_t sent = 0;
+        for (size_t i = 0; i < packets.size(); ++i) {
+            packets[i].result = sendTo(packets[i].addr, packets[i].data, packets[i].size);
+            if (packets[i].result) {
+                ++sent;
+                continue;
+            }
+            const Error error = packets[i].result.error();
+            for (size_t rest = i + 1; rest < packets.size(); ++rest) {
+                packets[rest].result = std::unexpected(error);
+            }
+            if (sent == 0 && error != ErrorCode::WouldBlock) {
+                return std::unexpected(error);
+            }
+            break;
+        }
+        return sent;
+    }
+
+    inline std::expected<size_t, Error> ISocket::sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segmentSize) {
+        if (data == nullptr || segmentSize == 0) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        size_t sent = 0;
+        for (size_t offset = 0; offset < length; offset += segmentSize) {
+            if (auto result = sendTo(addr, data + offset, std::min(segmentSize, length - offset)); !result) {
+                if (sent > 0) {
+                    return sent;
+                }
+                return std::unexpected(result.error());
+            }
+            ++sent;
+        }
+        return sent;
+    }
+
+    inline std::expected<size_t, Error> ISocket::recvBatch(std::span<ReceivedPacket> packets) {
+        size_t count = 0;
+        for (auto& packet : packets) {
+            auto received = recvFrom(ReceivedPacket(packet));
+            if (!received) {
+                if (count > 0) {
+                    break; // What's already in the batch goes back; the error comes again, or is gone
+                }
+                return std::unexpected(received.error());
+            }
+            packet = *received;
+            ++count;
+        }
+        return count;
+    }
+
+    inline std::expected<PooledPacket, Error> ISocket::recvPooled(PacketPool& pool) {
+        return PooledReceive::one(*this, pool);
+    }
+
+    inline std::expected<size_t, Error> ISocket::recvBatchPooled(PacketPool& pool, std::span<PooledPacket> packets) {
+        return PooledReceive::batch(*this, pool, packets);
+    }
+
 }
@@ -3,61 +3,85 @@
 #include <pulse/net/udp/error_code.h>
 
 #include <string>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <expected>
 #include <functional>
-#include <stdexcept>
 
 namespace pulse::net::udp {
 
+    // An IPv4 or IPv6 endpoint, kept as the raw sockaddr the kernel takes and hands back. Copies,
+    // comparisons and hashes work on those bytes; the IP string is only formatted when ip() is called.
     class Addr {
     public:
+        // sizeof(sockaddr_in6) on every platform we build for; sockaddr_in fits in the front of it.
+        static constexpr size_t kStorageSize = 28;
+
         // We need to be able to support default construction.
         Addr() = default;
-        std::string ip;
-        uint16_t port;
+
+        // Formats the address on every call, so keep it off hot paths.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        std::string ip() const;
+
+        // sin_port and sin6_port both sit at offset 2 in network byte order, on every platform.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        uint16_t port() const noexcept {
+            return static_cast<uint16_t>((storage_[2] << 8) | storage_[3]);
+        }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        bool isIPv6() const noexcept;
 
         // Internal socket address access
         [[nodiscard("Why are you ignoring this?")]]
-        const void* sockaddrData() const;
+        const void* sockaddrData() const noexcept {
+            return storage_;
+        }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        size_t sockaddrLen() const noexcept;
 
         [[nodiscard("Why did you ask for this and then ignore it?")]]
-        size_t sockaddrLen() const;
+        size_t hash() const noexcept {
+            uint64_t words[4]{};
+            std::memcpy(words, storage_, kStorageSize);
+            uint64_t h = (words[0] ^ 0x9E3779B97F4A7C15ull) * 0xBF58476D1CE4E5B9ull;
+            h = (h ^ words[1] ^ (h >> 31)) * 0x94D049BB133111EBull;
+            h = (h ^ words[2] ^ (h >> 29)) * 0xBF58476D1CE4E5B9ull;
+            h = (h ^ words[3] ^ (h >> 32)) * 0x94D049BB133111EBull;
+            return static_cast<size_t>(h ^ (h >> 31));
+        }
 
         // Let's create a constant AnyIPv4 and AnyIPv6 address const char * for convenience
         static const char * kAnyIPv4;
         static const char * kAnyIPv6;
 
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
-        static std::expected<Addr, Error> Create(const std::string& ip, uint16_t port) {
-            try {
-                return Addr(ip, port);
-            } catch (const std::invalid_argument& err) {
-                return std::unexpected(Error(ErrorCode::InvalidAddress, err));
-            } catch (...) {
-                return std::unexpected(Error(ErrorCode::Unknown, "Unknown error occurred while creating Addr"));
-            }
+        static std::expected<Addr, Error> Create(const std::string& ip, uint16_t port);
+
+        // Copies a sockaddr_in or sockaddr_in6 as returned by the kernel; `length` is the size it reported.
+        // No string formatting or parsing happens here.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<Addr, Error> FromSockaddr(const void* sockaddr, size_t length);
+
+        // Fields that don't identify the endpoint (flow info, padding) are always zero, so the bytes compare.
+        friend bool operator==(const Addr& lhs, const Addr& rhs) noexcept {
+            return std::memcmp(lhs.storage_, rhs.storage_, kStorageSize) == 0;
         }
 
     private:
-        alignas(16) char storage_[128]{}; // big enough for sockaddr_in6
-        
-        Addr(const std::string& ip, uint16_t port);
+        alignas(4) uint8_t storage_[kStorageSize]{};
     };
 
-    inline bool operator==(const Addr& lhs, const Addr& rhs) {
-        return lhs.ip == rhs.ip && lhs.port == rhs.port;
-    }
-
 } // namespace pulse::net::udp
 
 namespace std {
     template <>
     struct hash<pulse::net::udp::Addr> {
         size_t operator()(const pulse::net::udp::Addr& a) const noexcept {
-            size_t h1 = std::hash<std::string>{}(a.ip);
-            size_t h2 = std::hash<uint16_t>{}(a.port);
-            return h1 ^ (h2 << 1);
+            return a.hash();
         }
     };
 }
@@ -0,0 +1,124 @@
+#include "pulse/net/udp/async.h"
+
+#include <new>
+
+namespace pulse::net::udp {
+
+    namespace {
+
+        constexpr size_t kFrameGranularity = 64;
+        constexpr size_t kFrameClasses = FramePool::kMaxPooledFrame / kFrameGranularity;
+        constexpr size_t kMaxCachedFrames = 65536; // Per size class and thread; the rest go back to the heap
+
+        struct FreeFrame {
+            FreeFrame* next;
+        };
+
+        struct FrameCache {
+            FreeFrame* heads[kFrameClasses] = {};
+            size_t counts[kFrameClasses] = {};
+
+            ~FrameCache() {
+                for (FreeFrame* head : heads) {
+                    while (head != nullptr) {
+                        ::operator delete(std::exchange(head, head->next));
+                    }
+                }
+            }
+        };
+
+        thread_local FrameCache frame_cache;
+
+        size_t frame_class(size_t size) noexcept {
+            return (size + kFrameGranularity - 1) / kFrameGranularity - 1;
+        }
+
+    } // namespace
+
+    void* FramePool::allocate(size_t size) noexcept {
+        if (size == 0 || size > kMaxPooledFrame) {
+            return ::operator new(size, std::nothrow);
+        }
+        const size_t index = frame_class(size);
+        if (FreeFrame* frame = frame_cache.heads[index]) {
+            frame_cache.heads[index] = frame->next;
+            --frame_cache.counts[index];
+            return frame;
+        }
+        // Round up so the frame can serve any request in its class when it comes back.
+        return ::operator new((index + 1) * kFrameGranularity, std::nothrow);
+    }
+
+    void FramePool::deallocate(void* frame, size_t size) noexcept {
+        if (frame == nullptr) {
+            return;
+        }
+        if (size == 0 || size > kMaxPooledFrame) {
+            ::operator delete(frame);
+            return;
+        }
+        const size_t index = frame_class(size);
+        if (frame_cache.counts[index] == kMaxCachedFrames) {
+            ::operator delete(frame);
+            return;
+        }
+        auto* free_frame = static_cast<FreeFrame*>(frame);
+        free_frame->next = frame_cache.heads[index];
+        frame_cache.heads[index] = free_frame;
+        ++frame_cache.counts[index];
+    }
+
+    std::expected<std::unique_ptr<AsyncSocket>, Error> AsyncSocket::Create(EventLoop& loop, ISocket& socket) {
+        std::unique_ptr<AsyncSocket> async_socket(new (std::nothrow) AsyncSocket(loop, socket));
+        if (!async_socket) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, "Out of memory");
+        }
+        if (auto watched = loop.watch(*async_socket); !watched) {
+            return std::unexpected(watched.error());
+        }
+        return async_socket;
+    }
+
+    AsyncSocket::~AsyncSocket() {
+        loop_.unwatch(*this);
+
+        // Nothing will retry these any more, so finish them with an error instead of leaving the tasks hanging.
+        auto fail = [this](auto& waiters) {
+            while (!waiters.empty()) {
+                auto* waiter = waiters.pop();
+                waiter->result_ = make_unexpected(ErrorCode::InvalidSocket);
+                waiter->orphan_.handle = waiter->handle_;
+                loop_.adopt(waiter->orphan_); // Resuming here could destroy whatever is destroying us
+            }
+        };
+        fail(recv_waiters_);
+        fail(send_waiters_);
+    }
+
+    std::coroutine_handle<> AsyncSocket::completeRecv() {
+        if (recv_waiters_.empty()) {
+            return nullptr;
+        }
+        RecvAwaiter* waiter = recv_waiters_.head;
+        waiter->result_ = waiter->attempt();
+        if (waiter->wouldBlock()) {
+            return nullptr;
+        }
+        recv_waiters_.pop();
+        return waiter->handle_;
+    }
+
+    std::coroutine_handle<> AsyncSocket::completeSend() {
+        if (send_waiters_.empty()) {
+            return nullptr;
+        }
+        SendAwaiter* waiter = send_waiters_.head;
+        waiter->result_ = waiter->attempt();
+        if (waiter->wouldBlock()) {
+            return nullptr;
+        }
+        send_waiters_.pop();
+        return waiter->handle_;
+    }
+
+} // namespace pulse::net::udp
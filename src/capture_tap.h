@@ -0,0 +1,103 @@
+#pragma once
+
+#include <pulse/net/udp/packet_capture.h>
+#include <pulse/net/udp/udp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <optional>
+#include <span>
+
+namespace pulse::net::udp {
+
+    // One socket's connection to a PacketCapture: the addresses its datagrams are written under and a
+    // countdown per direction for sampling. Sockets only create one when SocketOptions::capture is set,
+    // so the cost without a capture is a null check, like SocketCounters. Records what went through,
+    // never what failed.
+    class CaptureTap {
+    public:
+        CaptureTap(std::shared_ptr<PacketCapture> capture, const Addr& local, std::optional<Addr> peer)
+            : capture_(std::move(capture)), local_(local), peer_(peer) {}
+
+        void recordSend(const std::expected<void, Error>& result, const Addr& to, const uint8_t* data, size_t length) noexcept {
+            if (result && capture_->enabled() && sampled(tx_)) {
+                capture_->record(CaptureDirection::Sent, local_, to, data, length);
+            }
+        }
+
+        // send() on a connected socket.
+        void recordSend(const std::expected<void, Error>& result, const uint8_t* data, size_t length) noexcept {
+            if (peer_) {
+                recordSend(result, *peer_, data, length);
+            }
+        }
+
+        void recordSendBatch(std::span<const OutgoingPacket> packets) noexcept {
+            if (!capture_->enabled()) {
+                return;
+            }
+            for (const auto& packet : packets) {
+                if (packet.result && sampled(tx_)) {
+                    capture_->record(CaptureDirection::Sent, local_, packet.addr, packet.data, packet.size);
+                }
+            }
+        }
+
+        // sendSegmented() sends its segments in order, so `count` of them cover the front of the buffer.
+        void recordSendSegmented(const std::expected<size_t, Error>& result, const Addr& to, const uint8_t* data, size_t length, size_t segment_size) noexcept {
+            if (!result || !capture_->enabled()) {
+                return;
+            }
+            for (size_t i = 0, offset = 0; i < *result && offset < length; ++i, offset += segment_size) {
+                if (sampled(tx_)) {
+                    capture_->record(CaptureDirection::Sent, local_, to, data + offset, std::min(segment_size, length - offset));
+                }
+            }
+        }
+
+        void recordRecv(const std::expected<ReceivedPacket, Error>& result) noexcept {
+            if (result && capture_->enabled() && sampled(rx_)) {
+                capture_->record(CaptureDirection::Received, local_, result->addr, result->data, result->size);
+            }
+        }
+
+        void recordRecvBatch(const std::expected<size_t, Error>& result, std::span<const ReceivedPacket> packets) noexcept {
+            if (!result || !capture_->enabled()) {
+                return;
+            }
+            for (size_t i = 0; i < *result; ++i) {
+                if (sampled(rx_)) {
+                    capture_->record(CaptureDirection::Received, local_, packets[i].addr, packets[i].data, packets[i].size);
+                }
+            }
+        }
+
+    private:
+        struct alignas(64) Countdown {
+            std::atomic<uint32_t> remaining{0};
+        };
+
+        // True for one call in every sampleEvery. A plain load and store: two threads sending at once may
+        // both take the same turn, which only nudges the rate.
+        bool sampled(Countdown& countdown) const noexcept {
+            const uint32_t remaining = countdown.remaining.load(std::memory_order_relaxed);
+            if (remaining == 0) {
+                countdown.remaining.store(capture_->sampleEvery() - 1, std::memory_order_relaxed);
+                return true;
+            }
+            countdown.remaining.store(remaining - 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        std::shared_ptr<PacketCapture> capture_;
+        Addr local_;
+        std::optional<Addr> peer_;
+        Countdown tx_;
+        Countdown rx_;
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,33 @@
+#include <pulse/net/udp/udp.h>
+
+#include <poll.h>
+#include <errno.h>
+#include <time.h>
+
+#include <thread>
+
+namespace pulse::net::udp {
+
+    std::expected<void, Error> DeadlineReceive::park(int handle, Clock::time_point deadline) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now()).count();
+        if (remaining <= 0) {
+            return {};
+        }
+        pollfd fd{ .fd = handle, .events = POLLIN, .revents = 0 };
+#if defined(__linux__)
+        const timespec timeout{ .tv_sec = static_cast<time_t>(remaining / 1'000'000'000), .tv_nsec = static_cast<long>(remaining % 1'000'000'000) };
+        const int ready = ::ppoll(&fd, 1, &timeout, nullptr);
+#else
+        const int ready = ::poll(&fd, 1, static_cast<int>((remaining + 999'999) / 1'000'000));
+#endif
+        if (ready < 0 && errno != EINTR) {
+            return make_unexpected(ErrorCode::RecvFailed, errno);
+        }
+        return {};
+    }
+
+    void DeadlineReceive::pause(Clock::duration duration) {
+        std::this_thread::sleep_for(duration);
+    }
+
+} // namespace pulse::net::udp
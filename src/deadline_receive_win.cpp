@@ -0,0 +1,28 @@
+#include <pulse/net/udp/udp.h>
+
+#include <winsock2.h>
+
+#include <thread>
+
+namespace pulse::net::udp {
+
+    std::expected<void, Error> DeadlineReceive::park(int handle, Clock::time_point deadline) {
+        const auto remaining = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - Clock::now()).count();
+        if (remaining <= 0) {
+            return {};
+        }
+        // WSAPoll only counts in milliseconds; round up so a short wait doesn't turn into a spin.
+        WSAPOLLFD fd{};
+        fd.fd = static_cast<SOCKET>(handle);
+        fd.events = POLLRDNORM;
+        if (WSAPoll(&fd, 1, static_cast<INT>((remaining + 999'999) / 1'000'000)) == SOCKET_ERROR) {
+            return make_unexpected(ErrorCode::RecvFailed, WSAGetLastError());
+        }
+        return {};
+    }
+
+    void DeadlineReceive::pause(Clock::duration duration) {
+        std::this_thread::sleep_for(duration);
+    }
+
+} // namespace pulse::net::udp
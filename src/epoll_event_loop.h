@@ -0,0 +1,77 @@
+#pragma once
+
+#include <pulse/net/udp/async.h>
+
+#include <sys/epoll.h>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    class EpollEventLoop : public EventLoop {
+    public:
+        ~EpollEventLoop() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> poll(int timeoutMs) override;
+
+        void wake() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<EventLoop>, Error> Create();
+
+    protected:
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> schedule(std::coroutine_handle<> handle) override;
+
+        void adopt(OrphanedTask& task) noexcept override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> watch(AsyncSocket& socket) override;
+
+        void unwatch(AsyncSocket& socket) override;
+
+        void watchWritable(AsyncSocket& socket, bool enabled) override;
+
+    private:
+        struct Registration {
+            AsyncSocket* socket = nullptr;
+            bool split = false; // getReadHandle() and getHandle() differ, so each has its own epoll entry
+            bool readable = false; // Readiness not yet handed to the socket's waiters
+            bool writable = false;
+            bool writable_armed = false; // EPOLLOUT is in the interest set
+            bool pending = false; // Queued in ready_ or pending_
+            bool removed = false;
+        };
+
+        static constexpr size_t kResumeBudget = 64; // Resumptions per socket per direction per poll()
+        static constexpr int kMaxEvents = 64;
+        static constexpr uint64_t kWriteTag = 1; // Set in the epoll data of a split socket's write descriptor
+
+        EpollEventLoop() = default;
+
+        // Completes queued operations on `registration` while it stays ready. Returns true if the budget
+        // ran out with readiness left over.
+        bool dispatch(Registration& registration, size_t& resumed);
+
+        // Interest set and epoll data for the write descriptor, EPOLLOUT included only when `writable`.
+        static epoll_event writeEvent(Registration& registration, bool writable);
+
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+        bool dispatching_ = false;
+
+        std::unordered_map<AsyncSocket*, std::unique_ptr<Registration>> registrations_;
+        std::vector<std::coroutine_handle<>> runnable_; // Spawned or failed tasks, resumed by the next poll()
+        std::vector<std::coroutine_handle<>> running_;
+        std::vector<Registration*> ready_;   // Being dispatched by the current poll()
+        std::vector<Registration*> pending_; // Cut short by the budget; dispatched on the next poll()
+        std::vector<std::unique_ptr<Registration>> retired_; // Unwatched mid-dispatch, freed when poll() returns; reserved by watch()
+        OrphanedTask* orphans_head_ = nullptr; // Adopted tasks, resumed by the next poll()
+        OrphanedTask* orphans_tail_ = nullptr;
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,283 @@
+#include "epoll_event_loop.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <utility>
+
+namespace pulse::net::udp {
+
+    EpollEventLoop::~EpollEventLoop() {
+        // Tasks that never got to run are ours to free; ones parked on a socket belong to that socket.
+        for (auto handle : runnable_) {
+            handle.destroy();
+        }
+        while (orphans_head_ != nullptr) {
+            std::exchange(orphans_head_, orphans_head_->next)->handle.destroy(); // The link lives in the frame
+        }
+        if (wake_fd_ >= 0) {
+            ::close(wake_fd_);
+        }
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+        }
+    }
+
+    std::expected<std::unique_ptr<EventLoop>, Error> EpollEventLoop::Create() {
+        std::unique_ptr<EpollEventLoop> loop;
+        try {
+            loop.reset(new EpollEventLoop());
+            loop->ready_.reserve(kMaxEvents);
+            loop->runnable_.reserve(kMaxEvents);
+            loop->running_.reserve(kMaxEvents);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        loop->epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (loop->epoll_fd_ < 0) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+        }
+
+        loop->wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (loop->wake_fd_ < 0) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+        }
+
+        // Null data marks the wake descriptor; every socket carries its Registration.
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.u64 = 0;
+        if (::epoll_ctl(loop->epoll_fd_, EPOLL_CTL_ADD, loop->wake_fd_, &event) < 0) {
+            return make_unexpected(ErrorCode::SocketConfigFailed, errno);
+        }
+
+        return loop;
+    }
+
+    std::expected<void, Error> EpollEventLoop::schedule(std::coroutine_handle<> handle) {
+        try {
+            runnable_.push_back(handle);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::Unknown, err);
+        }
+        return {};
+    }
+
+    void EpollEventLoop::adopt(OrphanedTask& task) noexcept {
+        task.next = nullptr;
+        (orphans_tail_ ? orphans_tail_->next : orphans_head_) = &task;
+        orphans_tail_ = &task;
+    }
+
+    epoll_event EpollEventLoop::writeEvent(Registration& registration, bool writable) {
+        epoll_event event{};
+        event.events = (registration.split ? 0 : static_cast<uint32_t>(EPOLLIN)) | EPOLLET | (writable ? static_cast<uint32_t>(EPOLLOUT) : 0);
+        event.data.u64 = reinterpret_cast<uintptr_t>(&registration) | (registration.split ? kWriteTag : 0);
+        return event;
+    }
+
+    std::expected<void, Error> EpollEventLoop::watch(AsyncSocket& socket) {
+        auto read_fd = socket.socket().getReadHandle();
+        if (!read_fd) {
+            return std::unexpected(read_fd.error());
+        }
+        auto write_fd = socket.socket().getHandle();
+        if (!write_fd) {
+            return std::unexpected(write_fd.error());
+        }
+
+        std::unique_ptr<Registration> registration;
+        try {
+            registration = std::make_unique<Registration>();
+            registration->socket = &socket;
+            registration->split = *read_fd != *write_fd;
+            pending_.reserve(registrations_.size() + 1);
+            ready_.reserve(registrations_.size() + 1);
+            registrations_.reserve(registrations_.size() + 1);
+            retired_.reserve(retired_.size() + registrations_.size() + 1); // So unwatch() never allocates
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketConfigFailed, err);
+        }
+
+        // Edge-triggered, and EPOLLOUT only while a send is parked: a socket with room to write would
+        // otherwise report it on every packet it sends.
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.u64 = reinterpret_cast<uintptr_t>(registration.get());
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, *read_fd, &event) < 0) {
+            return make_unexpected(errno == EBADF ? ErrorCode::InvalidSocket : ErrorCode::SocketConfigFailed, errno);
+        }
+        if (registration->split) {
+            event = writeEvent(*registration, false);
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, *write_fd, &event) < 0) {
+                const int err = errno;
+                ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, *read_fd, nullptr);
+                return make_unexpected(err == EBADF ? ErrorCode::InvalidSocket : ErrorCode::SocketConfigFailed, err);
+            }
+        }
+
+        registrations_.emplace(&socket, std::move(registration));
+        return {};
+    }
+
+    void EpollEventLoop::unwatch(AsyncSocket& socket) {
+        auto it = registrations_.find(&socket);
+        if (it == registrations_.end()) {
+            return;
+        }
+
+        if (auto fd = socket.socket().getReadHandle(); fd) {
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, *fd, nullptr);
+        }
+        if (auto fd = socket.socket().getHandle(); fd && it->second->split) {
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, *fd, nullptr);
+        }
+
+        auto registration = std::move(it->second);
+        registrations_.erase(it);
+
+        registration->removed = true;
+        std::erase(pending_, registration.get());
+
+        // The current poll() may still hold a pointer to it in ready_ or in an epoll event. watch() left
+        // room for it, so the destructor path can't throw here.
+        if (dispatching_) {
+            retired_.push_back(std::move(registration));
+        }
+    }
+
+    void EpollEventLoop::watchWritable(AsyncSocket& socket, bool enabled) {
+        auto it = registrations_.find(&socket);
+        if (it == registrations_.end() || it->second->writable_armed == enabled) {
+            return;
+        }
+        auto fd = socket.socket().getHandle();
+        if (!fd) {
+            return;
+        }
+
+        // Adding EPOLLOUT re-polls the descriptor, so room that opened up since the failed send still fires.
+        epoll_event event = writeEvent(*it->second, enabled);
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, *fd, &event) == 0) {
+            it->second->writable_armed = enabled;
+        }
+    }
+
+    std::expected<size_t, Error> EpollEventLoop::poll(int timeout_ms) {
+        size_t resumed = 0;
+
+        // Tasks scheduled while these run wait for the next poll(), so a task that keeps respawning
+        // can't keep us from the sockets.
+        running_.swap(runnable_);
+        for (auto handle : running_) {
+            handle.resume();
+            ++resumed;
+        }
+        running_.clear();
+
+        // Likewise tasks whose socket went away; each link lives in its task's frame, gone once resumed.
+        OrphanedTask* orphan = std::exchange(orphans_head_, nullptr);
+        orphans_tail_ = nullptr;
+        while (orphan != nullptr) {
+            const auto handle = orphan->handle;
+            orphan = orphan->next;
+            handle.resume();
+            ++resumed;
+        }
+
+        // Don't sleep while there's work left over.
+        epoll_event events[kMaxEvents];
+        const bool busy = !runnable_.empty() || orphans_head_ != nullptr || !pending_.empty() || resumed > 0;
+        int count = ::epoll_wait(epoll_fd_, events, kMaxEvents, busy ? 0 : timeout_ms);
+        if (count < 0) {
+            if (errno != EINTR) {
+                return make_unexpected(ErrorCode::PollFailed, errno);
+            }
+            count = 0;
+        }
+
+        ready_.swap(pending_);
+        for (int i = 0; i < count; ++i) {
+            const uint64_t data = events[i].data.u64;
+            auto* registration = reinterpret_cast<Registration*>(data & ~kWriteTag);
+            if (registration == nullptr) {
+                uint64_t value = 0;
+                (void)::read(wake_fd_, &value, sizeof(value));
+                continue;
+            }
+            // Errors are delivered by the next receive or send, so they wake both sides.
+            const uint32_t flags = events[i].events;
+            if (data & kWriteTag) {
+                registration->writable = true;
+            } else {
+                registration->readable |= (flags & (EPOLLIN | EPOLLERR | EPOLLHUP)) != 0;
+                registration->writable |= (flags & (EPOLLOUT | EPOLLERR | EPOLLHUP)) != 0;
+            }
+            if (!registration->pending) {
+                registration->pending = true;
+                ready_.push_back(registration);
+            }
+        }
+
+        dispatching_ = true;
+        for (Registration* registration : ready_) {
+            if (registration->removed) {
+                continue;
+            }
+            registration->pending = false;
+            if (dispatch(*registration, resumed) && !registration->removed) {
+                registration->pending = true;
+                pending_.push_back(registration);
+            }
+        }
+        dispatching_ = false;
+
+        ready_.clear();
+        retired_.clear();
+        return resumed;
+    }
+
+    bool EpollEventLoop::dispatch(Registration& registration, size_t& resumed) {
+        // Resuming a task may destroy its AsyncSocket, which unwatches it and sets `removed`.
+        auto drain = [&](bool& ready, auto complete) {
+            if (!ready) {
+                return;
+            }
+            for (size_t budget = kResumeBudget; budget > 0; --budget) {
+                auto handle = (registration.socket->*complete)();
+                if (!handle) {
+                    ready = false; // Would block again, or nobody is waiting and the next await will try itself.
+                    return;
+                }
+                handle.resume();
+                ++resumed;
+                if (registration.removed) {
+                    return;
+                }
+            }
+        };
+
+        drain(registration.readable, &AsyncSocket::completeRecv);
+        if (registration.removed) {
+            return false;
+        }
+        drain(registration.writable, &AsyncSocket::completeSend);
+        if (registration.removed) {
+            return false;
+        }
+
+        if (registration.writable_armed && !registration.socket->hasSendWaiters()) {
+            watchWritable(*registration.socket, false);
+        }
+        return registration.readable || registration.writable;
+    }
+
+    void EpollEventLoop::wake() {
+        const uint64_t one = 1;
+        (void)::write(wake_fd_, &one, sizeof(one));
+    }
+
+} // namespace pulse::net::udp
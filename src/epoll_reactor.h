@@ -0,0 +1,56 @@
+#pragma once
+
+#include <pulse/net/udp/reactor.h>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    class EpollReactor : public Reactor {
+    public:
+        ~EpollReactor() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> add(ISocket& socket, PacketHandler handler) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> remove(ISocket& socket) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> poll(int timeoutMs) override;
+
+        void wake() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<Reactor>, Error> Create();
+
+    private:
+        struct Registration {
+            ISocket* socket = nullptr;
+            PacketHandler handler;
+            bool pending = false; // Queued in ready_ or pending_
+            bool removed = false;
+        };
+
+        static constexpr size_t kDrainBudget = 64; // Datagrams per socket per poll() before moving on
+        static constexpr int kMaxEvents = 64;
+
+        EpollReactor() = default;
+
+        // Drains `registration` until WouldBlock or the budget runs out. Returns true if the socket
+        // may still have datagrams queued.
+        bool drain(Registration& registration, size_t& dispatched);
+
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+        bool dispatching_ = false;
+
+        std::unordered_map<ISocket*, std::unique_ptr<Registration>> registrations_;
+        std::vector<Registration*> ready_;   // Being dispatched by the current poll()
+        std::vector<Registration*> pending_; // Cut short by the budget; drained on the next poll()
+        std::vector<std::unique_ptr<Registration>> retired_; // Removed mid-dispatch, freed when poll() returns
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,185 @@
+#include "epoll_reactor.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <utility>
+
+namespace pulse::net::udp {
+
+    EpollReactor::~EpollReactor() {
+        if (wake_fd_ >= 0) {
+            ::close(wake_fd_);
+        }
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+        }
+    }
+
+    std::expected<std::unique_ptr<Reactor>, Error> EpollReactor::Create() {
+        std::unique_ptr<EpollReactor> reactor;
+        try {
+            reactor.reset(new EpollReactor());
+            reactor->ready_.reserve(kMaxEvents);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        reactor->epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (reactor->epoll_fd_ < 0) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+        }
+
+        reactor->wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (reactor->wake_fd_ < 0) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+        }
+
+        // A null data pointer marks the wake descriptor; every socket carries its Registration.
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = nullptr;
+        if (::epoll_ctl(reactor->epoll_fd_, EPOLL_CTL_ADD, reactor->wake_fd_, &event) < 0) {
+            return make_unexpected(ErrorCode::SocketConfigFailed, errno);
+        }
+
+        return reactor;
+    }
+
+    std::expected<void, Error> EpollReactor::add(ISocket& socket, PacketHandler handler) {
+        if (!handler) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        if (registrations_.contains(&socket)) {
+            return make_unexpected(ErrorCode::InvalidArgument, "Socket is already registered");
+        }
+
+        auto fd = socket.getReadHandle();
+        if (!fd) {
+            return std::unexpected(fd.error());
+        }
+
+        std::unique_ptr<Registration> registration;
+        try {
+            registration = std::make_unique<Registration>();
+            registration->socket = &socket;
+            registration->handler = std::move(handler);
+            pending_.reserve(pending_.size() + 1);
+            ready_.reserve(registrations_.size() + 1);
+            registrations_.reserve(registrations_.size() + 1);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketConfigFailed, err);
+        }
+
+        // Edge-triggered: we only hear about new arrivals, so drain() always reads to WouldBlock.
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = registration.get();
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, *fd, &event) < 0) {
+            return make_unexpected(errno == EBADF ? ErrorCode::InvalidSocket : ErrorCode::SocketConfigFailed, errno);
+        }
+
+        // Datagrams may already be waiting, possibly somewhere epoll can't see (an io_uring completion
+        // queue), so give the socket one drain on the next poll() regardless of readiness.
+        registration->pending = true;
+        pending_.push_back(registration.get());
+
+        registrations_.emplace(&socket, std::move(registration));
+        return {};
+    }
+
+    std::expected<void, Error> EpollReactor::remove(ISocket& socket) {
+        auto it = registrations_.find(&socket);
+        if (it == registrations_.end()) {
+            return make_unexpected(ErrorCode::InvalidArgument, "Socket is not registered");
+        }
+
+        if (auto fd = socket.getReadHandle(); fd) {
+            ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, *fd, nullptr);
+        }
+
+        auto registration = std::move(it->second);
+        registrations_.erase(it);
+
+        registration->removed = true;
+        std::erase(pending_, registration.get());
+
+        // The current poll() may still hold a pointer to it in ready_ or in an epoll event.
+        if (dispatching_) {
+            retired_.push_back(std::move(registration));
+        }
+        return {};
+    }
+
+    std::expected<size_t, Error> EpollReactor::poll(int timeout_ms) {
+        // Leftovers from the last poll() are ready now; don't sleep on them.
+        epoll_event events[kMaxEvents];
+        int count = ::epoll_wait(epoll_fd_, events, kMaxEvents, pending_.empty() ? timeout_ms : 0);
+        if (count < 0) {
+            if (errno != EINTR) {
+                return make_unexpected(ErrorCode::PollFailed, errno);
+            }
+            count = 0;
+        }
+
+        ready_.swap(pending_);
+        for (int i = 0; i < count; ++i) {
+            auto* registration = static_cast<Registration*>(events[i].data.ptr);
+            if (registration == nullptr) {
+                uint64_t value = 0;
+                (void)::read(wake_fd_, &value, sizeof(value));
+                continue;
+            }
+            if (!registration->pending) {
+                registration->pending = true;
+                ready_.push_back(registration);
+            }
+        }
+
+        size_t dispatched = 0;
+        dispatching_ = true;
+        for (Registration* registration : ready_) {
+            if (registration->removed) {
+                continue;
+            }
+            registration->pending = false;
+            if (drain(*registration, dispatched) && !registration->removed) {
+                registration->pending = true;
+                pending_.push_back(registration);
+            }
+        }
+        dispatching_ = false;
+
+        ready_.clear();
+        retired_.clear();
+        return dispatched;
+    }
+
+    bool EpollReactor::drain(Registration& registration, size_t& dispatched) {
+        for (size_t budget = kDrainBudget; budget > 0; --budget) {
+            auto packet = registration.socket->recvFrom();
+            if (!packet) {
+                if (packet.error() == ErrorCode::WouldBlock || packet.error() == ErrorCode::InvalidSocket) {
+                    return false;
+                }
+                continue; // A malformed datagram only costs itself.
+            }
+
+            registration.handler(*registration.socket, *packet);
+            ++dispatched;
+
+            if (registration.removed) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void EpollReactor::wake() {
+        const uint64_t one = 1;
+        (void)::write(wake_fd_, &one, sizeof(one));
+    }
+
+} // namespace pulse::net::udp
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <pulse/net/udp/error_code.h>
+
+#include <linux/io_uring.h>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+
+namespace pulse::net::udp {
+
+    // Thin wrapper over the raw io_uring syscalls and ring mappings. We talk to the kernel directly
+    // instead of pulling in liburing so the library keeps zero dependencies.
+    class IoUringRing {
+    public:
+        ~IoUringRing();
+
+        IoUringRing(const IoUringRing&) = delete;
+        IoUringRing& operator=(const IoUringRing&) = delete;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<IoUringRing>, Error> Create(unsigned entries, unsigned cq_entries);
+
+        // Next free submission entry, already zeroed, or nullptr if the submission queue is full.
+        [[nodiscard("Why ask for an SQE and then ignore it?")]]
+        io_uring_sqe* getSqe();
+
+        // Publishes every SQE handed out since the last call and waits for `wait_for` completions.
+        // Returns the number of SQEs consumed by the kernel, or -errno.
+        int submit(unsigned wait_for = 0);
+
+        // Takes back every SQE handed out that the kernel hasn't consumed, published or not, and returns
+        // how many. The rings are set up without SQPOLL, so the kernel only consumes SQEs inside
+        // io_uring_enter() and anything still queued after submit() returns is ours to drop.
+        unsigned withdraw();
+
+        // Oldest completion not yet consumed, or nullptr if the completion queue is empty.
+        [[nodiscard("Why ask for a CQE and then ignore it?")]]
+        const io_uring_cqe* peekCqe() const;
+        void advanceCq(unsigned count = 1);
+
+        // True when completions are parked in the kernel (deferred task work or CQ overflow)
+        // and only an io_uring_enter() will move them into the ring.
+        [[nodiscard("Why ask and then ignore the answer?")]]
+        bool needsFlush() const;
+        int flush();
+
+        int registerRaw(unsigned opcode, void* arg, unsigned nr_args);
+
+        [[nodiscard("Why ask for the descriptor and then ignore it?")]]
+        int fd() const { return ring_fd_; }
+
+    private:
+        IoUringRing() = default;
+
+        int ring_fd_ = -1;
+
+        void* sq_ring_ = nullptr;
+        size_t sq_ring_size_ = 0;
+        void* cq_ring_ = nullptr;
+        size_t cq_ring_size_ = 0;
+        io_uring_sqe* sqes_ = nullptr;
+        size_t sqes_size_ = 0;
+
+        unsigned* sq_head_ = nullptr;
+        unsigned* sq_tail_ = nullptr;
+        unsigned* sq_flags_ = nullptr;
+        unsigned sq_mask_ = 0;
+        unsigned sq_entries_ = 0;
+        unsigned sqe_tail_ = 0; // Handed out by getSqe() but not yet published
+
+        unsigned* cq_head_ = nullptr;
+        unsigned* cq_tail_ = nullptr;
+        io_uring_cqe* cqes_ = nullptr;
+        unsigned cq_mask_ = 0;
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,194 @@
+#include "io_uring_ring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace pulse::net::udp {
+
+    namespace {
+
+        int sys_io_uring_setup(unsigned entries, io_uring_params* params) {
+            return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+            return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        int sys_io_uring_register(int fd, unsigned opcode, void* arg, unsigned nr_args) {
+            return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, nr_args));
+        }
+
+        unsigned load_acquire(unsigned* p) {
+            return std::atomic_ref<unsigned>(*p).load(std::memory_order_acquire);
+        }
+
+        void store_release(unsigned* p, unsigned value) {
+            std::atomic_ref<unsigned>(*p).store(value, std::memory_order_release);
+        }
+
+        template <class T>
+        T* at_offset(void* base, uint32_t offset) {
+            return reinterpret_cast<T*>(static_cast<uint8_t*>(base) + offset);
+        }
+
+    } // namespace
+
+    IoUringRing::~IoUringRing() {
+        if (sqes_) {
+            ::munmap(sqes_, sqes_size_);
+        }
+        if (cq_ring_ && cq_ring_ != sq_ring_) {
+            ::munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_) {
+            ::munmap(sq_ring_, sq_ring_size_);
+        }
+        if (ring_fd_ >= 0) {
+            ::close(ring_fd_);
+        }
+    }
+
+    std::expected<std::unique_ptr<IoUringRing>, Error> IoUringRing::Create(unsigned entries, unsigned cq_entries) {
+        std::unique_ptr<IoUringRing> ring;
+        try {
+            ring.reset(new IoUringRing());
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        // Cooperative task running keeps the kernel from interrupting us with IPIs; the TASKRUN flag
+        // tells us when to enter instead. Both need 5.19, so retry without them on older kernels.
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_COOP_TASKRUN | IORING_SETUP_TASKRUN_FLAG;
+        params.cq_entries = cq_entries;
+
+        int fd = sys_io_uring_setup(entries, &params);
+        if (fd < 0 && errno == EINVAL) {
+            params = io_uring_params{};
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = cq_entries;
+            fd = sys_io_uring_setup(entries, &params);
+        }
+        if (fd < 0) {
+            return make_unexpected(errno == ENOSYS || errno == EPERM ? ErrorCode::Unsupported : ErrorCode::SocketCreateFailed, errno);
+        }
+        ring->ring_fd_ = fd;
+
+        ring->sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        ring->cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) {
+            ring->sq_ring_size_ = ring->cq_ring_size_ = std::max(ring->sq_ring_size_, ring->cq_ring_size_);
+        }
+
+        void* sq = ::mmap(nullptr, ring->sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq == MAP_FAILED) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+        }
+        ring->sq_ring_ = sq;
+
+        if (single_mmap) {
+            ring->cq_ring_ = sq;
+        } else {
+            void* cq = ::mmap(nullptr, ring->cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq == MAP_FAILED) {
+                return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+            }
+            ring->cq_ring_ = cq;
+        }
+
+        ring->sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, ring->sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+        }
+        ring->sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        ring->sq_head_ = at_offset<unsigned>(ring->sq_ring_, params.sq_off.head);
+        ring->sq_tail_ = at_offset<unsigned>(ring->sq_ring_, params.sq_off.tail);
+        ring->sq_flags_ = at_offset<unsigned>(ring->sq_ring_, params.sq_off.flags);
+        ring->sq_mask_ = *at_offset<unsigned>(ring->sq_ring_, params.sq_off.ring_mask);
+        ring->sq_entries_ = params.sq_entries;
+        ring->sqe_tail_ = *ring->sq_tail_;
+
+        // SQEs are always consumed in order, so the indirection array is an identity map set once.
+        unsigned* sq_array = at_offset<unsigned>(ring->sq_ring_, params.sq_off.array);
+        for (unsigned i = 0; i < params.sq_entries; ++i) {
+            sq_array[i] = i;
+        }
+
+        ring->cq_head_ = at_offset<unsigned>(ring->cq_ring_, params.cq_off.head);
+        ring->cq_tail_ = at_offset<unsigned>(ring->cq_ring_, params.cq_off.tail);
+        ring->cq_mask_ = *at_offset<unsigned>(ring->cq_ring_, params.cq_off.ring_mask);
+        ring->cqes_ = at_offset<io_uring_cqe>(ring->cq_ring_, params.cq_off.cqes);
+
+        return ring;
+    }
+
+    io_uring_sqe* IoUringRing::getSqe() {
+        const unsigned head = load_acquire(sq_head_);
+        if (sqe_tail_ - head >= sq_entries_) {
+            return nullptr;
+        }
+
+        io_uring_sqe* sqe = &sqes_[sqe_tail_ & sq_mask_];
+        ++sqe_tail_;
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    int IoUringRing::submit(unsigned wait_for) {
+        const unsigned to_submit = sqe_tail_ - *sq_tail_;
+        store_release(sq_tail_, sqe_tail_);
+
+        if (to_submit == 0 && wait_for == 0 && !needsFlush()) {
+            return 0;
+        }
+
+        const unsigned flags = (wait_for > 0 || needsFlush()) ? IORING_ENTER_GETEVENTS : 0;
+        int result = sys_io_uring_enter(ring_fd_, to_submit, wait_for, flags);
+        return result < 0 ? -errno : result;
+    }
+
+    unsigned IoUringRing::withdraw() {
+        const unsigned head = load_acquire(sq_head_);
+        const unsigned withdrawn = sqe_tail_ - head;
+        sqe_tail_ = head;
+        store_release(sq_tail_, head);
+        return withdrawn;
+    }
+
+    const io_uring_cqe* IoUringRing::peekCqe() const {
+        const unsigned head = *cq_head_;
+        if (head == load_acquire(cq_tail_)) {
+            return nullptr;
+        }
+        return &cqes_[head & cq_mask_];
+    }
+
+    void IoUringRing::advanceCq(unsigned count) {
+        store_release(cq_head_, *cq_head_ + count);
+    }
+
+    bool IoUringRing::needsFlush() const {
+        const unsigned flags = std::atomic_ref<unsigned>(*sq_flags_).load(std::memory_order_relaxed);
+        return (flags & (IORING_SQ_TASKRUN | IORING_SQ_CQ_OVERFLOW)) != 0;
+    }
+
+    int IoUringRing::flush() {
+        int result = sys_io_uring_enter(ring_fd_, 0, 0, IORING_ENTER_GETEVENTS);
+        return result < 0 ? -errno : result;
+    }
+
+    int IoUringRing::registerRaw(unsigned opcode, void* arg, unsigned nr_args) {
+        int result = sys_io_uring_register(ring_fd_, opcode, arg, nr_args);
+        return result < 0 ? -errno : result;
+    }
+
+} // namespace pulse::net::udp
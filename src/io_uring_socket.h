@@ -0,0 +1,198 @@
+#pragma once
+
+#include <pulse/net/udp/socket_factory.h>
+#include <pulse/net/udp/udp.h>
+#include <pulse/net/udp/error_code.h>
+#include <pulse/net/udp/udp_addr.h>
+
+#include "io_uring_ring.h"
+#include "unix_socket.h"
+
+#include <sys/socket.h>
+#include <array>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    // ISocket driven through io_uring. Receives come from one multishot recvmsg that the kernel keeps
+    // feeding from a ring of provided buffers, so a busy socket costs no syscalls per datagram.
+    // sendTo() and send() copy the datagram into a send slot and queue its SQE; the queue is submitted
+    // in one io_uring_enter() by the next receive, sendBatch() or flushPaced(), or as soon as every
+    // slot is taken, and send completions are reaped whenever we pass by. Calls never block: an empty
+    // completion queue is reported as WouldBlock, exactly like SocketUnix.
+    class SocketIoUring final : public ISocket {
+    public:
+        ~SocketIoUring() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> sendTo(const Addr& addr, const uint8_t* data, size_t length) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> send(const uint8_t* data, size_t length) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendBatch(std::span<OutgoingPacket> packets) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segmentSize) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFrom() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFrom(ReceivedPacket&& packet) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatch(std::span<ReceivedPacket> packets) override;
+
+        // Submits the queued sends and returns the first error one of them completed with since the last
+        // call. Nothing is ever held for later, so it always returns -1 otherwise.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int64_t, Error> flushPaced() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> readTxTimestamps(std::span<TxTimestamp> timestamps) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<SocketMetrics, Error> metrics() const override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int, Error> getHandle() const override;
+
+        // The receive ring: the multishot recvmsg empties the socket before epoll would see it readable.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int, Error> getReadHandle() const override;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        SpinBudget* spinBudget() noexcept override {
+            return &spin_budget_;
+        }
+
+        void close() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bindAddr, const SocketOptions& options = {});
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const Addr& bindAddr, size_t shards, const SocketOptions& options = {});
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remoteAddr, const SocketOptions& options = {});
+
+        // Takes ownership of `sockfd`, closing it on failure.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<ISocket>, Error> Create(int sockfd, const SocketOptions& options);
+
+    private:
+        static constexpr unsigned kSendEntries = 64;
+        static constexpr unsigned kRecvBuffers = 256; // Must be a power of two
+        static constexpr uint16_t kRecvBufferGroup = 0;
+        static constexpr uint64_t kRecvUserData = 1;
+        static constexpr uint64_t kCancelUserData = 2;
+        static constexpr uint64_t kQueuedSendTag = uint64_t{1} << 32; // user_data of a queued send: tag | slot
+
+        // A queued send's msghdr and everything it points at but the payload, which lives in send_buffers_.
+        // The kernel reads them after sendTo() has returned, so they stay put until the completion is reaped.
+        struct SendSlot {
+            msghdr msg;
+            iovec iov;
+            sockaddr_storage name;
+            size_t length;
+        };
+
+        SocketIoUring() = default;
+
+        // The unrecorded operations behind the public ones, as in SocketUnix.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmitTo(const Addr& addr, const uint8_t* data, size_t length);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmit(const uint8_t* data, size_t length);
+
+        // Copies the datagram into a free slot and queues it; `addr` is null on a connected socket.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> queueSend(const Addr* addr, const uint8_t* data, size_t length);
+
+        // Sends `msg` right away and waits for the result; for datagrams too long for a slot.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmitNow(const msghdr& msg, size_t length);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> transmitBatch(std::span<OutgoingPacket> packets);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> receiveView();
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> receiveInto(ReceivedPacket&& packet);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> receiveBatch(std::span<ReceivedPacket> packets);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> armRecv();
+
+        // Next datagram out of the completion queue, as a view into its provided buffer. The buffer
+        // is lent out through `buffer_id` and must be handed back with recycleBuffer(). Datagrams that
+        // didn't fit are recycled here and reported as Truncated.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> nextRecv(uint16_t& buffer_id);
+
+        void recycleBuffer(uint16_t buffer_id);
+        void recycleHeldBuffer();
+
+        // Cancels the multishot recvmsg and waits for its final completion, after which the kernel
+        // no longer touches our buffers.
+        void cancelRecv();
+
+        // Submits `count` queued sends and collects their results, indexed by SQE user_data.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> submitSends(unsigned count, int* results);
+
+        // Hands every queued send to the kernel in one io_uring_enter(). Sends it refuses outright are
+        // dropped, and their error kept for flushPaced() like any other failed completion.
+        void submitQueued();
+
+        // Collects whatever send completions are already posted, without entering the kernel.
+        void reapSends();
+
+        // Retires the queued send behind `cqe`, keeping the first error for flushPaced().
+        void completeQueued(const io_uring_cqe& cqe);
+
+        std::unique_ptr<SocketUnix> socket_; // Owns the descriptor; also serves the non-ring paths
+        int sockfd_ = -1;
+        size_t max_datagram_size_ = 0;
+        size_t control_size_ = 0; // Room for the control messages rxTimestamps and metrics ask for, in each buffer
+        SocketCounters* counters_ = nullptr; // socket_'s, so sends it makes for us land in the same place
+        CaptureTap* tap_ = nullptr;          // socket_'s, likewise
+        bool truncation_pending_ = false; // Held back by a recvBatch() that returned other datagrams
+
+        std::unique_ptr<IoUringRing> recv_ring_;
+        std::unique_ptr<IoUringRing> send_ring_;
+
+        std::unique_ptr<SendSlot[]> send_slots_;
+        std::unique_ptr<uint8_t[]> send_buffers_; // kSendEntries payloads of max_datagram_size_ bytes
+        std::array<uint8_t, kSendEntries> free_slots_{};
+        unsigned free_count_ = 0;
+        std::array<uint8_t, kSendEntries> queued_slots_{}; // FIFO of slots waiting for submission
+        unsigned queued_head_ = 0;
+        unsigned queued_count_ = 0;
+        unsigned sends_in_flight_ = 0; // Submitted, completion not yet reaped
+        std::optional<Error> send_error_; // First failure among queued sends since the last flushPaced()
+
+        void* buffer_ring_ = nullptr; // Page-aligned io_uring_buf array shared with the kernel
+        size_t buffer_ring_size_ = 0;
+        std::unique_ptr<uint8_t[]> buffers_;
+        size_t buffer_size_ = 0;
+        uint16_t buffer_tail_ = 0;
+        bool buffer_ring_registered_ = false;
+
+        std::unique_ptr<msghdr> recv_msg_; // Template for the multishot recvmsg; must outlive the request
+        bool recv_armed_ = false;
+        int held_buffer_ = -1; // Buffer behind the last recvFrom() view, recycled on the next receive
+        SpinBudget spin_budget_; // What recvFromUntil() has learned about arrival gaps here
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <pulse/net/udp/socket_factory.h>
+#include "io_uring_socket.h"
+
+namespace pulse::net::udp {
+
+    class IoUringSocketFactory : public ISocketFactory {
+    public:
+        using ISocketFactory::listen;
+        using ISocketFactory::dial;
+
+        std::expected<std::unique_ptr<ISocket>, Error> listen(const Addr& bind_addr) override {
+            return SocketIoUring::Listen(bind_addr, {});
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> listenWithOptions(const Addr& bind_addr, const SocketOptions& options) override {
+            return SocketIoUring::Listen(bind_addr, options);
+        }
+
+        std::expected<std::vector<std::unique_ptr<ISocket>>, Error> listenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options = {}) override {
+            return SocketIoUring::ListenSharded(bind_addr, shards, options);
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> dial(const Addr& remote_addr) override {
+            return SocketIoUring::Dial(remote_addr, {});
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> dialWithOptions(const Addr& remote_addr, const SocketOptions& options) override {
+            return SocketIoUring::Dial(remote_addr, options);
+        }
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,900 @@
+#include "pulse/net/udp/udp.h"
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+#include "io_uring_socket.h"
+#include "unix_error_map.h"
+#include "unix_control_messages.h"
+#include "socket_options_check.h"
+
+namespace pulse::net::udp {
+
+    namespace {
+
+        constexpr size_t kRecvNameSize = sizeof(sockaddr_storage);
+
+        // Every provided buffer starts with the kernel's io_uring_recvmsg_out header, followed by the
+        // source address (always kRecvNameSize bytes, however long the address really is), the control
+        // area (the template's msg_controllen, whatever was actually written), then the payload.
+        constexpr size_t kRecvHeaderSize = sizeof(io_uring_recvmsg_out) + kRecvNameSize;
+
+        void prep_sendmsg(io_uring_sqe* sqe, int fd, const msghdr* msg, uint64_t user_data) {
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(msg);
+            sqe->len = 1;
+            sqe->user_data = user_data;
+        }
+
+    } // namespace
+
+    SocketIoUring::~SocketIoUring() {
+        close();
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketIoUring::Create(int sockfd, const SocketOptions& options) {
+        const size_t control_size = recv_control_size(options.rxTimestamps, options.metrics);
+        std::unique_ptr<SocketIoUring> socket;
+        bool adopted = false; // Once a SocketUnix owns the descriptor, it closes it
+        try {
+            auto owner = std::make_unique<SocketUnix>(sockfd, options);
+            adopted = true;
+            socket.reset(new SocketIoUring());
+            socket->socket_ = std::move(owner);
+            socket->recv_msg_ = std::make_unique<msghdr>();
+            socket->buffer_size_ = kRecvHeaderSize + control_size + options.maxDatagramSize;
+            socket->buffers_ = std::make_unique<uint8_t[]>(kRecvBuffers * socket->buffer_size_);
+            socket->send_slots_ = std::make_unique<SendSlot[]>(kSendEntries);
+            socket->send_buffers_ = std::make_unique<uint8_t[]>(kSendEntries * options.maxDatagramSize);
+        } catch (std::bad_alloc& err) {
+            if (!adopted) {
+                ::close(sockfd);
+            }
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        socket->sockfd_ = sockfd;
+        socket->max_datagram_size_ = options.maxDatagramSize;
+        socket->control_size_ = control_size;
+        socket->counters_ = socket->socket_->counters();
+        socket->tap_ = socket->socket_->tap();
+
+        // The receive ring only ever holds the one multishot request, but its completion queue must
+        // absorb a full buffer ring's worth of datagrams between polls.
+        auto recv_ring = IoUringRing::Create(4, kRecvBuffers * 2);
+        if (!recv_ring) {
+            return std::unexpected(recv_ring.error());
+        }
+        socket->recv_ring_ = std::move(*recv_ring);
+
+        auto send_ring = IoUringRing::Create(kSendEntries, kSendEntries * 2);
+        if (!send_ring) {
+            return std::unexpected(send_ring.error());
+        }
+        socket->send_ring_ = std::move(*send_ring);
+        for (unsigned i = 0; i < kSendEntries; ++i) {
+            socket->free_slots_[i] = static_cast<uint8_t>(i);
+        }
+        socket->free_count_ = kSendEntries;
+
+        socket->buffer_ring_size_ = kRecvBuffers * sizeof(io_uring_buf);
+        void* ring = ::mmap(nullptr, socket->buffer_ring_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring == MAP_FAILED) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+        }
+        socket->buffer_ring_ = ring;
+
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(ring);
+        reg.ring_entries = kRecvBuffers;
+        reg.bgid = kRecvBufferGroup;
+        if (int registered = socket->recv_ring_->registerRaw(IORING_REGISTER_PBUF_RING, &reg, 1); registered < 0) {
+            return make_unexpected(ErrorCode::Unsupported, -registered); // Provided buffer rings need 5.19
+        }
+        socket->buffer_ring_registered_ = true;
+
+        for (unsigned i = 0; i < kRecvBuffers; ++i) {
+            socket->recycleBuffer(static_cast<uint16_t>(i));
+        }
+
+        socket->recv_msg_->msg_namelen = kRecvNameSize;
+        socket->recv_msg_->msg_controllen = control_size;
+
+        if (auto armed = socket->armRecv(); !armed) {
+            return std::unexpected(armed.error());
+        }
+
+        // Kernels without multishot recvmsg (before 6.0) reject the request straight away.
+        if (const io_uring_cqe* cqe = socket->recv_ring_->peekCqe(); cqe && cqe->res == -EINVAL) {
+            socket->recv_ring_->advanceCq();
+            socket->recv_armed_ = false;
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        return socket;
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketIoUring::Listen(const Addr& bind_addr, const SocketOptions& options) {
+        if (auto checked = check_socket_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        if (options.pacingRate) {
+            return make_unexpected(ErrorCode::Unsupported, "pacing");
+        }
+        auto sockfd = SocketUnix::OpenBound(bind_addr, options);
+        if (!sockfd) {
+            return std::unexpected(sockfd.error());
+        }
+        return Create(*sockfd, options);
+    }
+
+    std::expected<std::vector<std::unique_ptr<ISocket>>, Error> SocketIoUring::ListenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options) {
+        if (auto checked = check_socket_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        if (options.pacingRate) {
+            return make_unexpected(ErrorCode::Unsupported, "pacing");
+        }
+        auto sockfds = SocketUnix::OpenBoundGroup(bind_addr, shards, options);
+        if (!sockfds) {
+            return std::unexpected(sockfds.error());
+        }
+
+        std::vector<std::unique_ptr<ISocket>> sockets;
+        try {
+            sockets.reserve(sockfds->size());
+        } catch (std::bad_alloc& err) {
+            for (int sockfd : *sockfds) {
+                ::close(sockfd);
+            }
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        // Create() takes ownership of each descriptor, so only the ones not yet handed over need closing.
+        for (size_t i = 0; i < sockfds->size(); ++i) {
+            auto socket = Create((*sockfds)[i], options);
+            if (!socket) {
+                for (size_t j = i + 1; j < sockfds->size(); ++j) {
+                    ::close((*sockfds)[j]);
+                }
+                return std::unexpected(socket.error());
+            }
+            sockets.push_back(std::move(*socket));
+        }
+
+        return sockets;
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketIoUring::Dial(const Addr& remote_addr, const SocketOptions& options) {
+        if (auto checked = check_socket_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        if (options.pacingRate) {
+            return make_unexpected(ErrorCode::Unsupported, "pacing");
+        }
+        auto sockfd = SocketUnix::OpenConnected(remote_addr, options);
+        if (!sockfd) {
+            return std::unexpected(sockfd.error());
+        }
+        return Create(*sockfd, options);
+    }
+
+    std::expected<void, Error> SocketIoUring::armRecv() {
+        io_uring_sqe* sqe = recv_ring_->getSqe();
+        if (!sqe) {
+            return make_unexpected(ErrorCode::RecvFailed);
+        }
+
+        sqe->opcode = IORING_OP_RECVMSG;
+        sqe->fd = sockfd_;
+        sqe->addr = reinterpret_cast<uint64_t>(recv_msg_.get());
+        sqe->len = 1;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kRecvBufferGroup;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->user_data = kRecvUserData;
+
+        int submitted = recv_ring_->submit();
+        if (submitted < 0) {
+            recv_ring_->withdraw(); // Or the next enter arms it behind our back
+            return map_rev_error(-submitted);
+        }
+
+        recv_armed_ = true;
+        return {};
+    }
+
+    std::expected<ReceivedPacket, Error> SocketIoUring::nextRecv(uint16_t& buffer_id) {
+        bool flushed = false;
+        bool rearmed = false;
+
+        while (true) {
+            const io_uring_cqe* cqe = recv_ring_->peekCqe();
+            if (!cqe) {
+                if (!recv_armed_) {
+                    if (rearmed) {
+                        return make_unexpected(ErrorCode::WouldBlock); // Still out of buffers; try again later.
+                    }
+                    rearmed = true;
+                    if (auto armed = armRecv(); !armed) {
+                        return std::unexpected(armed.error());
+                    }
+                    continue;
+                }
+                if (!flushed && recv_ring_->needsFlush()) {
+                    recv_ring_->flush();
+                    flushed = true;
+                    continue;
+                }
+                return make_unexpected(ErrorCode::WouldBlock);
+            }
+
+            const uint64_t user_data = cqe->user_data;
+            const int res = cqe->res;
+            const uint32_t flags = cqe->flags;
+            recv_ring_->advanceCq();
+
+            if (user_data != kRecvUserData) {
+                continue;
+            }
+            if (!(flags & IORING_CQE_F_MORE)) {
+                recv_armed_ = false; // Re-armed on the next empty poll
+            }
+
+            if (res < 0) {
+                if (res == -ENOBUFS || res == -ECANCELED) {
+                    continue; // The kernel ran dry of buffers; we hand them back as we go.
+                }
+                return map_rev_error(-res);
+            }
+            if (!(flags & IORING_CQE_F_BUFFER)) {
+                continue;
+            }
+
+            const auto id = static_cast<uint16_t>(flags >> IORING_CQE_BUFFER_SHIFT);
+            uint8_t* buffer = buffers_.get() + static_cast<size_t>(id) * buffer_size_;
+
+            io_uring_recvmsg_out out;
+            std::memcpy(&out, buffer, sizeof(out));
+            if (out.flags & MSG_TRUNC) {
+                recycleBuffer(id);
+                return make_unexpected(ErrorCode::Truncated);
+            }
+
+            auto addr = Addr::FromSockaddr(buffer + sizeof(out), std::min<size_t>(out.namelen, kRecvNameSize));
+            if (!addr || addr->port() == 0) {
+                recycleBuffer(id);
+                continue;
+            }
+
+            int64_t timestamp_ns = 0;
+            if (control_size_ > 0) {
+                msghdr control{};
+                control.msg_control = buffer + kRecvHeaderSize;
+                control.msg_controllen = std::min<size_t>(out.controllen, control_size_);
+                const RxControl parsed = read_rx_control(control);
+                timestamp_ns = parsed.timestamp_ns;
+                if (parsed.drops != 0 && counters_) {
+                    counters_->recordKernelDrops(parsed.drops);
+                }
+            }
+
+            buffer_id = id;
+            const size_t size = std::min<size_t>(out.payloadlen, max_datagram_size_);
+            return ReceivedPacket{
+                .data = buffer + kRecvHeaderSize + control_size_,
+                .size = size,
+                .capacity = max_datagram_size_,
+                .addr = std::move(*addr),
+                .timestampNs = timestamp_ns,
+            };
+        }
+    }
+
+    void SocketIoUring::recycleBuffer(uint16_t buffer_id) {
+        // Index the entries by hand: in C++ the uapi flexible array member `bufs` is laid out after an
+        // empty struct and ends up 8 bytes off. Entry 0's reserved field aliases the ring tail, so
+        // fill the entry field by field.
+        auto* entries = static_cast<io_uring_buf*>(buffer_ring_);
+        io_uring_buf& entry = entries[buffer_tail_ & (kRecvBuffers - 1)];
+        entry.addr = reinterpret_cast<uint64_t>(buffers_.get() + static_cast<size_t>(buffer_id) * buffer_size_);
+        entry.len = static_cast<uint32_t>(buffer_size_);
+        entry.bid = buffer_id;
+
+        ++buffer_tail_;
+        std::atomic_ref<uint16_t>(static_cast<io_uring_buf_ring*>(buffer_ring_)->tail).store(buffer_tail_, std::memory_order_release);
+    }
+
+    void SocketIoUring::recycleHeldBuffer() {
+        if (held_buffer_ >= 0) {
+            recycleBuffer(static_cast<uint16_t>(held_buffer_));
+            held_buffer_ = -1;
+        }
+    }
+
+    std::expected<ReceivedPacket, Error> SocketIoUring::recvFrom() {
+        auto result = receiveView();
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketIoUring::recvFrom(ReceivedPacket&& packet) {
+        auto result = receiveInto(std::move(packet));
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketIoUring::recvBatch(std::span<ReceivedPacket> packets) {
+        auto result = receiveBatch(packets);
+        if (counters_) {
+            counters_->recordRecvBatch(result, packets);
+        }
+        if (tap_) {
+            tap_->recordRecvBatch(result, packets);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketIoUring::receiveView() {
+        if (!recv_ring_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        submitQueued(); // Replies go out with the next receive, one enter for the lot
+        recycleHeldBuffer();
+        if (std::exchange(truncation_pending_, false)) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+
+        uint16_t buffer_id = 0;
+        auto packet = nextRecv(buffer_id);
+        if (!packet) {
+            return packet;
+        }
+
+        // Zero-copy: the view points into the provided buffer, which we keep until the next receive.
+        held_buffer_ = buffer_id;
+        if (packet->size == 0) {
+            return make_unexpected(ErrorCode::Closed);
+        }
+        return packet;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketIoUring::receiveInto(ReceivedPacket&& packet) {
+        if (packet.data == nullptr || packet.capacity < max_datagram_size_) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        if (!recv_ring_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        submitQueued();
+        recycleHeldBuffer();
+        if (std::exchange(truncation_pending_, false)) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+
+        uint16_t buffer_id = 0;
+        auto received = nextRecv(buffer_id);
+        if (!received) {
+            return std::unexpected(received.error());
+        }
+
+        packet.size = std::min(received->size, packet.capacity);
+        std::memcpy(packet.data, received->data, packet.size);
+        packet.addr = std::move(received->addr);
+        packet.timestampNs = received->timestampNs;
+        recycleBuffer(buffer_id);
+
+        if (packet.size == 0) {
+            return make_unexpected(ErrorCode::Closed); // rare, but possible
+        }
+        return std::move(packet);
+    }
+
+    std::expected<size_t, Error> SocketIoUring::receiveBatch(std::span<ReceivedPacket> packets) {
+        for (const auto& packet : packets) {
+            if (packet.data == nullptr || packet.capacity < max_datagram_size_) {
+                return make_unexpected(ErrorCode::InvalidArgument);
+            }
+        }
+        if (!recv_ring_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        submitQueued();
+        recycleHeldBuffer();
+        if (std::exchange(truncation_pending_, false)) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+
+        size_t received = 0;
+        while (received < packets.size()) {
+            uint16_t buffer_id = 0;
+            auto next = nextRecv(buffer_id);
+            if (!next) {
+                if (received > 0) {
+                    truncation_pending_ = next.error() == ErrorCode::Truncated;
+                    break;
+                }
+                return std::unexpected(next.error());
+            }
+
+            // Zero-length datagrams are dropped, as in SocketUnix::recvBatch.
+            auto& packet = packets[received];
+            if (next->size > 0) {
+                packet.size = std::min(next->size, packet.capacity);
+                std::memcpy(packet.data, next->data, packet.size);
+                packet.addr = std::move(next->addr);
+                packet.timestampNs = next->timestampNs;
+                ++received;
+            }
+            recycleBuffer(buffer_id);
+        }
+
+        return received;
+    }
+
+    std::expected<void, Error> SocketIoUring::submitSends(unsigned count, int* results) {
+        int submitted = send_ring_->submit(count);
+
+        // The SQEs point at msghdrs on the caller's stack, so none may outlive this call. Whatever the
+        // kernel didn't take (EAGAIN, EBUSY, a short submit) is withdrawn and fails with the submission's
+        // error; whatever it took is reaped before returning, so no completion leaks into the next call.
+        const unsigned in_flight = count - send_ring_->withdraw();
+        const int refused = (submitted < 0 && submitted != -EINTR) ? submitted : -EAGAIN;
+        if (in_flight == 0) {
+            return map_send_error(-refused);
+        }
+        for (unsigned i = in_flight; i < count; ++i) {
+            results[i] = refused; // SQEs are consumed in order, and user_data is the index
+        }
+
+        // The wait above normally returns with every completion posted; keep reaping if it was interrupted.
+        unsigned reaped = 0;
+        while (reaped < in_flight) {
+            const io_uring_cqe* cqe = send_ring_->peekCqe();
+            if (!cqe) {
+                int waited = send_ring_->submit(in_flight - reaped);
+                if (waited < 0 && waited != -EINTR && waited != -EAGAIN && waited != -EBUSY) {
+                    // There's no telling when these sends finish now, so retire the ring rather than
+                    // let a later call collect their completions as its own.
+                    send_ring_.reset();
+                    return map_send_error(-waited);
+                }
+                continue;
+            }
+
+            if (cqe->user_data & kQueuedSendTag) {
+                completeQueued(*cqe); // Posted alongside ours; doesn't count towards them
+                send_ring_->advanceCq();
+                continue;
+            }
+            if (cqe->user_data < count) {
+                results[cqe->user_data] = cqe->res;
+            }
+            send_ring_->advanceCq();
+            ++reaped;
+        }
+
+        return {};
+    }
+
+    void SocketIoUring::submitQueued() {
+        if (queued_count_ == 0 || !send_ring_) {
+            return;
+        }
+
+        // The queue never holds more than the SQ does, and the SQ is empty between calls.
+        for (unsigned i = 0; i < queued_count_; ++i) {
+            const uint8_t slot = queued_slots_[(queued_head_ + i) % kSendEntries];
+            io_uring_sqe* sqe = send_ring_->getSqe();
+            prep_sendmsg(sqe, sockfd_, &send_slots_[slot].msg, kQueuedSendTag | slot);
+            sqe->msg_flags = MSG_DONTWAIT;
+        }
+
+        const int submitted = send_ring_->submit();
+        const unsigned taken = queued_count_ - send_ring_->withdraw();
+        queued_head_ = (queued_head_ + taken) % kSendEntries;
+        queued_count_ -= taken;
+        sends_in_flight_ += taken;
+
+        // A transient refusal leaves the rest queued for the next pass; anything else drops them.
+        if (queued_count_ > 0 && submitted < 0 && submitted != -EINTR && submitted != -EAGAIN && submitted != -EBUSY) {
+            if (!send_error_) {
+                send_error_ = map_send_error(-submitted).error();
+            }
+            for (; queued_count_ > 0; --queued_count_) {
+                free_slots_[free_count_++] = queued_slots_[queued_head_];
+                queued_head_ = (queued_head_ + 1) % kSendEntries;
+            }
+        }
+
+        reapSends();
+    }
+
+    void SocketIoUring::reapSends() {
+        while (sends_in_flight_ > 0) {
+            const io_uring_cqe* cqe = send_ring_->peekCqe();
+            if (!cqe) {
+                return;
+            }
+            if (cqe->user_data & kQueuedSendTag) {
+                completeQueued(*cqe);
+            }
+            send_ring_->advanceCq();
+        }
+    }
+
+    void SocketIoUring::completeQueued(const io_uring_cqe& cqe) {
+        const auto slot = static_cast<uint8_t>(cqe.user_data & ~kQueuedSendTag);
+        if (!send_error_) {
+            if (cqe.res < 0) {
+                send_error_ = map_send_error(-cqe.res).error();
+            } else if (static_cast<size_t>(cqe.res) != send_slots_[slot].length) {
+                send_error_ = Error(ErrorCode::PartialSend);
+            }
+        }
+        free_slots_[free_count_++] = slot;
+        --sends_in_flight_;
+    }
+
+    std::expected<void, Error> SocketIoUring::sendTo(const Addr& addr, const uint8_t* data, size_t length) {
+        auto result = transmitTo(addr, data, length);
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, addr, data, length);
+        }
+        return result;
+    }
+
+    std::expected<void, Error> SocketIoUring::send(const uint8_t* data, size_t length) {
+        auto result = transmit(data, length);
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, data, length);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketIoUring::sendBatch(std::span<OutgoingPacket> packets) {
+        auto result = transmitBatch(packets);
+        if (counters_) {
+            counters_->recordSendBatch(packets);
+        }
+        if (tap_) {
+            tap_->recordSendBatch(packets);
+        }
+        return result;
+    }
+
+    std::expected<void, Error> SocketIoUring::transmitTo(const Addr& addr, const uint8_t* data, size_t length) {
+        if (!send_ring_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        if (length <= max_datagram_size_) {
+            return queueSend(&addr, data, length);
+        }
+
+        iovec iov{ .iov_base = const_cast<uint8_t*>(data), .iov_len = length };
+        msghdr msg{};
+        msg.msg_name = const_cast<void*>(addr.sockaddrData());
+        msg.msg_namelen = static_cast<socklen_t>(addr.sockaddrLen());
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        return transmitNow(msg, length);
+    }
+
+    std::expected<void, Error> SocketIoUring::transmit(const uint8_t* data, size_t length) {
+        if (!send_ring_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        if (length <= max_datagram_size_) {
+            return queueSend(nullptr, data, length);
+        }
+
+        iovec iov{ .iov_base = const_cast<uint8_t*>(data), .iov_len = length };
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        return transmitNow(msg, length);
+    }
+
+    std::expected<void, Error> SocketIoUring::queueSend(const Addr* addr, const uint8_t* data, size_t length) {
+        if (free_count_ == 0) {
+            reapSends();
+        }
+        if (free_count_ == 0) {
+            return make_unexpected(ErrorCode::WouldBlock); // Every slot is still with the kernel
+        }
+
+        const uint8_t slot = free_slots_[--free_count_];
+        SendSlot& entry = send_slots_[slot];
+        uint8_t* payload = send_buffers_.get() + static_cast<size_t>(slot) * max_datagram_size_;
+        std::memcpy(payload, data, length);
+
+        entry.iov = iovec{ .iov_base = payload, .iov_len = length };
+        entry.msg = msghdr{};
+        entry.msg.msg_iov = &entry.iov;
+        entry.msg.msg_iovlen = 1;
+        if (addr) {
+            std::memcpy(&entry.name, addr->sockaddrData(), addr->sockaddrLen());
+            entry.msg.msg_name = &entry.name;
+            entry.msg.msg_namelen = static_cast<socklen_t>(addr->sockaddrLen());
+        }
+        entry.length = length;
+
+        queued_slots_[(queued_head_ + queued_count_) % kSendEntries] = slot;
+        ++queued_count_;
+        if (free_count_ == 0) {
+            submitQueued(); // Out of slots: this is as big as the batch gets
+        }
+        return {};
+    }
+
+    std::expected<void, Error> SocketIoUring::transmitNow(const msghdr& msg, size_t length) {
+        submitQueued(); // Keep the datagrams in the order they were sent
+
+        io_uring_sqe* sqe = send_ring_->getSqe();
+        if (!sqe) {
+            return make_unexpected(ErrorCode::SendFailed);
+        }
+        prep_sendmsg(sqe, sockfd_, &msg, 0);
+        sqe->msg_flags = MSG_DONTWAIT;
+
+        int result = 0;
+        if (auto submitted = submitSends(1, &result); !submitted) {
+            return submitted;
+        }
+
+        if (result < 0) {
+            return map_send_error(-result);
+        }
+        if (result != static_cast<int>(length)) {
+            return make_unexpected(ErrorCode::PartialSend);
+        }
+        return {};
+    }
+
+    std::expected<size_t, Error> SocketIoUring::transmitBatch(std::span<OutgoingPacket> packets) {
+        if (!send_ring_) {
+            for (auto& packet : packets) {
+                packet.result = make_unexpected(ErrorCode::InvalidSocket);
+            }
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+
+        submitQueued(); // Ahead of the batch, and out of its way in the SQ
+
+        size_t sent = 0;
+        size_t next = 0;
+
+        while (next < packets.size()) {
+            const size_t chunk = std::min<size_t>(packets.size() - next, kSendEntries);
+
+            msghdr msgs[kSendEntries];
+            iovec iovs[kSendEntries];
+            int results[kSendEntries];
+
+            // Linked SQEs run in order and the chain stops at the first failure, which gives us the
+            // same "everything up to the failed entry" contract as sendmmsg for one io_uring_enter().
+            bool queued = true;
+            for (size_t i = 0; i < chunk && queued; ++i) {
+                auto& packet = packets[next + i];
+                iovs[i] = iovec{ .iov_base = const_cast<uint8_t*>(packet.data), .iov_len = packet.size };
+                msgs[i] = msghdr{};
+                msgs[i].msg_name = const_cast<void*>(packet.addr.sockaddrData());
+                msgs[i].msg_namelen = static_cast<socklen_t>(packet.addr.sockaddrLen());
+                msgs[i].msg_iov = &iovs[i];
+                msgs[i].msg_iovlen = 1;
+
+                io_uring_sqe* sqe = send_ring_->getSqe();
+                if (!sqe) {
+                    send_ring_->withdraw(); // Drop the partial chain; nothing was submitted
+                    queued = false;
+                    continue;
+                }
+                prep_sendmsg(sqe, sockfd_, &msgs[i], i);
+                sqe->msg_flags = MSG_DONTWAIT;
+                if (i + 1 < chunk) {
+                    sqe->flags = IOSQE_IO_LINK;
+                }
+            }
+
+            std::expected<void, Error> submitted = queued
+                ? submitSends(static_cast<unsigned>(chunk), results)
+                : std::expected<void, Error>(make_unexpected(ErrorCode::SendFailed));
+            if (!submitted) {
+                for (; next < packets.size(); ++next) {
+                    packets[next].result = std::unexpected(submitted.error());
+                }
+                if (sent == 0) {
+                    return std::unexpected(submitted.error());
+                }
+                break;
+            }
+
+            size_t done = 0;
+            for (; done < chunk && results[done] >= 0; ++done) {
+                auto& packet = packets[next + done];
+                if (static_cast<size_t>(results[done]) != packet.size) {
+                    packet.result = make_unexpected(ErrorCode::PartialSend);
+                } else {
+                    packet.result = {};
+                    ++sent;
+                }
+            }
+            next += done;
+            if (done == chunk) {
+                continue;
+            }
+
+            // results[done] broke the chain; the entries after it were cancelled and go out next round.
+            auto error = map_send_error(-results[done]);
+
+            if (error.error() == ErrorCode::InvalidSocket) {
+                for (; next < packets.size(); ++next) {
+                    packets[next].result = error;
+                }
+                if (sent == 0) {
+                    return error;
+                }
+                break;
+            }
+
+            if (error.error() == ErrorCode::WouldBlock) {
+                for (; next < packets.size(); ++next) {
+                    packets[next].result = error;
+                }
+                break;
+            }
+
+            // Anything else (unreachable peer, oversized payload, ...) only affects this packet.
+            packets[next++].result = error;
+        }
+
+        return sent;
+    }
+
+    std::expected<size_t, Error> SocketIoUring::sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        if (!socket_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        // A GSO send already amortizes the syscall over up to 64 datagrams; going through the ring
+        // would buy nothing, so share the plain socket's implementation and its fallback.
+        submitQueued();
+        return socket_->sendSegmented(addr, data, length, segment_size);
+    }
+
+    std::expected<int64_t, Error> SocketIoUring::flushPaced() {
+        if (!send_ring_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        submitQueued();
+        if (send_error_) {
+            return std::unexpected(*std::exchange(send_error_, std::nullopt));
+        }
+        return -1;
+    }
+
+    std::expected<size_t, Error> SocketIoUring::readTxTimestamps(std::span<TxTimestamp> timestamps) {
+        if (!socket_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        // Ring sends go through the same socket, so their stamps land on its error queue.
+        submitQueued();
+        return socket_->readTxTimestamps(timestamps);
+    }
+
+    std::expected<SocketMetrics, Error> SocketIoUring::metrics() const {
+        if (!socket_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        return socket_->metrics();
+    }
+
+    std::expected<int, Error> SocketIoUring::getHandle() const {
+        if (!socket_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        return socket_->getHandle();
+    }
+
+    std::expected<int, Error> SocketIoUring::getReadHandle() const {
+        if (!recv_ring_) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        return recv_ring_->fd();
+    }
+
+    void SocketIoUring::cancelRecv() {
+        io_uring_sqe* sqe = recv_ring_->getSqe();
+        if (!sqe) {
+            return;
+        }
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = -1;
+        sqe->addr = kRecvUserData;
+        sqe->user_data = kCancelUserData;
+
+        if (recv_ring_->submit() < 0) {
+            return;
+        }
+
+        while (recv_armed_) {
+            const io_uring_cqe* cqe = recv_ring_->peekCqe();
+            if (!cqe) {
+                int waited = recv_ring_->submit(1);
+                if (waited < 0 && waited != -EINTR) {
+                    return;
+                }
+                continue;
+            }
+            if (cqe->user_data == kRecvUserData && !(cqe->flags & IORING_CQE_F_MORE)) {
+                recv_armed_ = false;
+            }
+            recv_ring_->advanceCq();
+        }
+    }
+
+    void SocketIoUring::close() {
+        if (recv_ring_) {
+            if (recv_armed_) {
+                cancelRecv();
+            }
+            if (buffer_ring_registered_) {
+                io_uring_buf_reg reg{};
+                reg.bgid = kRecvBufferGroup;
+                recv_ring_->registerRaw(IORING_UNREGISTER_PBUF_RING, &reg, 1);
+                buffer_ring_registered_ = false;
+            }
+        }
+
+        if (send_ring_) {
+            // Queued sends were reported as sent, so they go out; the kernel reads their slots until
+            // each completes.
+            submitQueued();
+            while (sends_in_flight_ > 0) {
+                int waited = send_ring_->submit(sends_in_flight_);
+                if (waited < 0 && waited != -EINTR) {
+                    break;
+                }
+                reapSends();
+            }
+        }
+
+        recv_ring_.reset();
+        send_ring_.reset();
+        queued_count_ = 0;
+        sends_in_flight_ = 0;
+
+        if (buffer_ring_) {
+            ::munmap(buffer_ring_, buffer_ring_size_);
+            buffer_ring_ = nullptr;
+        }
+        held_buffer_ = -1;
+
+        if (socket_) {
+            socket_->close();
+        }
+        sockfd_ = -1;
+    }
+
+} // namespace pulse::net::udp
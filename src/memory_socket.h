@@ -0,0 +1,207 @@
+#pragma once
+
+#include <pulse/net/udp/memory_network.h>
+#include <pulse/net/udp/packet_pool.h>
+#include <pulse/net/udp/peer_table.h>
+#include <pulse/net/udp/ring.h>
+#include <pulse/net/udp/udp.h>
+
+#include "capture_tap.h"
+#include "socket_counters.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    // A datagram on its way to an endpoint. The buffer comes from the receiver's pool, so whatever is
+    // in flight to an endpoint is bounded by its queueCapacity.
+    struct MemoryDatagram {
+        PooledPacket packet; // Payload and the sender's address
+        int64_t due_ns = 0;  // Network time at which it can be received
+        uint64_t sequence = 0; // Arrival order at the receiver, to break ties between equal due times
+        bool truncated = false; // Longer than the receiver's maxDatagramSize; nothing was copied
+    };
+
+    // One bound socket's half of the network: its queue and its share of the counters.
+    struct MemoryEndpoint {
+        Addr bound;  // The address it was registered under, possibly a wildcard
+        Addr source; // What receivers see as the sender; loopback in place of a wildcard
+        uint64_t random_seed = 0;
+
+        // Declared before the inbox so datagrams still queued go back to the pool before it goes away.
+        std::unique_ptr<PacketPool> pool;
+        std::unique_ptr<MpmcRing<MemoryDatagram>> inbox;
+
+        // Written by the sending socket.
+        struct alignas(64) SendCounters {
+            std::atomic<uint64_t> sent{0};
+            std::atomic<uint64_t> lost{0};
+            std::atomic<uint64_t> duplicated{0};
+            std::atomic<uint64_t> reordered{0};
+            std::atomic<uint64_t> unreachable{0};
+        };
+        SendCounters tx;
+        // Written by the receiving socket, and by every sender that finds the queue full.
+        alignas(64) std::atomic<uint64_t> delivered{0};
+        alignas(64) std::atomic<uint64_t> overflowed{0};
+    };
+
+    // Everything registered under one address: one endpoint, or a sharded group. Never modified once
+    // published; a change publishes a replacement and marks this one stale, so senders can cache it.
+    struct MemoryBinding {
+        std::vector<std::shared_ptr<MemoryEndpoint>> endpoints;
+        std::atomic<bool> stale{false};
+    };
+
+    // The state behind a MemoryNetwork, shared with every socket it creates.
+    class MemoryFabric {
+    public:
+        explicit MemoryFabric(const MemoryNetworkOptions& options);
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        const MemoryNetworkOptions& options() const noexcept { return options_; }
+
+        // Whether any datagram can be held back at all; without latency, jitter or a bandwidth cap
+        // everything is due at once and nobody needs to read the clock.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        bool timed() const noexcept { return timed_; }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        int64_t now() const noexcept {
+            if (options_.manualClock) {
+                return manual_now_.load(std::memory_order_acquire);
+            }
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count();
+        }
+
+        void advance(int64_t nanoseconds) noexcept {
+            if (options_.manualClock && nanoseconds > 0) {
+                manual_now_.fetch_add(nanoseconds, std::memory_order_acq_rel);
+            }
+        }
+
+        // Registers `count` endpoints under `addr`; port 0 picks a free one. BindFailed if it's taken.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<std::vector<std::shared_ptr<MemoryEndpoint>>, Error> bind(const Addr& addr, size_t count, const SocketOptions& options);
+
+        // What a datagram to `addr` reaches: an exact match, else a wildcard on the same port. Null if nothing.
+        [[nodiscard("Why look up a route and then ignore it?")]]
+        std::shared_ptr<MemoryBinding> resolve(const Addr& addr) const;
+
+        // Takes the endpoint out of routing and folds its counters into the network's totals.
+        void unbind(const std::shared_ptr<MemoryEndpoint>& endpoint) noexcept;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        MemoryNetworkStats stats() const noexcept;
+
+    private:
+        static void add(MemoryNetworkStats& stats, const MemoryEndpoint& endpoint) noexcept;
+
+        MemoryNetworkOptions options_;
+        bool timed_;
+        std::chrono::steady_clock::time_point start_;
+        std::atomic<int64_t> manual_now_{0};
+
+        mutable std::mutex mutex_;
+        std::unordered_map<Addr, std::shared_ptr<MemoryBinding>> bindings_;
+        std::vector<MemoryEndpoint*> live_;
+        MemoryNetworkStats retired_;
+        uint64_t next_endpoint_ = 0;
+        uint16_t next_port_ = 49152;
+    };
+
+    class SocketMemory final : public ISocket {
+    public:
+        SocketMemory(std::shared_ptr<MemoryFabric> fabric, std::shared_ptr<MemoryEndpoint> endpoint, const SocketOptions& options, std::optional<Addr> peer);
+        ~SocketMemory() override {
+            close();
+        }
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> sendTo(const Addr& addr, const uint8_t* data, size_t length) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> send(const uint8_t* data, size_t length) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendBatch(std::span<OutgoingPacket> packets) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segmentSize) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFrom() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFrom(ReceivedPacket&& packet) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatch(std::span<ReceivedPacket> packets) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<SocketMetrics, Error> metrics() const override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int, Error> getHandle() const override;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        SpinBudget* spinBudget() noexcept override {
+            return &spin_budget_;
+        }
+
+        void close() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const std::shared_ptr<MemoryFabric>& fabric, const Addr& bindAddr, const SocketOptions& options);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const std::shared_ptr<MemoryFabric>& fabric, const Addr& bindAddr, size_t shards, const SocketOptions& options);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const std::shared_ptr<MemoryFabric>& fabric, const Addr& remoteAddr, const SocketOptions& options);
+
+    private:
+        // Unrecorded versions of the public calls; those add the outcome to counters_.
+        std::expected<void, Error> transmit(const Addr& addr, const uint8_t* data, size_t length);
+        std::expected<size_t, Error> transmitBatch(std::span<OutgoingPacket> packets);
+        std::expected<size_t, Error> transmitSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size);
+        std::expected<ReceivedPacket, Error> receive(ReceivedPacket* into);
+        std::expected<size_t, Error> receiveBatch(std::span<ReceivedPacket> packets);
+
+        std::expected<MemoryBinding*, Error> route(const Addr& addr);
+        void deliver(MemoryEndpoint& to, int64_t due_ns, const uint8_t* data, size_t length) noexcept;
+        uint64_t random() noexcept;
+        bool chance(double rate) noexcept;
+
+        // The next datagram that is due and meant for this socket, if any.
+        std::optional<MemoryDatagram> next(int64_t now_ns) noexcept;
+        void hold(MemoryDatagram&& datagram) noexcept;
+
+        std::shared_ptr<MemoryFabric> fabric_;
+        std::shared_ptr<MemoryEndpoint> endpoint_;
+        std::atomic<bool> closed_{false};
+        size_t max_datagram_size_;
+        std::optional<Addr> peer_; // Set by dial(); receives only accept datagrams from it
+        std::unique_ptr<SocketCounters> counters_;
+        std::unique_ptr<CaptureTap> tap_;
+
+        // Sending side.
+        uint64_t random_state_;
+        int64_t link_free_ns_ = 0; // When the bandwidth cap lets the next datagram leave
+        PeerTable<std::shared_ptr<MemoryBinding>> routes_;
+
+        // Receiving side. Declared after endpoint_ so these buffers go back to its pool first.
+        std::vector<MemoryDatagram> held_; // Min-heap on due time, of datagrams taken off the inbox early
+        uint64_t arrivals_ = 0;
+        PooledPacket current_; // Backs the packet recvFrom() returned last
+        bool truncated_pending_ = false; // recvBatch() stopped at an oversized datagram; report it next
+        SpinBudget spin_budget_; // What recvFromUntil() has learned about arrival gaps here
+    };
+
+} // namespace pulse::net::udp
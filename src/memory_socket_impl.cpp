@@ -0,0 +1,658 @@
+#include "memory_socket.h"
+#include "socket_options_check.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <string>
+#include <utility>
+
+namespace pulse::net::udp {
+
+    namespace {
+        constexpr uint16_t kFirstEphemeralPort = 49152;
+
+        // SplitMix64: one add and a few multiplies per number, and any seed is a good one.
+        uint64_t mix(uint64_t& state) noexcept {
+            uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+            return z ^ (z >> 31);
+        }
+
+        bool is_rate(double rate) noexcept {
+            return rate >= 0.0 && rate <= 1.0;
+        }
+
+        bool is_wildcard(const Addr& addr) {
+            const std::string ip = addr.ip();
+            return ip == Addr::kAnyIPv4 || ip == Addr::kAnyIPv6;
+        }
+
+        std::expected<Addr, Error> loopback(const Addr& like, uint16_t port) {
+            return Addr::Create(like.isIPv6() ? "::1" : "127.0.0.1", port);
+        }
+
+        std::expected<void, Error> check_memory_options(const SocketOptions& options) {
+            if (auto checked = check_socket_options(options); !checked) {
+                return checked;
+            }
+            if (options.pacingRate) {
+                return make_unexpected(ErrorCode::Unsupported, "pacing");
+            }
+            if (options.rxTimestamps || options.txTimestamps) {
+                return make_unexpected(ErrorCode::Unsupported, "timestamps");
+            }
+            return {};
+        }
+
+        bool later(const MemoryDatagram& a, const MemoryDatagram& b) noexcept {
+            return a.due_ns != b.due_ns ? a.due_ns > b.due_ns : a.sequence > b.sequence;
+        }
+    }
+
+    MemoryFabric::MemoryFabric(const MemoryNetworkOptions& options)
+        : options_(options),
+          timed_(options.latencyNs > 0 || options.jitterNs > 0 || options.bandwidth > 0),
+          start_(std::chrono::steady_clock::now()) {}
+
+    std::expected<std::vector<std::shared_ptr<MemoryEndpoint>>, Error> MemoryFabric::bind(const Addr& addr, size_t count, const SocketOptions& options) {
+        std::vector<std::shared_ptr<MemoryEndpoint>> endpoints;
+        try {
+            endpoints.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                auto endpoint = std::make_shared<MemoryEndpoint>();
+                auto pool = PacketPool::Create(PacketPoolOptions{ .bufferSize = options.maxDatagramSize, .bufferCount = options_.queueCapacity });
+                if (!pool) {
+                    return std::unexpected(pool.error());
+                }
+                endpoint->pool = std::move(*pool);
+                endpoint->inbox = std::make_unique<MpmcRing<MemoryDatagram>>(options_.queueCapacity);
+                endpoints.push_back(std::move(endpoint));
+            }
+            const std::string ip = addr.ip();
+            const bool wildcard = is_wildcard(addr);
+            auto binding = std::make_shared<MemoryBinding>();
+            binding->endpoints = endpoints;
+
+            std::lock_guard lock(mutex_);
+            Addr bound = addr;
+            if (addr.port() == 0) {
+                bool found = false;
+                for (size_t tries = 0; tries <= 65535 - kFirstEphemeralPort && !found; ++tries) {
+                    const uint16_t port = next_port_;
+                    next_port_ = next_port_ == 65535 ? kFirstEphemeralPort : static_cast<uint16_t>(next_port_ + 1);
+                    auto candidate = Addr::Create(ip, port);
+                    if (!candidate) {
+                        return std::unexpected(candidate.error());
+                    }
+                    if (!bindings_.contains(*candidate)) {
+                        bound = *candidate;
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    return make_unexpected(ErrorCode::BindFailed, "no free ephemeral port");
+                }
+            } else if (bindings_.contains(addr)) {
+                return make_unexpected(ErrorCode::BindFailed, "address already in use");
+            }
+
+            auto source = wildcard ? loopback(bound, bound.port()) : std::expected<Addr, Error>(bound);
+            if (!source) {
+                return std::unexpected(source.error());
+            }
+            live_.reserve(live_.size() + count);
+            bindings_.emplace(bound, std::move(binding));
+            for (auto& endpoint : endpoints) {
+                endpoint->bound = bound;
+                endpoint->source = *source;
+                endpoint->random_seed = options_.seed ^ (++next_endpoint_ * 0xD1B54A32D192ED03ull);
+                live_.push_back(endpoint.get());
+            }
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        return endpoints;
+    }
+
+    std::shared_ptr<MemoryBinding> MemoryFabric::resolve(const Addr& addr) const {
+        auto wildcard = Addr::Create(addr.isIPv6() ? Addr::kAnyIPv6 : Addr::kAnyIPv4, addr.port());
+        std::lock_guard lock(mutex_);
+        if (auto it = bindings_.find(addr); it != bindings_.end()) {
+            return it->second;
+        }
+        if (wildcard) {
+            if (auto it = bindings_.find(*wildcard); it != bindings_.end()) {
+                return it->second;
+            }
+        }
+        return nullptr;
+    }
+
+    void MemoryFabric::unbind(const std::shared_ptr<MemoryEndpoint>& endpoint) noexcept {
+        std::lock_guard lock(mutex_);
+        add(retired_, *endpoint);
+        std::erase(live_, endpoint.get());
+
+        auto it = bindings_.find(endpoint->bound);
+        if (it == bindings_.end()) {
+            return;
+        }
+        it->second->stale.store(true, std::memory_order_release);
+        if (it->second->endpoints.size() == 1) {
+            bindings_.erase(it);
+            return;
+        }
+        try {
+            auto remaining = std::make_shared<MemoryBinding>();
+            for (const auto& other : it->second->endpoints) {
+                if (other != endpoint) {
+                    remaining->endpoints.push_back(other);
+                }
+            }
+            it->second = std::move(remaining);
+        } catch (std::bad_alloc&) {
+            bindings_.erase(it); // Without memory for a smaller group, the rest of it stops receiving.
+        }
+    }
+
+    void MemoryFabric::add(MemoryNetworkStats& stats, const MemoryEndpoint& endpoint) noexcept {
+        stats.sent += endpoint.tx.sent.load(std::memory_order_relaxed);
+        stats.lost += endpoint.tx.lost.load(std::memory_order_relaxed);
+        stats.duplicated += endpoint.tx.duplicated.load(std::memory_order_relaxed);
+        stats.reordered += endpoint.tx.reordered.load(std::memory_order_relaxed);
+        stats.unreachable += endpoint.tx.unreachable.load(std::memory_order_relaxed);
+        stats.delivered += endpoint.delivered.load(std::memory_order_relaxed);
+        stats.overflowed += endpoint.overflowed.load(std::memory_order_relaxed);
+    }
+
+    MemoryNetworkStats MemoryFabric::stats() const noexcept {
+        std::lock_guard lock(mutex_);
+        MemoryNetworkStats stats = retired_;
+        for (const MemoryEndpoint* endpoint : live_) {
+            add(stats, *endpoint);
+        }
+        return stats;
+    }
+
+    SocketMemory::SocketMemory(std::shared_ptr<MemoryFabric> fabric, std::shared_ptr<MemoryEndpoint> endpoint, const SocketOptions& options, std::optional<Addr> peer)
+        : fabric_(std::move(fabric)),
+          endpoint_(std::move(endpoint)),
+          max_datagram_size_(options.maxDatagramSize),
+          peer_(peer),
+          random_state_(endpoint_->random_seed) {
+        if (options.metrics) {
+            counters_ = std::make_unique<SocketCounters>();
+        }
+        if (options.capture) {
+            tap_ = std::make_unique<CaptureTap>(options.capture, endpoint_->source, peer_);
+        }
+        held_.reserve(fabric_->options().queueCapacity);
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketMemory::Listen(const std::shared_ptr<MemoryFabric>& fabric, const Addr& bind_addr, const SocketOptions& options) {
+        if (auto checked = check_memory_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        auto endpoints = fabric->bind(bind_addr, 1, options);
+        if (!endpoints) {
+            return std::unexpected(endpoints.error());
+        }
+        try {
+            return std::make_unique<SocketMemory>(fabric, endpoints->front(), options, std::nullopt);
+        } catch (std::bad_alloc& err) {
+            fabric->unbind(endpoints->front());
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+    }
+
+    std::expected<std::vector<std::unique_ptr<ISocket>>, Error> SocketMemory::ListenSharded(const std::shared_ptr<MemoryFabric>& fabric, const Addr& bind_addr, size_t shards, const SocketOptions& options) {
+        if (shards == 0) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        if (auto checked = check_memory_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        auto endpoints = fabric->bind(bind_addr, shards, options);
+        if (!endpoints) {
+            return std::unexpected(endpoints.error());
+        }
+
+        // Sockets unbind their own endpoint when they go away, so only the ones not yet handed over need it.
+        std::vector<std::unique_ptr<ISocket>> sockets;
+        size_t created = 0;
+        try {
+            sockets.reserve(shards);
+            for (; created < shards; ++created) {
+                sockets.push_back(std::make_unique<SocketMemory>(fabric, (*endpoints)[created], options, std::nullopt));
+            }
+        } catch (std::bad_alloc& err) {
+            for (size_t i = created; i < shards; ++i) {
+                fabric->unbind((*endpoints)[i]);
+            }
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        return sockets;
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketMemory::Dial(const std::shared_ptr<MemoryFabric>& fabric, const Addr& remote_addr, const SocketOptions& options) {
+        if (auto checked = check_memory_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        auto local = loopback(remote_addr, 0);
+        if (!local) {
+            return std::unexpected(local.error());
+        }
+        auto endpoints = fabric->bind(*local, 1, options);
+        if (!endpoints) {
+            return std::unexpected(endpoints.error());
+        }
+        try {
+            return std::make_unique<SocketMemory>(fabric, endpoints->front(), options, remote_addr);
+        } catch (std::bad_alloc& err) {
+            fabric->unbind(endpoints->front());
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+    }
+
+    std::expected<void, Error> SocketMemory::sendTo(const Addr& addr, const uint8_t* data, size_t length) {
+        auto result = transmit(addr, data, length);
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, addr, data, length);
+        }
+        return result;
+    }
+
+    std::expected<void, Error> SocketMemory::send(const uint8_t* data, size_t length) {
+        std::expected<void, Error> result = make_unexpected(ErrorCode::SendFailed, "socket is not connected");
+        if (peer_) {
+            result = transmit(*peer_, data, length);
+        }
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, data, length);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketMemory::sendBatch(std::span<OutgoingPacket> packets) {
+        auto result = transmitBatch(packets);
+        if (counters_) {
+            counters_->recordSendBatch(packets);
+        }
+        if (tap_) {
+            tap_->recordSendBatch(packets);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketMemory::sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        auto result = transmitSegmented(addr, data, length, segment_size);
+        if (counters_) {
+            counters_->recordSendSegmented(result, length, segment_size);
+        }
+        if (tap_) {
+            tap_->recordSendSegmented(result, addr, data, length, segment_size);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketMemory::recvFrom() {
+        auto result = receive(nullptr);
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketMemory::recvFrom(ReceivedPacket&& packet) {
+        auto result = receive(&packet);
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketMemory::recvBatch(std::span<ReceivedPacket> packets) {
+        auto result = receiveBatch(packets);
+        if (counters_) {
+            counters_->recordRecvBatch(result, packets);
+        }
+        if (tap_) {
+            tap_->recordRecvBatch(result, packets);
+        }
+        return result;
+    }
+
+    std::expected<SocketMetrics, Error> SocketMemory::metrics() const {
+        if (!counters_) {
+            return make_unexpected(ErrorCode::InvalidArgument, "metrics not enabled in SocketOptions");
+        }
+        SocketMetrics metrics = counters_->snapshot();
+        metrics.kernelDrops = endpoint_->overflowed.load(std::memory_order_relaxed); // The emulated receive queue's
+        return metrics;
+    }
+
+    std::expected<int, Error> SocketMemory::getHandle() const {
+        return make_unexpected(ErrorCode::Unsupported, "in-memory sockets have no descriptor");
+    }
+
+    void SocketMemory::close() {
+        if (!closed_.exchange(true, std::memory_order_acq_rel)) {
+            fabric_->unbind(endpoint_);
+        }
+    }
+
+    uint64_t SocketMemory::random() noexcept {
+        return mix(random_state_);
+    }
+
+    bool SocketMemory::chance(double rate) noexcept {
+        return rate > 0.0 && static_cast<double>(random() >> 11) * 0x1.0p-53 < rate;
+    }
+
+    std::expected<MemoryBinding*, Error> SocketMemory::route(const Addr& addr) {
+        if (auto handle = routes_.find(addr)) {
+            auto& cached = *routes_.get(handle);
+            if (!cached->stale.load(std::memory_order_acquire)) {
+                return cached.get();
+            }
+            routes_.erase(handle);
+        }
+        auto binding = fabric_->resolve(addr);
+        if (!binding) {
+            return nullptr; // Not cached, so a socket bound there later is found.
+        }
+        try {
+            const auto handle = routes_.tryEmplace(addr, std::move(binding)).first;
+            return routes_.get(handle)->get();
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SendFailed, err);
+        }
+    }
+
+    void SocketMemory::deliver(MemoryEndpoint& to, int64_t due_ns, const uint8_t* data, size_t length) noexcept {
+        auto packet = to.pool->acquire();
+        if (!packet) {
+            to.overflowed.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        MemoryDatagram datagram{ .packet = std::move(*packet), .due_ns = due_ns };
+        if (length <= datagram.packet.capacity()) {
+            std::memcpy(datagram.packet.data(), data, length);
+            datagram.packet.setSize(length);
+        } else {
+            datagram.truncated = true;
+        }
+        datagram.packet.setAddr(endpoint_->source);
+        if (!to.inbox->tryPush(std::move(datagram))) {
+            to.overflowed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    std::expected<void, Error> SocketMemory::transmit(const Addr& addr, const uint8_t* data, size_t length) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        if (data == nullptr && length > 0) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        if (length > kMaxDatagramSize) {
+            return make_unexpected(ErrorCode::SendFailed, "datagram longer than 65507 bytes");
+        }
+        auto binding = route(addr);
+        if (!binding) {
+            return std::unexpected(binding.error());
+        }
+
+        auto& tx = endpoint_->tx;
+        tx.sent.fetch_add(1, std::memory_order_relaxed);
+        if (*binding == nullptr) {
+            tx.unreachable.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+        const auto& endpoints = (*binding)->endpoints;
+        MemoryEndpoint& to = *endpoints[endpoints.size() == 1 ? 0 : endpoint_->source.hash() % endpoints.size()];
+
+        const MemoryNetworkOptions& options = fabric_->options();
+        if (chance(options.lossRate)) {
+            tx.lost.fetch_add(1, std::memory_order_relaxed);
+            return {};
+        }
+        int64_t due_ns = 0;
+        if (fabric_->timed()) {
+            due_ns = fabric_->now();
+            if (options.bandwidth > 0) {
+                due_ns = std::max(due_ns, link_free_ns_);
+                link_free_ns_ = due_ns + static_cast<int64_t>(static_cast<double>(length) * 1e9 / static_cast<double>(options.bandwidth));
+            }
+            if (chance(options.reorderRate)) {
+                tx.reordered.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                int64_t delay = options.latencyNs;
+                if (options.jitterNs > 0) {
+                    const auto span = static_cast<uint64_t>(options.jitterNs) * 2 + 1;
+                    delay += static_cast<int64_t>(random() % span) - options.jitterNs;
+                }
+                due_ns += std::max<int64_t>(delay, 0);
+            }
+        }
+
+        deliver(to, due_ns, data, length);
+        if (chance(options.duplicateRate)) {
+            tx.duplicated.fetch_add(1, std::memory_order_relaxed);
+            deliver(to, due_ns, data, length);
+        }
+        return {};
+    }
+
+    std::expected<size_t, Error> SocketMemory::transmitBatch(std::span<OutgoingPacket> packets) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        size_t sent = 0;
+        for (auto& packet : packets) {
+            packet.result = transmit(packet.addr, packet.data, packet.size);
+            if (packet.result) {
+                ++sent;
+            }
+        }
+        return sent;
+    }
+
+    std::expected<size_t, Error> SocketMemory::transmitSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        if (data == nullptr || segment_size == 0) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        size_t sent = 0;
+        for (size_t offset = 0; offset < length; offset += segment_size) {
+            auto result = transmit(addr, data + offset, std::min(segment_size, length - offset));
+            if (!result) {
+                if (sent == 0) {
+                    return std::unexpected(result.error());
+                }
+                break;
+            }
+            ++sent;
+        }
+        return sent;
+    }
+
+    void SocketMemory::hold(MemoryDatagram&& datagram) noexcept {
+        // Every held datagram owns one of the endpoint's queueCapacity buffers, so the reserve is never exceeded.
+        datagram.sequence = arrivals_++;
+        held_.push_back(std::move(datagram));
+        std::push_heap(held_.begin(), held_.end(), later);
+    }
+
+    std::optional<MemoryDatagram> SocketMemory::next(int64_t now_ns) noexcept {
+        while (true) {
+            std::optional<MemoryDatagram> datagram;
+            while (auto queued = endpoint_->inbox->tryPop()) {
+                // The common case, nothing held back: a due datagram goes straight out without touching the heap.
+                if (held_.empty() && queued->due_ns <= now_ns) {
+                    datagram = std::move(queued);
+                    break;
+                }
+                hold(std::move(*queued));
+            }
+            if (!datagram) {
+                if (held_.empty() || held_.front().due_ns > now_ns) {
+                    return std::nullopt;
+                }
+                std::pop_heap(held_.begin(), held_.end(), later);
+                datagram = std::move(held_.back());
+                held_.pop_back();
+            }
+            // A connected socket only hears from its peer, as with the kernel's.
+            if (!peer_ || datagram->packet.addr() == *peer_) {
+                return datagram;
+            }
+        }
+    }
+
+    std::expected<ReceivedPacket, Error> SocketMemory::receive(ReceivedPacket* into) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        if (into != nullptr && (into->data == nullptr || into->capacity < max_datagram_size_)) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        current_.reset();
+        if (truncated_pending_) {
+            truncated_pending_ = false;
+            return make_unexpected(ErrorCode::Truncated);
+        }
+        auto datagram = next(fabric_->timed() ? fabric_->now() : 0);
+        if (!datagram) {
+            return make_unexpected(ErrorCode::WouldBlock);
+        }
+        if (datagram->truncated) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+        endpoint_->delivered.fetch_add(1, std::memory_order_relaxed);
+
+        const size_t size = datagram->packet.size();
+        if (into != nullptr) {
+            std::memcpy(into->data, datagram->packet.data(), size);
+            into->size = size;
+            into->addr = datagram->packet.addr();
+            into->timestampNs = 0;
+            return *into;
+        }
+        // The datagram's own buffer is handed out, so there is nothing to copy.
+        current_ = std::move(datagram->packet);
+        return ReceivedPacket{ .data = current_.data(), .size = size, .capacity = max_datagram_size_, .addr = current_.addr() };
+    }
+
+    std::expected<size_t, Error> SocketMemory::receiveBatch(std::span<ReceivedPacket> packets) {
+        if (closed_.load(std::memory_order_relaxed)) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        for (const auto& packet : packets) {
+            if (packet.data == nullptr || packet.capacity < max_datagram_size_) {
+                return make_unexpected(ErrorCode::InvalidArgument);
+            }
+        }
+        current_.reset();
+        if (truncated_pending_) {
+            truncated_pending_ = false;
+            return make_unexpected(ErrorCode::Truncated);
+        }
+        if (packets.empty()) {
+            return 0;
+        }
+
+        const int64_t now_ns = fabric_->timed() ? fabric_->now() : 0;
+        size_t count = 0;
+        while (count < packets.size()) {
+            auto datagram = next(now_ns);
+            if (!datagram) {
+                break;
+            }
+            if (datagram->truncated) {
+                if (count == 0) {
+                    return make_unexpected(ErrorCode::Truncated);
+                }
+                truncated_pending_ = true;
+                break;
+            }
+            ReceivedPacket& packet = packets[count++];
+            packet.size = datagram->packet.size();
+            std::memcpy(packet.data, datagram->packet.data(), packet.size);
+            packet.addr = datagram->packet.addr();
+            packet.timestampNs = 0;
+        }
+        if (count == 0) {
+            return make_unexpected(ErrorCode::WouldBlock);
+        }
+        endpoint_->delivered.fetch_add(count, std::memory_order_relaxed);
+        return count;
+    }
+
+    MemoryNetwork::MemoryNetwork(std::shared_ptr<MemoryFabric> fabric) noexcept : fabric_(std::move(fabric)) {}
+
+    MemoryNetwork::~MemoryNetwork() = default;
+
+    std::expected<std::unique_ptr<MemoryNetwork>, Error> MemoryNetwork::Create(const MemoryNetworkOptions& options) {
+        if (options.latencyNs < 0 || options.jitterNs < 0) {
+            return make_unexpected(ErrorCode::InvalidArgument, "latency and jitter can't be negative");
+        }
+        if (!is_rate(options.lossRate) || !is_rate(options.duplicateRate) || !is_rate(options.reorderRate)) {
+            return make_unexpected(ErrorCode::InvalidArgument, "rates must be between 0 and 1");
+        }
+        if (options.queueCapacity == 0) {
+            return make_unexpected(ErrorCode::InvalidArgument, "queueCapacity must be at least 1");
+        }
+        try {
+            return std::unique_ptr<MemoryNetwork>(new MemoryNetwork(std::make_shared<MemoryFabric>(options)));
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> MemoryNetwork::listen(const Addr& bind_addr) {
+        return SocketMemory::Listen(fabric_, bind_addr, {});
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> MemoryNetwork::dial(const Addr& remote_addr) {
+        return SocketMemory::Dial(fabric_, remote_addr, {});
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> MemoryNetwork::listenWithOptions(const Addr& bind_addr, const SocketOptions& options) {
+        return SocketMemory::Listen(fabric_, bind_addr, options);
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> MemoryNetwork::dialWithOptions(const Addr& remote_addr, const SocketOptions& options) {
+        return SocketMemory::Dial(fabric_, remote_addr, options);
+    }
+
+    std::expected<std::vector<std::unique_ptr<ISocket>>, Error> MemoryNetwork::listenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options) {
+        return SocketMemory::ListenSharded(fabric_, bind_addr, shards, options);
+    }
+
+    void MemoryNetwork::advance(int64_t nanoseconds) noexcept {
+        fabric_->advance(nanoseconds);
+    }
+
+    int64_t MemoryNetwork::now() const noexcept {
+        return fabric_->now();
+    }
+
+    MemoryNetworkStats MemoryNetwork::stats() const noexcept {
+        return fabric_->stats();
+    }
+
+} // namespace pulse::net::udp
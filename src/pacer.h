@@ -0,0 +1,184 @@
+#pragma once
+
+#include <pulse/net/udp/error_code.h>
+#include <pulse/net/udp/peer_table.h>
+#include <pulse/net/udp/udp_addr.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    // Departure times for paced sends. Each datagram leaves no earlier than now, than the socket-wide
+    // clock allows, and than its destination's clock allows; both clocks then move on by the time its
+    // payload takes at their rate. Idle time earns no credit, so a quiet socket can't burst afterwards.
+    // Times are CLOCK_MONOTONIC nanoseconds, which is what SO_TXTIME wants. Not thread-safe.
+    class Pacer {
+    public:
+        // `rate` is payload bytes per second for the whole socket; 0 leaves only per-destination limits.
+        explicit Pacer(uint64_t rate) : rate_(rate) {}
+
+        // A scheduled datagram, with the clocks as they were before it so the slot can be given back.
+        struct Booking {
+            int64_t departure_ns = 0;
+            int64_t previous_ns = 0;
+            int64_t previous_destination_ns = 0;
+        };
+
+        [[nodiscard("Why schedule a datagram and then ignore when it leaves?")]]
+        int64_t schedule(const Addr& addr, size_t bytes, int64_t now_ns) noexcept {
+            return book(addr, bytes, now_ns).departure_ns;
+        }
+
+        [[nodiscard("Why book a datagram and then ignore when it leaves?")]]
+        Booking book(const Addr& addr, size_t bytes, int64_t now_ns) noexcept {
+            Booking booking{ .departure_ns = std::max(now_ns, next_ns_), .previous_ns = next_ns_, .previous_destination_ns = 0 };
+            Destination* destination = nullptr;
+            if (!destinations_.empty()) {
+                if (auto handle = destinations_.find(addr)) {
+                    destination = destinations_.get(handle);
+                    booking.previous_destination_ns = destination->next_ns;
+                    booking.departure_ns = std::max(booking.departure_ns, destination->next_ns);
+                }
+            }
+            if (rate_ > 0) {
+                next_ns_ = booking.departure_ns + spacing(bytes, rate_);
+            }
+            if (destination) {
+                destination->next_ns = booking.departure_ns + spacing(bytes, destination->rate);
+            }
+            return booking;
+        }
+
+        // Gives back a booking for a datagram that never left, so it doesn't hold back the ones after it.
+        // Only exact when bookings are cancelled newest first, with no rate changes in between.
+        void cancel(const Addr& addr, const Booking& booking) noexcept {
+            next_ns_ = booking.previous_ns;
+            if (!destinations_.empty()) {
+                if (auto handle = destinations_.find(addr)) {
+                    destinations_.get(handle)->next_ns = booking.previous_destination_ns;
+                }
+            }
+        }
+
+        // 0 removes the destination's limit.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> setRate(const Addr& addr, uint64_t rate) {
+            if (rate == 0) {
+                if (auto handle = destinations_.find(addr)) {
+                    destinations_.erase(handle);
+                }
+                return {};
+            }
+            try {
+                auto [handle, inserted] = destinations_.tryEmplace(addr, Destination{ .rate = rate, .next_ns = 0 });
+                if (!inserted) {
+                    destinations_.get(handle)->rate = rate;
+                }
+            } catch (std::bad_alloc& err) {
+                return make_unexpected(ErrorCode::SocketConfigFailed, err);
+            }
+            return {};
+        }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        uint64_t rate() const noexcept { return rate_; }
+
+    private:
+        struct Destination {
+            uint64_t rate = 0;
+            int64_t next_ns = 0;
+        };
+
+        // bytes * 1e9 / rate in 64 bits: whole seconds, then the remainder. Only rates beyond 18 GB/s make
+        // the remainder's product overflow, and at those dividing by bytes per nanosecond loses nothing.
+        static int64_t spacing(size_t bytes, uint64_t rate) noexcept {
+            constexpr uint64_t kNsPerSecond = 1'000'000'000;
+            const uint64_t whole = bytes / rate;
+            const uint64_t remainder = bytes % rate;
+            const uint64_t fraction = remainder <= std::numeric_limits<uint64_t>::max() / kNsPerSecond
+                ? remainder * kNsPerSecond / rate
+                : remainder / (rate / kNsPerSecond);
+            return static_cast<int64_t>(whole * kNsPerSecond + fraction);
+        }
+
+        uint64_t rate_;
+        int64_t next_ns_ = 0;
+        PeerTable<Destination> destinations_;
+    };
+
+    // Datagrams held back by userspace pacing until their departure time, copied into a preallocated
+    // arena so queueing never allocates. A min-heap on departure time (ties kept in arrival order)
+    // decides what goes next, since per-destination limits can let a later datagram overtake.
+    class PacedQueue {
+    public:
+        struct Entry {
+            int64_t departure_ns = 0;
+            uint64_t sequence = 0;
+            Addr addr;
+            bool connected = false; // Goes out with send() rather than sendTo()
+            size_t size = 0;
+            uint32_t slot = 0;
+        };
+
+        // May throw std::bad_alloc.
+        PacedQueue(size_t slots, size_t slot_size)
+            : slot_size_(slot_size), arena_(std::make_unique_for_overwrite<uint8_t[]>(slots * slot_size)) {
+            heap_.reserve(slots);
+            free_slots_.reserve(slots);
+            for (size_t i = slots; i > 0; --i) {
+                free_slots_.push_back(static_cast<uint32_t>(i - 1));
+            }
+        }
+
+        [[nodiscard("A full queue didn't take the datagram; handle it.")]]
+        bool push(int64_t departure_ns, const Addr& addr, bool connected, const uint8_t* data, size_t size) noexcept {
+            if (free_slots_.empty() || size > slot_size_) {
+                return false;
+            }
+            const Entry entry{ .departure_ns = departure_ns, .sequence = sequence_++, .addr = addr, .connected = connected, .size = size, .slot = free_slots_.back() };
+            free_slots_.pop_back();
+            std::memcpy(arena_.get() + entry.slot * slot_size_, data, size);
+            heap_.push_back(entry);
+            std::push_heap(heap_.begin(), heap_.end(), later);
+            return true;
+        }
+
+        [[nodiscard("Why ask and then ignore the answer?")]]
+        bool empty() const noexcept { return heap_.empty(); }
+
+        [[nodiscard("Why ask and then ignore the answer?")]]
+        bool full() const noexcept { return free_slots_.empty(); }
+
+        // The next datagram to leave; only valid while !empty().
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        const Entry& front() const noexcept { return heap_.front(); }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        const uint8_t* data_of(const Entry& entry) const noexcept { return arena_.get() + entry.slot * slot_size_; }
+
+        void pop() noexcept {
+            std::pop_heap(heap_.begin(), heap_.end(), later);
+            free_slots_.push_back(heap_.back().slot);
+            heap_.pop_back();
+        }
+
+    private:
+        static bool later(const Entry& a, const Entry& b) noexcept {
+            return a.departure_ns != b.departure_ns ? a.departure_ns > b.departure_ns : a.sequence > b.sequence;
+        }
+
+        size_t slot_size_;
+        std::unique_ptr<uint8_t[]> arena_;
+        std::vector<Entry> heap_;
+        std::vector<uint32_t> free_slots_;
+        uint64_t sequence_ = 0;
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,368 @@
+#include <pulse/net/udp/packet_capture.h>
+#include <pulse/net/udp/socket_options.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <system_error>
+
+namespace pulse::net::udp {
+
+    namespace {
+        constexpr uint16_t kLinkTypeRaw = 101; // Bare IPv4 or IPv6 packets
+        constexpr size_t kMaxHeaders = 48;     // IPv6 plus UDP
+        constexpr size_t kMaxRecordHeader = 28; // pcapng Enhanced Packet Block, the larger of the two
+        constexpr size_t kMaxRecordTrailer = 16; // pcapng epb_flags, end of options, closing length
+
+        size_t pad4(size_t length) noexcept {
+            return (length + 3) & ~size_t{3};
+        }
+
+        template <class T>
+        uint8_t* put(uint8_t* out, T value) noexcept {
+            std::memcpy(out, &value, sizeof(value));
+            return out + sizeof(value);
+        }
+
+        uint8_t* put_be16(uint8_t* out, uint16_t value) noexcept {
+            out[0] = static_cast<uint8_t>(value >> 8);
+            out[1] = static_cast<uint8_t>(value);
+            return out + 2;
+        }
+
+        // sin_addr sits at offset 4 of a sockaddr_in and sin6_addr at offset 8 of a sockaddr_in6, everywhere.
+        const uint8_t* ip_bytes(const Addr& addr) noexcept {
+            return static_cast<const uint8_t*>(addr.sockaddrData()) + (addr.isIPv6() ? 8 : 4);
+        }
+
+        uint16_t ipv4_checksum(const uint8_t* header) noexcept {
+            uint32_t sum = 0;
+            for (size_t i = 0; i < 20; i += 2) {
+                sum += static_cast<uint32_t>(header[i] << 8 | header[i + 1]);
+            }
+            while (sum >> 16) {
+                sum = (sum & 0xFFFF) + (sum >> 16);
+            }
+            return static_cast<uint16_t>(~sum);
+        }
+
+        // IP and UDP headers for a datagram between `source` and `destination`, which share a family.
+        // Returns the header length.
+        size_t build_headers(uint8_t* out, const Addr& source, const Addr& destination, uint32_t length) noexcept {
+            const bool v6 = destination.isIPv6();
+            const bool same_family = source.isIPv6() == v6;
+            const uint32_t udp_length = std::min<uint32_t>(length + 8, 0xFFFF);
+            uint8_t* p = out;
+            if (v6) {
+                p = put<uint32_t>(p, 0);
+                out[0] = 0x60;
+                p = put_be16(p, static_cast<uint16_t>(udp_length));
+                *p++ = 17; // UDP
+                *p++ = 64;
+                std::memset(p, 0, 16);
+                if (same_family) {
+                    std::memcpy(p, ip_bytes(source), 16);
+                }
+                std::memcpy(p + 16, ip_bytes(destination), 16);
+                p += 32;
+            } else {
+                *p++ = 0x45;
+                *p++ = 0;
+                p = put_be16(p, static_cast<uint16_t>(std::min<uint32_t>(length + 28, 0xFFFF)));
+                p = put<uint32_t>(p, 0); // Identification, flags, fragment offset
+                *p++ = 64;
+                *p++ = 17;
+                p = put<uint16_t>(p, 0);
+                std::memset(p, 0, 4);
+                if (same_family) {
+                    std::memcpy(p, ip_bytes(source), 4);
+                }
+                std::memcpy(p + 4, ip_bytes(destination), 4);
+                p += 8;
+                put_be16(out + 10, ipv4_checksum(out));
+            }
+            p = put_be16(p, source.port());
+            p = put_be16(p, destination.port());
+            p = put_be16(p, static_cast<uint16_t>(udp_length));
+            p = put<uint16_t>(p, 0); // No checksum
+            return static_cast<size_t>(p - out);
+        }
+    }
+
+    PacketCapture::PacketCapture(const PacketCaptureOptions& options) : options_(options) {}
+
+    std::expected<std::shared_ptr<PacketCapture>, Error> PacketCapture::Create(const PacketCaptureOptions& options) {
+        if (options.path.empty() || options.sampleEvery == 0 || options.snapLength > kMaxDatagramSize) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+
+        std::shared_ptr<PacketCapture> capture;
+        try {
+            capture.reset(new PacketCapture(options));
+            capture->stride_ = (sizeof(Record) + options.snapLength + 63) & ~size_t{63};
+            capture->capacity_ = std::bit_floor(std::max<uint64_t>(options.ringBytes / capture->stride_, 2));
+            capture->mask_ = capture->capacity_ - 1;
+            capture->slab_ = std::make_unique<CacheLine[]>(capture->capacity_ * capture->stride_ / sizeof(CacheLine));
+            for (uint64_t i = 0; i < capture->capacity_; ++i) {
+                new (&capture->recordAt(i)) Record{};
+                capture->recordAt(i).sequence.store(i, std::memory_order_relaxed);
+            }
+            capture->scratch_ = std::make_unique<uint8_t[]>(kMaxRecordHeader + kMaxHeaders + options.snapLength + 3 + kMaxRecordTrailer);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        if (auto opened = capture->open(); !opened) {
+            return std::unexpected(opened.error());
+        }
+        try {
+            capture->writer_ = std::thread([raw = capture.get()] { raw->run(); });
+        } catch (std::system_error& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err.code().value(), "can't start the capture writer");
+        }
+        return capture;
+    }
+
+    PacketCapture::~PacketCapture() {
+        {
+            std::lock_guard lock(mutex_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+        if (file_) {
+            std::fclose(file_);
+        }
+    }
+
+    void PacketCapture::record(CaptureDirection direction, const Addr& local, const Addr& peer, const uint8_t* data, size_t length) noexcept {
+        if (!enabled()) {
+            return;
+        }
+        // Claim a slot the way MpmcRing does, then fill it in place rather than moving a value in.
+        uint64_t position = enqueue_.load(std::memory_order_relaxed);
+        Record* slot = nullptr;
+        while (true) {
+            slot = &recordAt(position);
+            const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<int64_t>(sequence - position);
+            if (lag == 0) {
+                if (enqueue_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            } else {
+                position = enqueue_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+        slot->local = local;
+        slot->peer = peer;
+        slot->length = static_cast<uint32_t>(std::min<size_t>(length, UINT32_MAX));
+        slot->captured = static_cast<uint32_t>(std::min<size_t>(length, options_.snapLength));
+        slot->direction = direction;
+        if (slot->captured > 0) {
+            std::memcpy(slot->payload(), data, slot->captured);
+        }
+        slot->sequence.store(position + 1, std::memory_order_release);
+    }
+
+    void PacketCapture::flush() {
+        std::unique_lock lock(mutex_);
+        const uint64_t target = enqueue_.load(std::memory_order_acquire);
+        flush_target_ = std::max(flush_target_, target);
+        wake_.notify_one();
+        flushed_.wait(lock, [&] { return flushed_to_ >= target || stopping_; });
+    }
+
+    PacketCaptureStats PacketCapture::stats() const noexcept {
+        return PacketCaptureStats{
+            .captured = enqueue_.load(std::memory_order_relaxed),
+            .dropped = dropped_.load(std::memory_order_relaxed),
+            .written = written_.load(std::memory_order_relaxed),
+            .files = files_.load(std::memory_order_relaxed),
+        };
+    }
+
+    void PacketCapture::run() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            const bool stopping = stopping_;
+            lock.unlock();
+            drain();
+            if (file_) {
+                std::fflush(file_);
+            }
+            lock.lock();
+            flushed_to_ = dequeue_;
+            flushed_.notify_all();
+            if (stopping) {
+                return;
+            }
+            if (flush_target_ > dequeue_) {
+                // A producer has claimed a slot it hasn't filled yet; it will be a moment at most.
+                wake_.wait_for(lock, std::chrono::milliseconds(1));
+            } else {
+                wake_.wait_for(lock, options_.flushInterval, [&] { return stopping_ || flush_target_ > dequeue_; });
+            }
+        }
+    }
+
+    void PacketCapture::drain() {
+        while (true) {
+            Record& record = recordAt(dequeue_);
+            if (record.sequence.load(std::memory_order_acquire) != dequeue_ + 1) {
+                return;
+            }
+            write(record);
+            record.sequence.store(dequeue_ + capacity_, std::memory_order_release);
+            ++dequeue_;
+        }
+    }
+
+    void PacketCapture::write(const Record& record) {
+        if (options_.rotateBytes > 0 && file_bytes_ >= options_.rotateBytes) {
+            rotate();
+        }
+        if (!file_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        const bool sent = record.direction == CaptureDirection::Sent;
+        const Addr& source = sent ? record.local : record.peer;
+        const Addr& destination = sent ? record.peer : record.local;
+        const size_t header_size = options_.format == CaptureFormat::PcapNg ? 28 : 16;
+
+        uint8_t* packet = scratch_.get() + header_size;
+        const size_t headers = build_headers(packet, source, destination, record.length);
+        std::memcpy(packet + headers, record.payload(), record.captured);
+        const auto captured = static_cast<uint32_t>(headers + record.captured);
+        const auto original = static_cast<uint32_t>(headers + record.length);
+        const auto seconds = static_cast<uint64_t>(record.timestamp_ns) / 1'000'000'000u;
+        const auto nanoseconds = static_cast<uint64_t>(record.timestamp_ns) % 1'000'000'000u;
+
+        uint8_t* p = scratch_.get();
+        size_t total = 0;
+        if (options_.format == CaptureFormat::PcapNg) {
+            // Enhanced Packet Block, with the direction in epb_flags.
+            const size_t padded = pad4(captured);
+            total = header_size + padded + 16;
+            const auto ns = static_cast<uint64_t>(record.timestamp_ns);
+            p = put<uint32_t>(p, 6);
+            p = put<uint32_t>(p, static_cast<uint32_t>(total));
+            p = put<uint32_t>(p, 0); // Interface
+            p = put<uint32_t>(p, static_cast<uint32_t>(ns >> 32));
+            p = put<uint32_t>(p, static_cast<uint32_t>(ns));
+            p = put<uint32_t>(p, captured);
+            put<uint32_t>(p, original);
+            p = packet + captured;
+            std::memset(p, 0, padded - captured);
+            p += padded - captured;
+            p = put<uint16_t>(p, 2); // epb_flags
+            p = put<uint16_t>(p, 4);
+            p = put<uint32_t>(p, sent ? 2u : 1u);
+            p = put<uint32_t>(p, 0); // End of options
+            put<uint32_t>(p, static_cast<uint32_t>(total));
+        } else {
+            total = header_size + captured;
+            p = put<uint32_t>(p, static_cast<uint32_t>(seconds));
+            p = put<uint32_t>(p, static_cast<uint32_t>(nanoseconds));
+            p = put<uint32_t>(p, captured);
+            put<uint32_t>(p, original);
+        }
+
+        if (std::fwrite(scratch_.get(), 1, total, file_) != total) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        file_bytes_ += total;
+        written_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    std::expected<void, Error> PacketCapture::open() {
+        const uint64_t index = files_.load(std::memory_order_relaxed);
+        auto name_of = [&](uint64_t i) { return i == 0 ? options_.path : options_.path + "." + std::to_string(i); };
+
+        uint8_t header[64];
+        uint8_t* p = header;
+        const auto snap = static_cast<uint32_t>(kMaxHeaders + options_.snapLength);
+        if (options_.format == CaptureFormat::PcapNg) {
+            // Section Header Block, then one Interface Description Block with nanosecond timestamps.
+            p = put<uint32_t>(p, 0x0A0D0D0A);
+            p = put<uint32_t>(p, 28);
+            p = put<uint32_t>(p, 0x1A2B3C4D);
+            p = put<uint16_t>(p, 1);
+            p = put<uint16_t>(p, 0);
+            p = put<int64_t>(p, -1); // Section length unknown
+            p = put<uint32_t>(p, 28);
+            p = put<uint32_t>(p, 1);
+            p = put<uint32_t>(p, 32);
+            p = put<uint16_t>(p, kLinkTypeRaw);
+            p = put<uint16_t>(p, 0);
+            p = put<uint32_t>(p, snap);
+            p = put<uint16_t>(p, 9); // if_tsresol: 10^-9
+            p = put<uint16_t>(p, 1);
+            p = put<uint32_t>(p, 9);
+            p = put<uint32_t>(p, 0); // End of options
+            p = put<uint32_t>(p, 32);
+        } else {
+            p = put<uint32_t>(p, 0xA1B23C4D); // Nanosecond timestamps
+            p = put<uint16_t>(p, 2);
+            p = put<uint16_t>(p, 4);
+            p = put<int32_t>(p, 0);
+            p = put<uint32_t>(p, 0);
+            p = put<uint32_t>(p, snap);
+            p = put<uint32_t>(p, kLinkTypeRaw);
+        }
+        const auto header_size = static_cast<size_t>(p - header);
+
+        std::string name;
+        try {
+            name = name_of(index);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        file_ = std::fopen(name.c_str(), "wb");
+        if (!file_) {
+            return make_unexpected(ErrorCode::InvalidArgument, errno, "can't open the capture file");
+        }
+        if (std::fwrite(header, 1, header_size, file_) != header_size) {
+            const int error = errno;
+            std::fclose(file_);
+            file_ = nullptr;
+            return make_unexpected(ErrorCode::InvalidArgument, error, "can't write the capture file");
+        }
+        file_bytes_ = header_size;
+        files_.store(index + 1, std::memory_order_relaxed);
+
+        if (options_.maxFiles > 0 && index >= options_.maxFiles) {
+            try {
+                std::remove(name_of(index - options_.maxFiles).c_str());
+            } catch (std::bad_alloc&) {
+                // The old file stays; better than losing the new one.
+            }
+        }
+        return {};
+    }
+
+    void PacketCapture::rotate() {
+        if (file_) {
+            std::fclose(file_);
+            file_ = nullptr;
+        }
+        if (!open()) {
+            // Give up on this capture rather than retrying every record: file_ stays null, so
+            // everything from here on is counted as dropped.
+            file_bytes_ = 0;
+        }
+    }
+
+} // namespace pulse::net::udp
@@ -0,0 +1,77 @@
+#include <pulse/net/udp/packet_pool.h>
+
+#include <sys/mman.h>
+#include <errno.h>
+#include <new>
+
+namespace pulse::net::udp {
+
+    namespace {
+
+        constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+
+        constexpr size_t round_up(size_t value, size_t multiple) {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+
+    } // namespace
+
+    std::expected<std::unique_ptr<PacketPool>, Error> PacketPool::Create(const PacketPoolOptions& options) {
+        if (options.bufferSize == 0 || options.bufferCount == 0 || options.bufferCount >= kNoSlot) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+
+        std::unique_ptr<PacketPool> pool;
+        try {
+            pool.reset(new PacketPool());
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        pool->buffer_size_ = options.bufferSize;
+        pool->buffer_count_ = options.bufferCount;
+        pool->stride_ = sizeof(Slot) + round_up(options.bufferSize, alignof(Slot));
+
+        void* slab = MAP_FAILED;
+#if defined(MAP_HUGETLB)
+        if (options.hugePages) {
+            pool->slab_size_ = round_up(pool->stride_ * options.bufferCount, kHugePageSize);
+            slab = ::mmap(nullptr, pool->slab_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            pool->huge_pages_ = slab != MAP_FAILED;
+        }
+#endif
+        if (slab == MAP_FAILED) {
+            // No reserved huge pages; ask for transparent ones instead, which the kernel may or may not grant.
+            pool->slab_size_ = options.hugePages ? round_up(pool->stride_ * options.bufferCount, kHugePageSize)
+                                                 : pool->stride_ * options.bufferCount;
+            slab = ::mmap(nullptr, pool->slab_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (slab == MAP_FAILED) {
+                return make_unexpected(ErrorCode::SocketCreateFailed, errno);
+            }
+#if defined(MADV_HUGEPAGE)
+            if (options.hugePages) {
+                ::madvise(slab, pool->slab_size_, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        pool->slab_ = static_cast<uint8_t*>(slab);
+
+        // Thread the free list through the slots in address order so early packets share pages.
+        for (size_t i = 0; i < options.bufferCount; ++i) {
+            Slot* slot = new (pool->slab_ + i * pool->stride_) Slot();
+            slot->pool = pool.get();
+            slot->next_free.store(i + 1 < options.bufferCount ? static_cast<uint32_t>(i + 1) : kNoSlot, std::memory_order_relaxed);
+        }
+        pool->free_head_.store(0, std::memory_order_relaxed);
+        pool->available_.store(options.bufferCount, std::memory_order_relaxed);
+
+        return pool;
+    }
+
+    PacketPool::~PacketPool() {
+        if (slab_) {
+            ::munmap(slab_, slab_size_);
+        }
+    }
+
+} // namespace pulse::net::udp
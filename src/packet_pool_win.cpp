@@ -0,0 +1,69 @@
+#include <pulse/net/udp/packet_pool.h>
+
+#include <windows.h>
+#include <new>
+
+namespace pulse::net::udp {
+
+    namespace {
+
+        constexpr size_t round_up(size_t value, size_t multiple) {
+            return (value + multiple - 1) / multiple * multiple;
+        }
+
+    } // namespace
+
+    std::expected<std::unique_ptr<PacketPool>, Error> PacketPool::Create(const PacketPoolOptions& options) {
+        if (options.bufferSize == 0 || options.bufferCount == 0 || options.bufferCount >= kNoSlot) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+
+        std::unique_ptr<PacketPool> pool;
+        try {
+            pool.reset(new PacketPool());
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        pool->buffer_size_ = options.bufferSize;
+        pool->buffer_count_ = options.bufferCount;
+        pool->stride_ = sizeof(Slot) + round_up(options.bufferSize, alignof(Slot));
+
+        void* slab = nullptr;
+        if (options.hugePages) {
+            // Needs SeLockMemoryPrivilege; without it we quietly fall back to normal pages.
+            const size_t large_page = GetLargePageMinimum();
+            if (large_page != 0) {
+                pool->slab_size_ = round_up(pool->stride_ * options.bufferCount, large_page);
+                slab = VirtualAlloc(nullptr, pool->slab_size_, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+                pool->huge_pages_ = slab != nullptr;
+            }
+        }
+        if (!slab) {
+            pool->slab_size_ = pool->stride_ * options.bufferCount;
+            slab = VirtualAlloc(nullptr, pool->slab_size_, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+            if (!slab) {
+                return make_unexpected(ErrorCode::SocketCreateFailed, static_cast<int>(GetLastError()));
+            }
+        }
+        pool->slab_ = static_cast<uint8_t*>(slab);
+
+        // Thread the free list through the slots in address order so early packets share pages.
+        for (size_t i = 0; i < options.bufferCount; ++i) {
+            Slot* slot = new (pool->slab_ + i * pool->stride_) Slot();
+            slot->pool = pool.get();
+            slot->next_free.store(i + 1 < options.bufferCount ? static_cast<uint32_t>(i + 1) : kNoSlot, std::memory_order_relaxed);
+        }
+        pool->free_head_.store(0, std::memory_order_relaxed);
+        pool->available_.store(options.bufferCount, std::memory_order_relaxed);
+
+        return pool;
+    }
+
+    PacketPool::~PacketPool() {
+        if (slab_) {
+            VirtualFree(slab_, 0, MEM_RELEASE);
+        }
+    }
+
+} // namespace pulse::net::udp
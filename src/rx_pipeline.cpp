@@ -0,0 +1,182 @@
+#include <pulse/net/udp/rx_pipeline.h>
+
+#include <algorithm>
+#include <new>
+#include <utility>
+
+namespace pulse::net::udp {
+
+    namespace {
+        constexpr size_t kMaxPipelineBatch = 64;
+    }
+
+    RxPipeline::Queue::Queue(size_t capacity, bool shared) {
+        if (shared) {
+            mpmc = std::make_unique<MpmcRing<PooledPacket>>(capacity);
+        } else {
+            spsc = std::make_unique<SpscRing<PooledPacket>>(capacity);
+        }
+    }
+
+    RxPipeline::RxPipeline(ISocket& socket, PacketPool& pool, const RxPipelineOptions& options)
+        : socket_(socket), pool_(pool), workers_(options.workers), dispatch_(options.dispatch), overflow_(options.overflow) {}
+
+    std::expected<std::unique_ptr<RxPipeline>, Error> RxPipeline::Create(ISocket& socket, PacketPool& pool, const RxPipelineOptions& options) {
+        if (options.workers == 0 || options.queueCapacity == 0 || options.batchSize == 0 || options.batchSize > kMaxPipelineBatch) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+
+        std::unique_ptr<RxPipeline> pipeline;
+        try {
+            pipeline.reset(new RxPipeline(socket, pool, options));
+            const bool shared = options.dispatch == DispatchPolicy::Shared;
+            const size_t rings = shared ? 1 : options.workers;
+            pipeline->queues_.reserve(rings);
+            for (size_t i = 0; i < rings; ++i) {
+                pipeline->queues_.push_back(std::make_unique<Queue>(options.queueCapacity, shared));
+            }
+            pipeline->batch_.resize(options.batchSize);
+            pipeline->pending_.reserve(options.batchSize);
+            pipeline->pending_workers_.reserve(options.batchSize);
+            pipeline->blocked_.resize(rings);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        return pipeline;
+    }
+
+    size_t RxPipeline::route(const PooledPacket& packet) noexcept {
+        if (queues_.size() == 1) {
+            return 0;
+        }
+        if (dispatch_ == DispatchPolicy::PeerHash) {
+            return packet.addr().hash() % workers_;
+        }
+        const size_t worker = next_worker_;
+        next_worker_ = next_worker_ + 1 == workers_ ? 0 : next_worker_ + 1;
+        return worker;
+    }
+
+    bool RxPipeline::push(Queue& queue, PooledPacket& packet) noexcept {
+        const bool pushed = queue.spsc ? queue.spsc->tryPush(std::move(packet)) : queue.mpmc->tryPush(std::move(packet));
+        if (pushed) {
+            queue.dispatched.fetch_add(1, std::memory_order_relaxed);
+        }
+        return pushed;
+    }
+
+    size_t RxPipeline::flushPending() noexcept {
+        // Once a ring refuses one datagram, later ones for it wait too, so each peer's order holds.
+        std::fill(blocked_.begin(), blocked_.end(), false);
+        size_t sent = 0;
+        size_t kept = 0;
+        for (size_t i = 0; i < pending_.size(); ++i) {
+            const size_t worker = pending_workers_[i];
+            if (!blocked_[worker] && push(*queues_[worker], pending_[i])) {
+                ++sent;
+                continue;
+            }
+            blocked_[worker] = true;
+            if (kept != i) {
+                pending_[kept] = std::move(pending_[i]);
+                pending_workers_[kept] = worker;
+            }
+            ++kept;
+        }
+        pending_.resize(kept);
+        pending_workers_.resize(kept);
+        return sent;
+    }
+
+    std::expected<size_t, Error> RxPipeline::pump() {
+        size_t dispatched = 0;
+        if (!pending_.empty()) {
+            dispatched = flushPending();
+            if (!pending_.empty()) {
+                stalls_.fetch_add(1, std::memory_order_relaxed);
+                return dispatched;
+            }
+        }
+
+        auto received = socket_.recvBatchPooled(pool_, batch_);
+        if (!received) {
+            if (received.error() == ErrorCode::PoolExhausted) {
+                pool_exhausted_.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (dispatched > 0) {
+                return dispatched;
+            }
+            return std::unexpected(received.error());
+        }
+        received_.fetch_add(*received, std::memory_order_relaxed);
+
+        for (size_t i = 0; i < *received; ++i) {
+            PooledPacket& packet = batch_[i];
+            const size_t worker = route(packet);
+            if (!pending_.empty() && overflow_ == OverflowPolicy::Stall) {
+                // Something ahead of it is already waiting; keep arrival order.
+                pending_.push_back(std::move(packet));
+                pending_workers_.push_back(worker);
+                continue;
+            }
+            if (push(*queues_[worker], packet)) {
+                ++dispatched;
+            } else if (overflow_ == OverflowPolicy::Stall) {
+                pending_.push_back(std::move(packet));
+                pending_workers_.push_back(worker);
+            } else {
+                queues_[worker]->dropped.fetch_add(1, std::memory_order_relaxed);
+                packet.reset();
+            }
+        }
+        if (!pending_.empty()) {
+            dispatched += flushPending();
+        }
+        return dispatched;
+    }
+
+    std::optional<PooledPacket> RxPipeline::pop(size_t worker) noexcept {
+        if (worker >= workers_) {
+            return std::nullopt;
+        }
+        Queue& queue = queueFor(worker);
+        return queue.spsc ? queue.spsc->tryPop() : queue.mpmc->tryPop();
+    }
+
+    size_t RxPipeline::popBatch(size_t worker, std::span<PooledPacket> packets) noexcept {
+        size_t popped = 0;
+        for (; popped < packets.size(); ++popped) {
+            auto packet = pop(worker);
+            if (!packet) {
+                break;
+            }
+            packets[popped] = std::move(*packet);
+        }
+        return popped;
+    }
+
+    RxPipelineStats RxPipeline::stats() const noexcept {
+        RxPipelineStats stats;
+        stats.received = received_.load(std::memory_order_relaxed);
+        stats.stalls = stalls_.load(std::memory_order_relaxed);
+        stats.poolExhausted = pool_exhausted_.load(std::memory_order_relaxed);
+        for (const auto& queue : queues_) {
+            stats.dispatched += queue->dispatched.load(std::memory_order_relaxed);
+            stats.dropped += queue->dropped.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+    RxQueueStats RxPipeline::queueStats(size_t worker) const noexcept {
+        if (worker >= workers_) {
+            return RxQueueStats{};
+        }
+        const Queue& queue = queueFor(worker);
+        return RxQueueStats{
+            .dispatched = queue.dispatched.load(std::memory_order_relaxed),
+            .dropped = queue.dropped.load(std::memory_order_relaxed),
+            .depth = queue.spsc ? queue.spsc->size() : queue.mpmc->size(),
+        };
+    }
+
+} // namespace pulse::net::udp
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <pulse/net/udp/udp.h>
+#include <pulse/net/udp/socket_metrics.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <span>
+
+namespace pulse::net::udp {
+
+    // The live counters behind ISocket::metrics(). Relaxed atomics, so any number of threads can record
+    // and snapshot without locks; receive and send counters sit on separate cache lines so a receiving
+    // thread and a sending thread don't bounce one line between them. Sockets only allocate one when
+    // SocketOptions::metrics is set, so the cost with metrics off is a null check.
+    class SocketCounters {
+    public:
+        void recordRecv(const std::expected<ReceivedPacket, Error>& result) noexcept {
+            if (result) {
+                add(rx_.packets, 1);
+                add(rx_.bytes, result->size);
+            } else {
+                recordRecvError(result.error());
+            }
+        }
+
+        void recordRecvBatch(const std::expected<size_t, Error>& result, std::span<const ReceivedPacket> packets) noexcept {
+            if (!result) {
+                recordRecvError(result.error());
+                return;
+            }
+            size_t bytes = 0;
+            for (size_t i = 0; i < *result; ++i) {
+                bytes += packets[i].size;
+            }
+            add(rx_.packets, *result);
+            add(rx_.bytes, bytes);
+        }
+
+        void recordSend(const std::expected<void, Error>& result, size_t length) noexcept {
+            if (result) {
+                add(tx_.packets, 1);
+                add(tx_.bytes, length);
+            } else {
+                recordSendError(result.error());
+            }
+        }
+
+        // Reads the per-packet results sendBatch() filled in. The WouldBlock it stops at is copied onto
+        // every remaining packet but counts once.
+        void recordSendBatch(std::span<const OutgoingPacket> packets) noexcept {
+            size_t sent = 0;
+            size_t bytes = 0;
+            bool would_block = false;
+            for (const auto& packet : packets) {
+                if (packet.result) {
+                    ++sent;
+                    bytes += packet.size;
+                } else if (packet.result.error() == ErrorCode::WouldBlock) {
+                    would_block = true;
+                } else {
+                    recordSendError(packet.result.error());
+                }
+            }
+            add(tx_.packets, sent);
+            add(tx_.bytes, bytes);
+            if (would_block) {
+                add(tx_.would_block, 1);
+            }
+        }
+
+        // sendSegmented() sends its segments in order, so `count` of them cover the front of the buffer.
+        void recordSendSegmented(const std::expected<size_t, Error>& result, size_t length, size_t segment_size) noexcept {
+            if (!result) {
+                recordSendError(result.error());
+                return;
+            }
+            add(tx_.packets, *result);
+            add(tx_.bytes, *result * segment_size < length ? *result * segment_size : length);
+        }
+
+        // `total` is the kernel's running drop count for the socket, as carried by SO_RXQ_OVFL.
+        void recordKernelDrops(uint32_t total) noexcept {
+            kernel_drops_.store(total, std::memory_order_relaxed);
+        }
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        SocketMetrics snapshot() const noexcept {
+            SocketMetrics metrics;
+            metrics.packetsReceived = rx_.packets.load(std::memory_order_relaxed);
+            metrics.bytesReceived = rx_.bytes.load(std::memory_order_relaxed);
+            metrics.recvWouldBlock = rx_.would_block.load(std::memory_order_relaxed);
+            metrics.packetsSent = tx_.packets.load(std::memory_order_relaxed);
+            metrics.bytesSent = tx_.bytes.load(std::memory_order_relaxed);
+            metrics.sendWouldBlock = tx_.would_block.load(std::memory_order_relaxed);
+            metrics.partialSends = partial_sends_.load(std::memory_order_relaxed);
+            metrics.kernelDrops = kernel_drops_.load(std::memory_order_relaxed);
+            for (size_t i = 0; i < kErrorCodeSlots; ++i) {
+                metrics.errors[i] = errors_[i].load(std::memory_order_relaxed);
+            }
+            return metrics;
+        }
+
+    private:
+        struct alignas(64) Direction {
+            std::atomic<uint64_t> packets{0};
+            std::atomic<uint64_t> bytes{0};
+            std::atomic<uint64_t> would_block{0};
+        };
+
+        static void add(std::atomic<uint64_t>& counter, uint64_t value) noexcept {
+            counter.fetch_add(value, std::memory_order_relaxed);
+        }
+
+        void recordRecvError(const Error& error) noexcept {
+            if (error == ErrorCode::WouldBlock) {
+                add(rx_.would_block, 1);
+            } else {
+                add(errors_[error_slot(error.code)], 1);
+            }
+        }
+
+        void recordSendError(const Error& error) noexcept {
+            if (error == ErrorCode::WouldBlock) {
+                add(tx_.would_block, 1);
+            } else if (error == ErrorCode::PartialSend) {
+                add(partial_sends_, 1);
+            } else {
+                add(errors_[error_slot(error.code)], 1);
+            }
+        }
+
+        Direction rx_;
+        Direction tx_;
+        alignas(64) std::atomic<uint64_t> partial_sends_{0};
+        std::atomic<uint64_t> kernel_drops_{0}; // Latest total from the kernel, not a sum
+        std::array<std::atomic<uint64_t>, kErrorCodeSlots> errors_{};
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <pulse/net/udp/error_code.h>
+#include <pulse/net/udp/socket_options.h>
+
+#include <expected>
+
+namespace pulse::net::udp {
+
+    [[nodiscard("You're ignoring an error message. Don't do that.")]]
+    inline std::expected<void, Error> check_socket_options(const SocketOptions& options) {
+        if (options.maxDatagramSize == 0 || options.maxDatagramSize > kMaxDatagramSize) {
+            return make_unexpected(ErrorCode::InvalidArgument, "maxDatagramSize must be between 1 and 65507");
+        }
+        if (options.pacingRate) {
+            // The userspace queue is allocated up front, one maxDatagramSize slot per entry.
+            constexpr size_t kMaxPacingQueueBytes = size_t{256} << 20;
+            if (options.pacingQueueSize == 0 || options.pacingQueueSize > kMaxPacingQueueBytes / options.maxDatagramSize) {
+                return make_unexpected(ErrorCode::InvalidArgument, "pacingQueueSize must be at least 1 and hold at most 256 MiB");
+            }
+        }
+        return {};
+    }
+
+} // namespace pulse::net::udp
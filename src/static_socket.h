@@ -0,0 +1,127 @@
+#pragma once
+
+#include <pulse/net/udp/socket.h>
+
+#include <new>
+#include <utility>
+
+namespace pulse::net::udp {
+
+    // Maps a backend tag to its final socket class and that class's factories. Each platform's
+    // static_socket_*.cpp specializes it for the backends it has, then instantiates Socket<> for them.
+    template <class Backend>
+    struct ConcreteSocket;
+
+    // Every backend class is final, so these calls through impl() compile to direct calls.
+    template <class Backend>
+    auto& Socket<Backend>::impl() const noexcept {
+        return static_cast<typename ConcreteSocket<Backend>::type&>(*impl_);
+    }
+
+    template <class Backend>
+    std::expected<Socket<Backend>, Error> Socket<Backend>::Listen(const Addr& bind_addr, const SocketOptions& options) {
+        auto socket = ConcreteSocket<Backend>::Listen(bind_addr, options);
+        if (!socket) {
+            return std::unexpected(socket.error());
+        }
+        return Socket(std::move(*socket));
+    }
+
+    template <class Backend>
+    std::expected<std::vector<Socket<Backend>>, Error> Socket<Backend>::ListenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options) {
+        auto group = ConcreteSocket<Backend>::ListenSharded(bind_addr, shards, options);
+        if (!group) {
+            return std::unexpected(group.error());
+        }
+        std::vector<Socket> sockets;
+        try {
+            sockets.reserve(group->size());
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        for (auto& socket : *group) {
+            sockets.push_back(Socket(std::move(socket)));
+        }
+        return sockets;
+    }
+
+    template <class Backend>
+    std::expected<Socket<Backend>, Error> Socket<Backend>::Dial(const Addr& remote_addr, const SocketOptions& options) {
+        auto socket = ConcreteSocket<Backend>::Dial(remote_addr, options);
+        if (!socket) {
+            return std::unexpected(socket.error());
+        }
+        return Socket(std::move(*socket));
+    }
+
+    template <class Backend>
+    std::expected<void, Error> Socket<Backend>::sendTo(const Addr& addr, const uint8_t* data, size_t length) {
+        return impl().sendTo(addr, data, length);
+    }
+
+    template <class Backend>
+    std::expected<void, Error> Socket<Backend>::send(const uint8_t* data, size_t length) {
+        return impl().send(data, length);
+    }
+
+    template <class Backend>
+    std::expected<size_t, Error> Socket<Backend>::sendBatch(std::span<OutgoingPacket> packets) {
+        return impl().sendBatch(packets);
+    }
+
+    template <class Backend>
+    std::expected<size_t, Error> Socket<Backend>::sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        return impl().sendSegmented(addr, data, length, segment_size);
+    }
+
+    template <class Backend>
+    std::expected<ReceivedPacket, Error> Socket<Backend>::recvFrom() {
+        return impl().recvFrom();
+    }
+
+    template <class Backend>
+    std::expected<ReceivedPacket, Error> Socket<Backend>::recvFrom(ReceivedPacket&& packet) {
+        return impl().recvFrom(std::move(packet));
+    }
+
+    template <class Backend>
+    std::expected<size_t, Error> Socket<Backend>::recvBatch(std::span<ReceivedPacket> packets) {
+        return impl().recvBatch(packets);
+    }
+
+    template <class Backend>
+    std::expected<size_t, Error> Socket<Backend>::readTxTimestamps(std::span<TxTimestamp> timestamps) {
+        return impl().readTxTimestamps(timestamps);
+    }
+
+    template <class Backend>
+    std::expected<SocketMetrics, Error> Socket<Backend>::metrics() const {
+        return impl().metrics();
+    }
+
+    template <class Backend>
+    std::expected<void, Error> Socket<Backend>::setPacingRate(const Addr& addr, uint64_t bytes_per_second) {
+        return impl().setPacingRate(addr, bytes_per_second);
+    }
+
+    template <class Backend>
+    std::expected<int64_t, Error> Socket<Backend>::flushPaced() {
+        return impl().flushPaced();
+    }
+
+    template <class Backend>
+    std::expected<int, Error> Socket<Backend>::getHandle() const {
+        return impl().getHandle();
+    }
+
+    template <class Backend>
+    std::expected<int, Error> Socket<Backend>::getReadHandle() const {
+        return impl().getReadHandle();
+    }
+
+    template <class Backend>
+    void Socket<Backend>::close() {
+        impl().close();
+    }
+
+} // namespace pulse::net::udp
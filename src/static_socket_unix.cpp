@@ -0,0 +1,66 @@
+#include "static_socket.h"
+#include "unix_socket.h"
+#if defined(PULSENET_UDP_HAS_IO_URING)
+#include "io_uring_socket.h"
+#endif
+
+namespace pulse::net::udp {
+
+    template <>
+    struct ConcreteSocket<NativeBackend> {
+        using type = SocketUnix;
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bind_addr, const SocketOptions& options) {
+            return SocketUnix::Listen(bind_addr, options);
+        }
+
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options) {
+            return SocketUnix::ListenSharded(bind_addr, shards, options);
+        }
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remote_addr, const SocketOptions& options) {
+            return SocketUnix::Dial(remote_addr, options);
+        }
+    };
+
+#if defined(PULSENET_UDP_HAS_IO_URING)
+    template <>
+    struct ConcreteSocket<IoUringBackend> {
+        using type = SocketIoUring;
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bind_addr, const SocketOptions& options) {
+            return SocketIoUring::Listen(bind_addr, options);
+        }
+
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options) {
+            return SocketIoUring::ListenSharded(bind_addr, shards, options);
+        }
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remote_addr, const SocketOptions& options) {
+            return SocketIoUring::Dial(remote_addr, options);
+        }
+    };
+#else
+    // Built without io_uring: nothing can be created, so the calls are never reached.
+    template <>
+    struct ConcreteSocket<IoUringBackend> {
+        using type = ISocket;
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr&, const SocketOptions&) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const Addr&, size_t, const SocketOptions&) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr&, const SocketOptions&) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+    };
+#endif
+
+    template class Socket<NativeBackend>;
+    template class Socket<IoUringBackend>;
+
+} // namespace pulse::net::udp
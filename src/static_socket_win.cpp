@@ -0,0 +1,44 @@
+#include "static_socket.h"
+#include "win_socket.h"
+
+namespace pulse::net::udp {
+
+    template <>
+    struct ConcreteSocket<NativeBackend> {
+        using type = SocketWindows;
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bind_addr, const SocketOptions& options) {
+            return SocketWindows::Listen(bind_addr, options);
+        }
+
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const Addr&, size_t, const SocketOptions&) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remote_addr, const SocketOptions& options) {
+            return SocketWindows::Dial(remote_addr, options);
+        }
+    };
+
+    // No io_uring on Windows: nothing can be created, so the calls are never reached.
+    template <>
+    struct ConcreteSocket<IoUringBackend> {
+        using type = ISocket;
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr&, const SocketOptions&) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const Addr&, size_t, const SocketOptions&) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr&, const SocketOptions&) {
+            return make_unexpected(ErrorCode::Unsupported);
+        }
+    };
+
+    template class Socket<NativeBackend>;
+    template class Socket<IoUringBackend>;
+
+} // namespace pulse::net::udp
@@ -1,35 +1,100 @@
 #include "pulse/net/udp/udp_addr.h"
+#include <sys/socket.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
-#include <stdexcept>
+#include <cstddef>
 #include <cstring>
 
 namespace pulse::net::udp {
 
+    static_assert(sizeof(sockaddr_in6) == Addr::kStorageSize, "Addr storage must hold a sockaddr_in6");
+    static_assert(sizeof(Addr) <= 32, "Addr must stay small enough to pass around by value");
+
     const char* Addr::kAnyIPv4 = "0.0.0.0";
     const char* Addr::kAnyIPv6 = "::";
 
-    Addr::Addr(const std::string& ip_str, uint16_t port)
-        : ip(ip_str), port(port)
-    {
-        if (inet_pton(AF_INET, ip_str.c_str(), &reinterpret_cast<sockaddr_in*>(storage_)->sin_addr) == 1) {
-            auto* addr = reinterpret_cast<sockaddr_in*>(storage_);
-            addr->sin_family = AF_INET;
-            addr->sin_port = htons(port);
-        } else if (inet_pton(AF_INET6, ip_str.c_str(), &reinterpret_cast<sockaddr_in6*>(storage_)->sin6_addr) == 1) {
-            auto* addr6 = reinterpret_cast<sockaddr_in6*>(storage_);
-            addr6->sin6_family = AF_INET6;
-            addr6->sin6_port = htons(port);
+    namespace {
+
+        // Rebuilds the sockaddr from its identifying fields only, so equal endpoints are equal bytes.
+        void store_ipv4(uint8_t* storage, const in_addr& ip, in_port_t port) {
+            sockaddr_in addr{};
+#if defined(SIN6_LEN)
+            addr.sin_len = sizeof(addr);
+#endif
+            addr.sin_family = AF_INET;
+            addr.sin_port = port;
+            addr.sin_addr = ip;
+            std::memcpy(storage, &addr, sizeof(addr));
+        }
+
+        void store_ipv6(uint8_t* storage, const in6_addr& ip, in_port_t port, uint32_t scope_id) {
+            sockaddr_in6 addr{};
+#if defined(SIN6_LEN)
+            addr.sin6_len = sizeof(addr);
+#endif
+            addr.sin6_family = AF_INET6;
+            addr.sin6_port = port;
+            addr.sin6_addr = ip;
+            addr.sin6_scope_id = scope_id;
+            std::memcpy(storage, &addr, sizeof(addr));
+        }
+
+    } // namespace
+
+    std::expected<Addr, Error> Addr::Create(const std::string& ip, uint16_t port) {
+        Addr addr;
+        in_addr ip4{};
+        in6_addr ip6{};
+
+        if (inet_pton(AF_INET, ip.c_str(), &ip4) == 1) {
+            store_ipv4(addr.storage_, ip4, htons(port));
+        } else if (inet_pton(AF_INET6, ip.c_str(), &ip6) == 1) {
+            store_ipv6(addr.storage_, ip6, htons(port), 0);
+        } else {
+            return make_unexpected(ErrorCode::InvalidAddress, "Not an IPv4 or IPv6 literal");
+        }
+        return addr;
+    }
+
+    std::expected<Addr, Error> Addr::FromSockaddr(const void* sockaddr_ptr, size_t length) {
+        if (length < offsetof(sockaddr, sa_family) + sizeof(sa_family_t)) {
+            return make_unexpected(ErrorCode::InvalidAddress);
+        }
+        sa_family_t family;
+        std::memcpy(&family, static_cast<const uint8_t*>(sockaddr_ptr) + offsetof(sockaddr, sa_family), sizeof(family));
+
+        Addr addr;
+        if (family == AF_INET && length >= sizeof(sockaddr_in)) {
+            sockaddr_in src;
+            std::memcpy(&src, sockaddr_ptr, sizeof(src));
+            store_ipv4(addr.storage_, src.sin_addr, src.sin_port);
+        } else if (family == AF_INET6 && length >= sizeof(sockaddr_in6)) {
+            sockaddr_in6 src;
+            std::memcpy(&src, sockaddr_ptr, sizeof(src));
+            store_ipv6(addr.storage_, src.sin6_addr, src.sin6_port, src.sin6_scope_id);
         } else {
-            throw std::invalid_argument("Invalid IP address: " + ip_str);
+            return make_unexpected(ErrorCode::UnsupportedAddressFamily);
+        }
+        return addr;
+    }
+
+    std::string Addr::ip() const {
+        char buf[INET6_ADDRSTRLEN] = {};
+        const auto* addr = reinterpret_cast<const sockaddr*>(storage_);
+
+        if (addr->sa_family == AF_INET) {
+            inet_ntop(AF_INET, &reinterpret_cast<const sockaddr_in*>(storage_)->sin_addr, buf, sizeof(buf));
+        } else if (addr->sa_family == AF_INET6) {
+            inet_ntop(AF_INET6, &reinterpret_cast<const sockaddr_in6*>(storage_)->sin6_addr, buf, sizeof(buf));
         }
+        return buf;
     }
 
-    const void* Addr::sockaddrData() const {
-        return static_cast<const void*>(storage_);
+    bool Addr::isIPv6() const noexcept {
+        return reinterpret_cast<const sockaddr*>(storage_)->sa_family == AF_INET6;
     }
 
-    size_t Addr::sockaddrLen() const {
+    size_t Addr::sockaddrLen() const noexcept {
         const sockaddr* addr = reinterpret_cast<const sockaddr*>(storage_);
         return (addr->sa_family == AF_INET) ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
     }
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <sys/socket.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <time.h>
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#endif
+
+namespace pulse::net::udp {
+
+#if defined(__linux__)
+
+    // Software stamps only: hardware stamps come from the NIC's clock and need device setup we don't do.
+    constexpr int kRxTimestampingFlags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+    // OPT_ID numbers each send so the stamps can be matched up; OPT_TSONLY keeps the payload off the error queue.
+    constexpr int kTxTimestampingFlags = SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE |
+                                         SOF_TIMESTAMPING_OPT_ID | SOF_TIMESTAMPING_OPT_TSONLY;
+
+    // Control space for one SCM_TIMESTAMPING message.
+    constexpr size_t kTimestampControlSize = CMSG_SPACE(sizeof(scm_timestamping));
+
+    // The software stamp out of an SCM_TIMESTAMPING control message; 0 if the message has none.
+    inline int64_t read_software_timestamp(const cmsghdr* cmsg) {
+        scm_timestamping stamps;
+        std::memcpy(&stamps, CMSG_DATA(cmsg), sizeof(stamps));
+        return static_cast<int64_t>(stamps.ts[0].tv_sec) * 1'000'000'000 + stamps.ts[0].tv_nsec;
+    }
+
+    // Control space for one SO_RXQ_OVFL drop counter.
+    constexpr size_t kDropCountControlSize = CMSG_SPACE(sizeof(uint32_t));
+
+    // Enough control space for everything a receive can ask for.
+    constexpr size_t kRecvControlSize = kTimestampControlSize + kDropCountControlSize;
+
+    // Control space a receive needs with these options on; 0 means pass no control buffer at all.
+    constexpr size_t recv_control_size(bool timestamps, bool drop_counts) {
+        return (timestamps ? kTimestampControlSize : 0) + (drop_counts ? kDropCountControlSize : 0);
+    }
+
+    // The kernel's running count of datagrams it dropped on the socket, out of an SO_RXQ_OVFL message.
+    inline uint32_t read_drop_count(const cmsghdr* cmsg) {
+        uint32_t drops = 0;
+        std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+        return drops;
+    }
+
+    struct RxControl {
+        int64_t timestamp_ns = 0; // 0 without an SCM_TIMESTAMPING message
+        uint32_t drops = 0; // 0 without an SO_RXQ_OVFL message, which the kernel leaves out until the first drop
+    };
+
+    inline RxControl read_rx_control(msghdr& msg) {
+        RxControl control;
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_SOCKET) {
+                continue;
+            }
+            if (cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                control.timestamp_ns = read_software_timestamp(cmsg);
+            } else if (cmsg->cmsg_type == SO_RXQ_OVFL) {
+                control.drops = read_drop_count(cmsg);
+            }
+        }
+        return control;
+    }
+
+#if !defined(SCM_TXTIME)
+    constexpr int SO_TXTIME = 61; // Linux 4.19+; older libc headers lack these.
+    constexpr int SCM_TXTIME = SO_TXTIME;
+#endif
+
+    // Control space for one SCM_TXTIME departure time.
+    constexpr size_t kTxTimeControlSize = CMSG_SPACE(sizeof(uint64_t));
+
+    // Points `msg` at `control` and writes `departure_ns` (CLOCK_MONOTONIC) into it as SCM_TXTIME.
+    inline void write_tx_time(msghdr& msg, char* control, uint64_t departure_ns) {
+        msg.msg_control = control;
+        msg.msg_controllen = kTxTimeControlSize;
+        cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(departure_ns));
+        std::memcpy(CMSG_DATA(cmsg), &departure_ns, sizeof(departure_ns));
+    }
+
+#endif
+
+} // namespace pulse::net::udp
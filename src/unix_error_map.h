@@ -0,0 +1,40 @@
+#pragma once
+
+#include <pulse/net/udp/error_code.h>
+
+#include <errno.h>
+#include <expected>
+
+namespace pulse::net::udp {
+
+    [[nodiscard("Why ask for an ErrorCode and then ignore it?")]]
+    inline std::unexpected<Error> map_send_error(int err) {
+        switch (err) {
+            case EWOULDBLOCK:
+                return make_unexpected(ErrorCode::WouldBlock, err);
+            case EBADF:
+            case ENOTSOCK:
+                return make_unexpected(ErrorCode::InvalidSocket, err);
+            case ECONNRESET:
+                return make_unexpected(ErrorCode::ConnectionReset, err);
+            default:
+                return make_unexpected(ErrorCode::SendFailed, err);
+        }
+    }
+
+    [[nodiscard("Why ask for an ErrorCode and then ignore it?")]]
+    inline std::unexpected<Error> map_rev_error(int err) {
+        switch (err) {
+            case EWOULDBLOCK:
+                return make_unexpected(ErrorCode::WouldBlock, err);
+
+            case EBADF:
+            case ENOTSOCK:
+                return make_unexpected(ErrorCode::InvalidSocket, err);
+
+            default:
+                return make_unexpected(ErrorCode::RecvFailed, err);
+        }
+    }
+
+} // namespace pulse::net::udp
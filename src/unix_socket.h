@@ -5,13 +5,24 @@
 #include <pulse/net/udp/error_code.h>
 #include <pulse/net/udp/udp_addr.h>
 
+#include "capture_tap.h"
+#include "socket_counters.h"
+#include "pacer.h"
+
+#include <array>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
 struct sockaddr;
+struct msghdr;
 
 namespace pulse::net::udp {
 
-    class SocketUnix : public ISocket {
+    class SocketUnix final : public ISocket {
     public:
-        SocketUnix(int sockfd) : sockfd_(sockfd) {}
+        explicit SocketUnix(int sockfd, const SocketOptions& options = {});
         ~SocketUnix() override {
             close();
         }
@@ -21,29 +32,170 @@ namespace pulse::net::udp {
     
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         std::expected<void, Error> send(const uint8_t* data, size_t length) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendBatch(std::span<OutgoingPacket> packets) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segmentSize) override;
     
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         std::expected<ReceivedPacket, Error> recvFrom() override;
     
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         std::expected<ReceivedPacket, Error> recvFrom(ReceivedPacket&& packet) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatch(std::span<ReceivedPacket> packets) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> readTxTimestamps(std::span<TxTimestamp> timestamps) override;
     
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<SocketMetrics, Error> metrics() const override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> setPacingRate(const Addr& addr, uint64_t bytesPerSecond) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int64_t, Error> flushPaced() override;
+
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         std::expected<int, Error> getHandle() const override;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        SpinBudget* spinBudget() noexcept override {
+            return &spin_budget_;
+        }
     
         void close() override;
 
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
-        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bindAddr);
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bindAddr, const SocketOptions& options = {});
         
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
-        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remoteAddr);
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const Addr& bindAddr, size_t shards, const SocketOptions& options = {});
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remoteAddr, const SocketOptions& options = {});
     
+        // Raw descriptors for backends that drive the kernel socket themselves. The caller owns the fd.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<int, Error> OpenBound(const Addr& bindAddr, const SocketOptions& options = {});
+
+        // `shards` descriptors bound to the same address with SO_REUSEPORT (Linux only).
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::vector<int>, Error> OpenBoundGroup(const Addr& bindAddr, size_t shards, const SocketOptions& options = {});
+
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
-        static std::expected<Addr, Error> DecodeAddr(const sockaddr* addr);
+        static std::expected<int, Error> OpenConnected(const Addr& remoteAddr, const SocketOptions& options = {});
     
+        // Null unless the socket was created with SocketOptions::metrics. Backends layered on this socket
+        // record into the same counters.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        SocketCounters* counters() const noexcept { return counters_.get(); }
+
+        // Null unless the socket was created with SocketOptions::capture; shared the same way.
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        CaptureTap* tap() const noexcept { return tap_.get(); }
+
     private:
+        // One coalesced UDP_GRO read: `length` bytes at `data`, split into `segment_size` datagrams from `addr`.
+        struct GroRead {
+            uint8_t* data = nullptr;
+            size_t length = 0;
+            size_t segment_size = 0;
+            Addr addr;
+            int64_t timestamp_ns = 0;
+        };
+
+        static constexpr size_t kGroSlots = 16;
+        static constexpr size_t kGroSlotSize = 65536;
+
+        // The unrecorded operations behind the public ones, which add them to counters_ once they return.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmitTo(const Addr& addr, const uint8_t* data, size_t length);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmit(const uint8_t* data, size_t length);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> transmitBatch(std::span<OutgoingPacket> packets);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> transmitSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> receiveView();
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> receiveInto(ReceivedPacket&& packet);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> receiveBatch(std::span<ReceivedPacket> packets);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendSegmentedBatch(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size);
+
+        // Sets up SocketOptions::pacingRate: SO_TXTIME where the kernel takes it and the mode allows,
+        // else the userspace queue. `remote` is the dialed peer, which connected sends are paced towards.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> enablePacing(const SocketOptions& options, const Addr* remote);
+
+        // One paced datagram: stamped and sent now under kernel pacing, sent or queued under userspace.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmitPaced(const Addr& addr, bool connected, const uint8_t* data, size_t length);
+
+        // sendto()/send() with an optional SCM_TXTIME departure time (0 for none).
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmitAt(const Addr& addr, bool connected, const uint8_t* data, size_t length, uint64_t departure_ns);
+
+        // Sends the queued datagrams due by `now_ns`; see flushPaced().
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int64_t, Error> releasePaced(int64_t now_ns);
+
+        // Receive stamp out of a datagram's control messages (0 if none); passes on any drop count to counters_.
+        int64_t readRxControl(msghdr& msg) noexcept;
+
+        // Turns on UDP_GRO and allocates the coalescing arena. Returns false if the kernel refuses.
+        bool enableGro();
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> fillGroReads();
+
+        // Next logical datagram out of the arena, as a view that stays valid until the next receive call.
+        // Segments over the maximum datagram size are consumed and reported as Truncated.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> nextGroSegment();
+
+        // Reports a truncation that recvBatch() had to hold back because it returned other datagrams.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        bool takePendingTruncation() noexcept {
+            return std::exchange(truncation_pending_, false);
+        }
+
         int sockfd_;
+        size_t max_datagram_size_;
+        std::unique_ptr<uint8_t[]> recv_buffer_; // Behind recvFrom() without a caller buffer
+        bool truncation_pending_ = false;
+        bool tx_timestamps_;
+        size_t control_size_; // Control buffer each receive passes the kernel; 0 passes none
+        std::unique_ptr<SocketCounters> counters_;
+        std::unique_ptr<CaptureTap> tap_;
+        bool gso_supported_; // Probed at creation; cleared if the device or route can't segment
+
+        std::unique_ptr<Pacer> pacer_; // Null unless SocketOptions::pacingRate is set
+        std::unique_ptr<PacedQueue> paced_; // Userspace pacing only
+        std::optional<Error> paced_error_; // First queued datagram a send released and the OS refused
+        bool kernel_pacing_ = false;
+        Addr peer_; // Dialed remote, for pacing send()
+
+        std::unique_ptr<uint8_t[]> gro_arena_; // Null unless UDP_GRO is enabled
+        std::array<GroRead, kGroSlots> gro_reads_{};
+        size_t gro_read_count_ = 0;
+        size_t gro_read_index_ = 0;
+        size_t gro_offset_ = 0;
+        SpinBudget spin_budget_; // What recvFromUntil() has learned about arrival gaps here
         
     };
 
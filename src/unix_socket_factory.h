@@ -7,12 +7,27 @@ namespace pulse::net::udp {
 
     class UnixSocketFactory : public ISocketFactory {
     public:
+        using ISocketFactory::listen;
+        using ISocketFactory::dial;
+
         std::expected<std::unique_ptr<ISocket>, Error> listen(const Addr& bind_addr) override {
-            return SocketUnix::Listen(bind_addr);
+            return SocketUnix::Listen(bind_addr, {});
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> listenWithOptions(const Addr& bind_addr, const SocketOptions& options) override {
+            return SocketUnix::Listen(bind_addr, options);
+        }
+
+        std::expected<std::vector<std::unique_ptr<ISocket>>, Error> listenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options = {}) override {
+            return SocketUnix::ListenSharded(bind_addr, shards, options);
         }
 
         std::expected<std::unique_ptr<ISocket>, Error> dial(const Addr& remote_addr) override {
-            return SocketUnix::Dial(remote_addr);
+            return SocketUnix::Dial(remote_addr, {});
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> dialWithOptions(const Addr& remote_addr, const SocketOptions& options) override {
+            return SocketUnix::Dial(remote_addr, options);
         }
     };
 
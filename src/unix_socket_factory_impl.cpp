@@ -2,14 +2,29 @@
 #include <pulse/net/udp/udp.h>
 #include <pulse/net/udp/error_code.h>
 #include <pulse/net/udp/udp_addr.h>
+#include <pulse/net/udp/reactor.h>
+#include <pulse/net/udp/async.h>
 
 #include "unix_socket_factory.h"
+#if defined(PULSENET_UDP_HAS_IO_URING)
+#include "io_uring_socket_factory.h"
+#endif
+#if defined(PULSENET_UDP_HAS_XDP)
+#include "xdp_socket_factory.h"
+#endif
+#if defined(__linux__)
+#include "epoll_reactor.h"
+#include "epoll_event_loop.h"
+#endif
 
 namespace pulse::net::udp {
 
     namespace {
         ISocketFactory * current_factory = nullptr;
         UnixSocketFactory default_socket_factory;
+#if defined(PULSENET_UDP_HAS_IO_URING)
+        IoUringSocketFactory io_uring_socket_factory;
+#endif
     }
 
     ISocketFactory * get_socket_factory() {
@@ -28,5 +43,65 @@ namespace pulse::net::udp {
     {
         current_factory = nullptr;
     }
+
+    std::expected<ISocketFactory *, Error> get_io_uring_socket_factory()
+    {
+#if defined(PULSENET_UDP_HAS_IO_URING)
+        // Probe once with a throwaway socket so callers find out now rather than on their first listen().
+        static const std::expected<void, Error> supported = []() -> std::expected<void, Error> {
+            auto addr = Addr::Create("127.0.0.1", 0);
+            if (!addr) {
+                return std::unexpected(addr.error());
+            }
+            auto probe = SocketIoUring::Listen(*addr);
+            if (!probe) {
+                return std::unexpected(probe.error());
+            }
+            return {};
+        }();
+
+        if (!supported) {
+            return std::unexpected(supported.error());
+        }
+        return &io_uring_socket_factory;
+#else
+        return make_unexpected(ErrorCode::Unsupported);
+#endif
+    }
     
+    std::expected<std::unique_ptr<ISocketFactory>, Error> create_xdp_socket_factory(const XdpOptions& options)
+    {
+#if defined(PULSENET_UDP_HAS_XDP)
+        if (options.ringSize == 0 || (options.ringSize & (options.ringSize - 1)) != 0) {
+            return make_unexpected(ErrorCode::InvalidArgument, "ringSize must be a power of two");
+        }
+        try {
+            return std::make_unique<XdpSocketFactory>(options);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+#else
+        (void)options;
+        return make_unexpected(ErrorCode::Unsupported);
+#endif
+    }
+
+    std::expected<std::unique_ptr<Reactor>, Error> create_reactor()
+    {
+#if defined(__linux__)
+        return EpollReactor::Create();
+#else
+        return make_unexpected(ErrorCode::Unsupported);
+#endif
+    }
+
+    std::expected<std::unique_ptr<EventLoop>, Error> create_event_loop()
+    {
+#if defined(__linux__)
+        return EpollEventLoop::Create();
+#else
+        return make_unexpected(ErrorCode::Unsupported);
+#endif
+    }
+
 } // namespace pulse::net::udp
\ No newline at end of file
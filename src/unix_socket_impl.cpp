@@ -6,45 +6,509 @@
 #include <arpa/inet.h>
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 #include <errno.h>
+#include <time.h>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <string_view>
+#include <utility>
+
+#if defined(__linux__)
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/pkt_sched.h>
+#endif
 
 #include "unix_socket.h"
+#include "unix_error_map.h"
+#include "unix_control_messages.h"
+#include "socket_options_check.h"
 
 namespace pulse::net::udp {
 
-    constexpr size_t kPacketBufferSize = 2048;
-    
-    [[nodiscard("Why ask for an ErrorCode and then ignore it?")]]
-    inline std::unexpected<Error> map_send_error(int err) {
-        switch (err) {
-            case EWOULDBLOCK:
-                return make_unexpected(ErrorCode::WouldBlock);
-            case EBADF:
-            case ENOTSOCK:
-                return make_unexpected(ErrorCode::InvalidSocket);
-            case ECONNRESET:
-                return make_unexpected(ErrorCode::ConnectionReset);
-            default:
-                return make_unexpected(ErrorCode::SendFailed);
+    constexpr size_t kMaxBatchSize = 64; // Datagrams handed to the kernel per recvmmsg/sendmmsg call
+    constexpr size_t kMaxGsoSegments = 64; // UDP_MAX_SEGMENTS on every kernel that supports UDP_SEGMENT
+    constexpr size_t kMaxGsoBytes = 65507; // Largest UDP payload an IPv4 datagram can carry
+
+#if defined(__linux__) && !defined(UDP_SEGMENT)
+    constexpr int UDP_SEGMENT = 103; // Older libc headers lack these; the kernel ABI values are stable.
+#endif
+#if defined(__linux__) && !defined(UDP_GRO)
+    constexpr int UDP_GRO = 104;
+#endif
+#if defined(__linux__) && !defined(SO_PREFER_BUSY_POLL)
+    constexpr int SO_PREFER_BUSY_POLL = 69;
+#endif
+
+    namespace {
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> set_int_option(int sockfd, int level, int name, int value, const char* label) {
+            if (::setsockopt(sockfd, level, name, &value, sizeof(value)) < 0) {
+                return make_unexpected(ErrorCode::SocketConfigFailed, errno, label);
+            }
+            return {};
         }
+
+        // Applies every option the caller set, stopping at the first one the OS refuses.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> apply_socket_options(int sockfd, int family, const SocketOptions& options) {
+            std::expected<void, Error> result;
+            auto set = [&](bool wanted, int level, int name, int value, const char* label) {
+                if (wanted && result) {
+                    result = set_int_option(sockfd, level, name, value, label);
+                }
+            };
+
+            set(options.reuseAddress, SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR");
+            set(options.reusePort, SOL_SOCKET, SO_REUSEPORT, 1, "SO_REUSEPORT");
+            set(options.receiveBufferSize.has_value(), SOL_SOCKET, SO_RCVBUF, options.receiveBufferSize.value_or(0), "SO_RCVBUF");
+            set(options.sendBufferSize.has_value(), SOL_SOCKET, SO_SNDBUF, options.sendBufferSize.value_or(0), "SO_SNDBUF");
+            if (family == AF_INET6) {
+                set(options.tos.has_value(), IPPROTO_IPV6, IPV6_TCLASS, options.tos.value_or(0), "IPV6_TCLASS");
+            } else {
+                set(options.tos.has_value(), IPPROTO_IP, IP_TOS, options.tos.value_or(0), "IP_TOS");
+            }
+#if defined(__linux__)
+            set(options.priority.has_value(), SOL_SOCKET, SO_PRIORITY, options.priority.value_or(0), "SO_PRIORITY");
+            set(options.busyPollMicros.has_value(), SOL_SOCKET, SO_BUSY_POLL, options.busyPollMicros.value_or(0), "SO_BUSY_POLL");
+            set(options.preferBusyPoll, SOL_SOCKET, SO_PREFER_BUSY_POLL, 1, "SO_PREFER_BUSY_POLL");
+            set(options.incomingCpu.has_value(), SOL_SOCKET, SO_INCOMING_CPU, options.incomingCpu.value_or(0), "SO_INCOMING_CPU");
+            const int timestamping = (options.rxTimestamps ? kRxTimestampingFlags : 0) | (options.txTimestamps ? kTxTimestampingFlags : 0);
+            set(timestamping != 0, SOL_SOCKET, SO_TIMESTAMPING, timestamping, "SO_TIMESTAMPING");
+            set(options.metrics, SOL_SOCKET, SO_RXQ_OVFL, 1, "SO_RXQ_OVFL");
+#else
+            auto unsupported = [&](bool wanted, const char* label) {
+                if (wanted && result) {
+                    result = make_unexpected(ErrorCode::Unsupported, label);
+                }
+            };
+            unsupported(options.priority.has_value(), "SO_PRIORITY");
+            unsupported(options.busyPollMicros.has_value(), "SO_BUSY_POLL");
+            unsupported(options.preferBusyPoll, "SO_PREFER_BUSY_POLL");
+            unsupported(options.incomingCpu.has_value(), "SO_INCOMING_CPU");
+            unsupported(options.rxTimestamps || options.txTimestamps, "SO_TIMESTAMPING");
+#endif
+            return result;
+        }
+
+        int64_t monotonic_ns() noexcept {
+            timespec now{};
+            ::clock_gettime(CLOCK_MONOTONIC, &now);
+            return static_cast<int64_t>(now.tv_sec) * 1'000'000'000 + now.tv_nsec;
+        }
+
+        // The socket is bound, and connected if dialed, by the time it's wrapped, so both ends are known.
+        std::unique_ptr<CaptureTap> make_capture_tap(int sockfd, std::shared_ptr<PacketCapture> capture) {
+            sockaddr_storage name{};
+            socklen_t name_len = sizeof(name);
+            Addr local;
+            if (::getsockname(sockfd, reinterpret_cast<sockaddr*>(&name), &name_len) == 0) {
+                local = Addr::FromSockaddr(&name, name_len).value_or(Addr{});
+            }
+            std::optional<Addr> peer;
+            name_len = sizeof(name);
+            if (::getpeername(sockfd, reinterpret_cast<sockaddr*>(&name), &name_len) == 0) {
+                if (auto decoded = Addr::FromSockaddr(&name, name_len)) {
+                    peer = *decoded;
+                }
+            }
+            return std::make_unique<CaptureTap>(std::move(capture), local, peer);
+        }
+
+        // Kernels without UDP_SEGMENT don't know the option, and would silently ignore the control message.
+        bool probe_gso([[maybe_unused]] int sockfd) noexcept {
+#if defined(__linux__)
+            int segment = 0;
+            socklen_t length = sizeof(segment);
+            return ::getsockopt(sockfd, SOL_UDP, UDP_SEGMENT, &segment, &length) == 0;
+#else
+            return false;
+#endif
+        }
+
+#if defined(__linux__)
+        // The interface that owns the socket's local address, or 0 when there isn't exactly one (wildcard binds).
+        unsigned egress_ifindex(int sockfd) {
+            sockaddr_storage name{};
+            socklen_t name_len = sizeof(name);
+            if (::getsockname(sockfd, reinterpret_cast<sockaddr*>(&name), &name_len) < 0) {
+                return 0;
+            }
+            ifaddrs* addrs = nullptr;
+            if (::getifaddrs(&addrs) < 0) {
+                return 0;
+            }
+            unsigned ifindex = 0;
+            for (ifaddrs* it = addrs; it != nullptr && ifindex == 0; it = it->ifa_next) {
+                if (it->ifa_addr == nullptr || it->ifa_addr->sa_family != name.ss_family) {
+                    continue;
+                }
+                bool same = false;
+                if (name.ss_family == AF_INET) {
+                    same = reinterpret_cast<const sockaddr_in*>(it->ifa_addr)->sin_addr.s_addr
+                        == reinterpret_cast<const sockaddr_in*>(&name)->sin_addr.s_addr;
+                } else if (name.ss_family == AF_INET6) {
+                    same = std::memcmp(&reinterpret_cast<const sockaddr_in6*>(it->ifa_addr)->sin6_addr,
+                                       &reinterpret_cast<const sockaddr_in6*>(&name)->sin6_addr, sizeof(in6_addr)) == 0;
+                }
+                if (same) {
+                    ifindex = ::if_nametoindex(it->ifa_name);
+                }
+            }
+            ::freeifaddrs(addrs);
+            return ifindex;
+        }
+
+        // Whether the socket's egress interface has a qdisc that honours SO_TXTIME stamps: fq or etf at the
+        // root, or under every queue of an mq/mqprio root. Anything unknown counts as no.
+        bool egress_honours_txtime(int sockfd) {
+            const unsigned ifindex = egress_ifindex(sockfd);
+            if (ifindex == 0) {
+                return false;
+            }
+            const int nl = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+            if (nl < 0) {
+                return false;
+            }
+            struct {
+                nlmsghdr header;
+                tcmsg tc;
+            } request{};
+            request.header.nlmsg_len = sizeof(request);
+            request.header.nlmsg_type = RTM_GETQDISC;
+            request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+            request.tc.tcm_family = AF_UNSPEC;
+            request.tc.tcm_ifindex = static_cast<int>(ifindex);
+            if (::send(nl, &request, sizeof(request), 0) < 0) {
+                ::close(nl);
+                return false;
+            }
+
+            auto pacing_kind = [](std::string_view kind) { return kind == "fq" || kind == "etf"; };
+            std::string_view root_kind;
+            std::array<char, 16> root_kind_storage{};
+            uint32_t root_handle = 0;
+            size_t children = 0;
+            bool children_pace = true;
+            bool done = false;
+            alignas(nlmsghdr) std::array<char, 16384> buffer;
+            while (!done) {
+                const ssize_t received = ::recv(nl, buffer.data(), buffer.size(), 0);
+                if (received <= 0) {
+                    break;
+                }
+                auto remaining = static_cast<int>(received);
+                for (auto* msg = reinterpret_cast<nlmsghdr*>(buffer.data()); NLMSG_OK(msg, remaining); msg = NLMSG_NEXT(msg, remaining)) {
+                    if (msg->nlmsg_type == NLMSG_DONE || msg->nlmsg_type == NLMSG_ERROR) {
+                        done = true;
+                        break;
+                    }
+                    if (msg->nlmsg_type != RTM_NEWQDISC) {
+                        continue;
+                    }
+                    const auto* tc = static_cast<const tcmsg*>(NLMSG_DATA(msg));
+                    if (tc->tcm_ifindex != static_cast<int>(ifindex)) {
+                        continue; // Older kernels dump every interface regardless of tcm_ifindex
+                    }
+                    std::string_view kind;
+                    auto attr_len = static_cast<int>(msg->nlmsg_len - NLMSG_LENGTH(sizeof(tcmsg)));
+                    for (const auto* attr = reinterpret_cast<const rtattr*>(reinterpret_cast<const char*>(tc) + NLMSG_ALIGN(sizeof(tcmsg)));
+                         RTA_OK(attr, attr_len); attr = RTA_NEXT(attr, attr_len)) {
+                        if (attr->rta_type == TCA_KIND) {
+                            kind = std::string_view(static_cast<const char*>(RTA_DATA(attr)), ::strnlen(static_cast<const char*>(RTA_DATA(attr)), RTA_PAYLOAD(attr)));
+                        }
+                    }
+                    if (tc->tcm_parent == TC_H_ROOT) {
+                        const size_t length = std::min(kind.size(), root_kind_storage.size());
+                        std::memcpy(root_kind_storage.data(), kind.data(), length);
+                        root_kind = std::string_view(root_kind_storage.data(), length);
+                        root_handle = tc->tcm_handle;
+                    } else if (tc->tcm_parent != TC_H_INGRESS) {
+                        // The kernel dumps the root before anything attached below it.
+                        ++children;
+                        children_pace = children_pace && pacing_kind(kind) && root_handle != 0 && TC_H_MAJ(tc->tcm_parent) == TC_H_MAJ(root_handle);
+                    }
+                }
+            }
+            ::close(nl);
+
+            if (pacing_kind(root_kind)) {
+                return true;
+            }
+            return (root_kind == "mq" || root_kind == "mqprio") && children > 0 && children_pace;
+        }
+#endif
+
+    } // namespace
+
+    SocketUnix::SocketUnix(int sockfd, const SocketOptions& options)
+        : sockfd_(sockfd),
+          max_datagram_size_(options.maxDatagramSize),
+          recv_buffer_(std::make_unique_for_overwrite<uint8_t[]>(options.maxDatagramSize)),
+          tx_timestamps_(options.txTimestamps),
+#if defined(__linux__)
+          control_size_(recv_control_size(options.rxTimestamps, options.metrics)),
+#else
+          control_size_(0),
+#endif
+          counters_(options.metrics ? std::make_unique<SocketCounters>() : nullptr),
+          tap_(options.capture ? make_capture_tap(sockfd, options.capture) : nullptr),
+          gso_supported_(probe_gso(sockfd)) {}
+
+    std::expected<void, Error> SocketUnix::sendTo(const Addr& addr, const uint8_t* data, size_t length) {
+        auto result = transmitTo(addr, data, length);
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, addr, data, length);
+        }
+        return result;
+    }
+
+    std::expected<void, Error> SocketUnix::send(const uint8_t* data, size_t length) {
+        auto result = transmit(data, length);
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, data, length);
+        }
+        return result;
     }
-    
-    [[nodiscard("Why ask for an ErrorCode and then ignore it?")]]
-    inline std::unexpected<Error> map_rev_error(int err) {
-        switch (errno) {
-            case EWOULDBLOCK:
-                return make_unexpected(ErrorCode::WouldBlock);
 
-            case EBADF:
-            case ENOTSOCK:
-                return make_unexpected(ErrorCode::InvalidSocket);
+    std::expected<size_t, Error> SocketUnix::sendBatch(std::span<OutgoingPacket> packets) {
+        auto result = transmitBatch(packets);
+        if (counters_) {
+            counters_->recordSendBatch(packets);
+        }
+        if (tap_) {
+            tap_->recordSendBatch(packets);
+        }
+        return result;
+    }
 
-            default:
-                return make_unexpected(ErrorCode::RecvFailed);
+    std::expected<size_t, Error> SocketUnix::sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        auto result = transmitSegmented(addr, data, length, segment_size);
+        if (counters_) {
+            counters_->recordSendSegmented(result, length, segment_size);
         }
+        if (tap_) {
+            tap_->recordSendSegmented(result, addr, data, length, segment_size);
+        }
+        return result;
     }
 
-    std::expected<void, Error> SocketUnix::sendTo(const Addr& addr, const uint8_t* data, size_t length) {
+    std::expected<ReceivedPacket, Error> SocketUnix::recvFrom() {
+        auto result = receiveView();
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketUnix::recvFrom(ReceivedPacket&& packet) {
+        auto result = receiveInto(std::move(packet));
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketUnix::recvBatch(std::span<ReceivedPacket> packets) {
+        auto result = receiveBatch(packets);
+        if (counters_) {
+            counters_->recordRecvBatch(result, packets);
+        }
+        if (tap_) {
+            tap_->recordRecvBatch(result, packets);
+        }
+        return result;
+    }
+
+    std::expected<SocketMetrics, Error> SocketUnix::metrics() const {
+        if (!counters_) {
+            return make_unexpected(ErrorCode::InvalidArgument, "metrics not enabled in SocketOptions");
+        }
+        return counters_->snapshot();
+    }
+
+    std::expected<void, Error> SocketUnix::setPacingRate(const Addr& addr, uint64_t bytes_per_second) {
+        if (!pacer_) {
+            return make_unexpected(ErrorCode::InvalidArgument, "pacingRate not set in SocketOptions");
+        }
+        return pacer_->setRate(addr, bytes_per_second);
+    }
+
+    std::expected<int64_t, Error> SocketUnix::flushPaced() {
+        if (!paced_) {
+            return -1;
+        }
+        auto result = releasePaced(monotonic_ns());
+        if (paced_error_) {
+            // A send released the datagram earlier and the OS refused it; that's reported first.
+            auto error = std::unexpected(*paced_error_);
+            paced_error_.reset();
+            return error;
+        }
+        if (!result && result.error() == ErrorCode::WouldBlock) {
+            return 0; // Due now; the socket buffer has to drain first
+        }
+        return result;
+    }
+
+    std::expected<void, Error> SocketUnix::enablePacing(const SocketOptions& options, const Addr* remote) {
+        if (!options.pacingRate) {
+            return {};
+        }
+        pacer_ = std::make_unique<Pacer>(*options.pacingRate);
+        if (remote) {
+            peer_ = *remote;
+        }
+
+#if defined(__linux__)
+        // Auto only trusts the kernel when it can see fq or etf on the way out; without them the stamps are
+        // ignored and nothing is paced at all.
+        if (options.pacingMode == PacingMode::Kernel || (options.pacingMode == PacingMode::Auto && egress_honours_txtime(sockfd_))) {
+            // fq reads departure times on the monotonic clock; no error reports, a late stamp just goes now.
+            sock_txtime txtime{ .clockid = CLOCK_MONOTONIC, .flags = 0 };
+            if (::setsockopt(sockfd_, SOL_SOCKET, SO_TXTIME, &txtime, sizeof(txtime)) == 0) {
+                kernel_pacing_ = true;
+                if (*options.pacingRate > 0) {
+                    // Belt and braces for datagrams fq sees without a stamp. Kernels since 4.20 take a u64;
+                    // older ones only an unsigned int, where ~0U means no cap.
+                    const uint64_t rate = *options.pacingRate;
+                    if (::setsockopt(sockfd_, SOL_SOCKET, SO_MAX_PACING_RATE, &rate, sizeof(rate)) < 0) {
+                        const auto narrow = static_cast<unsigned>(std::min<uint64_t>(rate, std::numeric_limits<unsigned>::max() - 1));
+                        if (::setsockopt(sockfd_, SOL_SOCKET, SO_MAX_PACING_RATE, &narrow, sizeof(narrow)) < 0) {
+                            return make_unexpected(ErrorCode::SocketConfigFailed, errno, "SO_MAX_PACING_RATE");
+                        }
+                    }
+                }
+                return {};
+            }
+            if (options.pacingMode == PacingMode::Kernel) {
+                return make_unexpected(ErrorCode::Unsupported, errno, "SO_TXTIME");
+            }
+        }
+#else
+        if (options.pacingMode == PacingMode::Kernel) {
+            return make_unexpected(ErrorCode::Unsupported, "SO_TXTIME");
+        }
+#endif
+        paced_ = std::make_unique<PacedQueue>(options.pacingQueueSize, max_datagram_size_);
+        return {};
+    }
+
+    std::expected<void, Error> SocketUnix::transmitPaced(const Addr& addr, bool connected, const uint8_t* data, size_t length) {
+        const int64_t now_ns = monotonic_ns();
+        if (kernel_pacing_) {
+            const auto booking = pacer_->book(addr, length, now_ns);
+            auto sent = transmitAt(addr, connected, data, length, static_cast<uint64_t>(booking.departure_ns));
+            if (!sent) {
+                pacer_->cancel(addr, booking); // Retries, and the datagrams after it, shouldn't pay for it twice
+            }
+            return sent;
+        }
+
+        if (sockfd_ == -1) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        if (length > max_datagram_size_) {
+            return make_unexpected(ErrorCode::SendFailed, EMSGSIZE); // Too big for a queue slot
+        }
+        // Whatever is already due goes first, so datagrams to one destination keep their order.
+        if (!paced_->empty()) {
+            // A refused datagram isn't this one's failure; the next flushPaced() reports it.
+            if (auto released = releasePaced(now_ns); !released && released.error() != ErrorCode::WouldBlock && !paced_error_) {
+                paced_error_ = released.error();
+            }
+        }
+        if (paced_->full()) {
+            return make_unexpected(ErrorCode::WouldBlock);
+        }
+
+        const auto booking = pacer_->book(addr, length, now_ns);
+        if (booking.departure_ns <= now_ns && paced_->empty()) {
+            auto sent = transmitAt(addr, connected, data, length, 0);
+            if (!sent && sent.error() != ErrorCode::WouldBlock) {
+                pacer_->cancel(addr, booking);
+            }
+            if (sent || sent.error() != ErrorCode::WouldBlock) {
+                return sent;
+            }
+            // The socket buffer is full; the queue holds it until flushPaced() finds room.
+        }
+        (void)paced_->push(booking.departure_ns, addr, connected, data, length);
+        return {};
+    }
+
+    std::expected<void, Error> SocketUnix::transmitAt(const Addr& addr, bool connected, const uint8_t* data, size_t length, uint64_t departure_ns) {
+        iovec iov{ .iov_base = const_cast<uint8_t*>(data), .iov_len = length };
+        msghdr msg{};
+        if (!connected) {
+            msg.msg_name = const_cast<void*>(addr.sockaddrData());
+            msg.msg_namelen = static_cast<socklen_t>(addr.sockaddrLen());
+        }
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+#if defined(__linux__)
+        alignas(cmsghdr) char control[kTxTimeControlSize];
+        if (departure_ns != 0) {
+            write_tx_time(msg, control, departure_ns);
+        }
+#else
+        (void)departure_ns;
+#endif
+
+        ssize_t sent = ::sendmsg(sockfd_, &msg, 0);
+        if (sent < 0) {
+            return map_send_error(errno);
+        }
+        if (sent != static_cast<ssize_t>(length)) {
+            return make_unexpected(ErrorCode::PartialSend);
+        }
+        return {};
+    }
+
+    std::expected<int64_t, Error> SocketUnix::releasePaced(int64_t now_ns) {
+        std::expected<int64_t, Error> result = -1;
+        while (!paced_->empty()) {
+            const auto& entry = paced_->front();
+            if (entry.departure_ns > now_ns) {
+                if (result) {
+                    result = entry.departure_ns - now_ns;
+                }
+                break;
+            }
+            auto sent = transmitAt(entry.addr, entry.connected, paced_->data_of(entry), entry.size, 0);
+            if (!sent && sent.error() == ErrorCode::WouldBlock) {
+                return std::unexpected(sent.error()); // Still queued; try again once the buffer drains
+            }
+            if (!sent && result) {
+                result = std::unexpected(sent.error());
+            }
+            paced_->pop();
+        }
+        return result;
+    }
+
+    std::expected<void, Error> SocketUnix::transmitTo(const Addr& addr, const uint8_t* data, size_t length) {
+        if (pacer_) {
+            return transmitPaced(addr, false, data, length);
+        }
+
         ssize_t sent = sendto(
             sockfd_,
             data,
@@ -65,7 +529,11 @@ namespace pulse::net::udp {
         return {}; // success
     }
 
-    std::expected<void, Error> SocketUnix::send(const uint8_t* data, size_t length) {
+    std::expected<void, Error> SocketUnix::transmit(const uint8_t* data, size_t length) {
+        if (pacer_) {
+            return transmitPaced(peer_, true, data, length);
+        }
+
         ssize_t sent = ::send(sockfd_, data, length, 0);
 
         if (sent < 0) {
@@ -79,36 +547,301 @@ namespace pulse::net::udp {
         return {}; // success
     }
 
-    std::expected<ReceivedPacket, Error> SocketUnix::recvFrom() {
-        static thread_local uint8_t buf[kPacketBufferSize];
-    
-        return recvFrom(ReceivedPacket{
-            .data = buf,
+    std::expected<size_t, Error> SocketUnix::transmitBatch(std::span<OutgoingPacket> packets) {
+        size_t sent = 0;
+        size_t next = 0;
+
+        while (next < packets.size()) {
+#if defined(__linux__)
+            if (pacer_ && !kernel_pacing_) {
+                // Userspace pacing decides per datagram whether it goes now or waits in the queue.
+                auto& packet = packets[next];
+                auto result = transmitPaced(packet.addr, false, packet.data, packet.size);
+                if (result) {
+                    packet.result = {};
+                    ++sent;
+                    ++next;
+                    continue;
+                }
+                auto error = std::unexpected(result.error());
+                if (error.error() == ErrorCode::WouldBlock || error.error() == ErrorCode::InvalidSocket) {
+                    for (; next < packets.size(); ++next) {
+                        packets[next].result = error;
+                    }
+                    if (sent == 0 && error.error() == ErrorCode::InvalidSocket) {
+                        return error;
+                    }
+                    break;
+                }
+                packets[next++].result = error;
+                continue;
+            }
+
+            const size_t chunk = std::min(packets.size() - next, kMaxBatchSize);
+
+            mmsghdr msgs[kMaxBatchSize];
+            iovec iovs[kMaxBatchSize];
+            alignas(cmsghdr) char controls[kMaxBatchSize][kTxTimeControlSize];
+            Pacer::Booking bookings[kMaxBatchSize];
+            const int64_t now_ns = kernel_pacing_ ? monotonic_ns() : 0;
+
+            for (size_t i = 0; i < chunk; ++i) {
+                auto& packet = packets[next + i];
+                iovs[i] = iovec{ .iov_base = const_cast<uint8_t*>(packet.data), .iov_len = packet.size };
+                msgs[i] = mmsghdr{};
+                msgs[i].msg_hdr.msg_name = const_cast<void*>(packet.addr.sockaddrData());
+                msgs[i].msg_hdr.msg_namelen = static_cast<socklen_t>(packet.addr.sockaddrLen());
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                if (kernel_pacing_) {
+                    bookings[i] = pacer_->book(packet.addr, packet.size, now_ns);
+                    write_tx_time(msgs[i].msg_hdr, controls[i], static_cast<uint64_t>(bookings[i].departure_ns));
+                }
+            }
+
+            int count = ::sendmmsg(sockfd_, msgs, static_cast<unsigned int>(chunk), 0);
+            if (kernel_pacing_) {
+                // Datagrams the kernel didn't take give their slots back, newest first, so a retry isn't
+                // scheduled behind itself.
+                for (size_t i = chunk; i > static_cast<size_t>(std::max(count, 0)); --i) {
+                    pacer_->cancel(packets[next + i - 1].addr, bookings[i - 1]);
+                }
+            }
+            if (count > 0) {
+                for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+                    auto& packet = packets[next + i];
+                    if (msgs[i].msg_len != packet.size) {
+                        packet.result = make_unexpected(ErrorCode::PartialSend);
+                    } else {
+                        packet.result = {};
+                        ++sent;
+                    }
+                }
+                // A short count means packets[next + count] failed; the next call reports its errno.
+                next += static_cast<size_t>(count);
+                continue;
+            }
+            auto error = map_send_error(errno);
+#else
+            auto& packet = packets[next];
+            auto result = transmitTo(packet.addr, packet.data, packet.size);
+            if (result) {
+                packet.result = {};
+                ++sent;
+                ++next;
+                continue;
+            }
+            auto error = std::unexpected(result.error());
+#endif
+            if (error.error() == ErrorCode::InvalidSocket) {
+                for (; next < packets.size(); ++next) {
+                    packets[next].result = error;
+                }
+                if (sent == 0) {
+                    return error;
+                }
+                break;
+            }
+
+            if (error.error() == ErrorCode::WouldBlock) {
+                for (; next < packets.size(); ++next) {
+                    packets[next].result = error;
+                }
+                break;
+            }
+
+            // Anything else (unreachable peer, oversized payload, ...) only affects this packet.
+            packets[next++].result = error;
+        }
+
+        return sent;
+    }
+
+    std::expected<size_t, Error> SocketUnix::transmitSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        if (data == nullptr || segment_size == 0 || segment_size > kMaxGsoBytes) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+
+#if defined(__linux__)
+        size_t sent = 0;
+        size_t offset = 0;
+        const size_t max_segments = std::min(kMaxGsoSegments, std::max<size_t>(kMaxGsoBytes / segment_size, 1));
+
+        // One GSO send would leave as one burst with one departure time, so paced sockets go datagram by datagram.
+        while (offset < length && gso_supported_ && !pacer_) {
+            const size_t remaining = length - offset;
+            const size_t chunk = std::min(remaining, max_segments * segment_size);
+            const size_t segments = (chunk + segment_size - 1) / segment_size;
+
+            if (segments == 1) {
+                break; // Nothing to offload; the batched path below sends it as a plain datagram.
+            }
+
+            iovec iov{ .iov_base = const_cast<uint8_t*>(data + offset), .iov_len = chunk };
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+
+            msghdr msg{};
+            msg.msg_name = const_cast<void*>(addr.sockaddrData());
+            msg.msg_namelen = static_cast<socklen_t>(addr.sockaddrLen());
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            const uint16_t gso_size = static_cast<uint16_t>(segment_size);
+            std::memcpy(CMSG_DATA(cmsg), &gso_size, sizeof(gso_size));
+
+            ssize_t result = ::sendmsg(sockfd_, &msg, 0);
+            if (result < 0) {
+                const int err = errno;
+                if (err == EIO || err == ENOPROTOOPT) {
+                    gso_supported_ = false; // The device or route can't segment; stop trying on this socket.
+                    break;
+                }
+                if (sent > 0) {
+                    return sent; // The caller resends the rest and meets the error then
+                }
+                if (err == EINVAL) {
+                    // Segments over the path MTU or too many of them: this call's sizes, not a lack of GSO.
+                    return make_unexpected(ErrorCode::InvalidArgument, err, "UDP_SEGMENT");
+                }
+                return map_send_error(err);
+            }
+
+            if (static_cast<size_t>(result) != chunk) {
+                if (sent > 0) {
+                    return sent;
+                }
+                return make_unexpected(ErrorCode::PartialSend);
+            }
+
+            sent += segments;
+            offset += chunk;
+        }
+
+        if (offset == length) {
+            return sent;
+        }
+
+        auto rest = sendSegmentedBatch(addr, data + offset, length - offset, segment_size);
+        if (!rest) {
+            if (sent > 0) {
+                return sent;
+            }
+            return rest;
+        }
+        return sent + *rest;
+#else
+        return sendSegmentedBatch(addr, data, length, segment_size);
+#endif
+    }
+
+    std::expected<size_t, Error> SocketUnix::sendSegmentedBatch(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        size_t sent = 0;
+        size_t offset = 0;
+
+        std::array<OutgoingPacket, kMaxBatchSize> packets{};
+
+        while (offset < length) {
+            size_t count = 0;
+            for (size_t chunk_offset = offset; chunk_offset < length && count < kMaxBatchSize; chunk_offset += segment_size) {
+                auto& packet = packets[count++];
+                packet.data = data + chunk_offset;
+                packet.size = std::min(segment_size, length - chunk_offset);
+                packet.addr = addr;
+            }
+
+            auto batch = std::span<OutgoingPacket>(packets.data(), count);
+            auto result = transmitBatch(batch);
+            if (!result) {
+                if (sent > 0) {
+                    return sent;
+                }
+                return result;
+            }
+
+            // The count covers the datagrams before the first failure; once there are any, the error is
+            // left for the caller's next call, which starts at the failed datagram.
+            for (const auto& packet : batch) {
+                if (!packet.result) {
+                    if (sent > 0) {
+                        return sent;
+                    }
+                    return std::unexpected(packet.result.error());
+                }
+                ++sent;
+                offset += packet.size;
+            }
+        }
+
+        return sent;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketUnix::receiveView() {
+        if (gro_arena_) {
+            if (takePendingTruncation()) {
+                return make_unexpected(ErrorCode::Truncated);
+            }
+            return nextGroSegment(); // Zero-copy view into the coalesced read
+        }
+
+        return receiveInto(ReceivedPacket{
+            .data = recv_buffer_.get(),
             .size = 0,
-            .capacity = kPacketBufferSize,
+            .capacity = max_datagram_size_,
+            .addr = {},
         });
     }
 
-    std::expected<ReceivedPacket, Error> SocketUnix::recvFrom(ReceivedPacket&& packet) {
-        if (packet.data == nullptr || packet.capacity < kPacketBufferSize) {
-            return make_unexpected(ErrorCode::InvalidAddress);
+    std::expected<ReceivedPacket, Error> SocketUnix::receiveInto(ReceivedPacket&& packet) {
+        if (packet.data == nullptr || packet.capacity < max_datagram_size_) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        if (takePendingTruncation()) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+
+        if (gro_arena_) {
+            auto segment = nextGroSegment();
+            if (!segment) {
+                return segment;
+            }
+            packet.size = std::min(segment->size, packet.capacity);
+            std::memcpy(packet.data, segment->data, packet.size);
+            packet.addr = std::move(segment->addr);
+            packet.timestampNs = segment->timestampNs;
+            return std::move(packet);
         }
         
         sockaddr_storage src{};
-        socklen_t srclen = sizeof(src);
-    
-        ssize_t received = ::recvfrom(
-            sockfd_,
-            packet.data,
-            packet.capacity,
-            0,
-            reinterpret_cast<sockaddr*>(&src),
-            &srclen
-        );
-    
+        iovec iov{ .iov_base = packet.data, .iov_len = max_datagram_size_ };
+        msghdr msg{};
+        msg.msg_name = &src;
+        msg.msg_namelen = sizeof(src);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+#if defined(__linux__)
+        alignas(cmsghdr) char control[kRecvControlSize];
+        if (control_size_ > 0) {
+            msg.msg_control = control;
+            msg.msg_controllen = control_size_;
+        }
+#endif
+
+        // recvmsg rather than recvfrom: msg_flags is the portable way to learn the datagram didn't fit.
+        ssize_t received = ::recvmsg(sockfd_, &msg, 0);
+
         if (received < 0) {
             return map_rev_error(errno);
         }
+        if (msg.msg_flags & MSG_TRUNC) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+        const socklen_t srclen = msg.msg_namelen;
     
         if (received == 0) {
             return make_unexpected(ErrorCode::Closed); // rare, but possible
@@ -116,21 +849,319 @@ namespace pulse::net::udp {
             packet.size = static_cast<size_t>(received);
         }
     
-        auto addr_result = DecodeAddr(reinterpret_cast<sockaddr*>(&src));
+        auto addr_result = Addr::FromSockaddr(&src, srclen);
         if (!addr_result) {
             return make_unexpected(addr_result.error());
         }
 
         const auto& addr = *addr_result;
-        if (addr.port == 0) {
+        if (addr.port() == 0) {
             return make_unexpected(ErrorCode::InvalidAddress);
         } else {
             packet.addr = std::move(*addr_result);
         }
+#if defined(__linux__)
+        packet.timestampNs = control_size_ > 0 ? readRxControl(msg) : 0;
+#endif
         
         return std::move(packet);
     }
 
+    std::expected<size_t, Error> SocketUnix::receiveBatch(std::span<ReceivedPacket> packets) {
+        for (const auto& packet : packets) {
+            if (packet.data == nullptr || packet.capacity < max_datagram_size_) {
+                return make_unexpected(ErrorCode::InvalidArgument);
+            }
+        }
+        if (takePendingTruncation()) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+        if (packets.empty()) {
+            return 0;
+        }
+
+#if defined(__linux__)
+        size_t received = 0;
+        bool truncated = false;
+
+        if (gro_arena_) {
+            // Coalesced reads land in the arena, so split them into the caller's buffers here.
+            for (auto& packet : packets) {
+                auto segment = nextGroSegment();
+                if (!segment) {
+                    if (received > 0) {
+                        truncation_pending_ = segment.error() == ErrorCode::Truncated;
+                        break;
+                    }
+                    return make_unexpected(segment.error());
+                }
+                packet.size = std::min(segment->size, packet.capacity);
+                std::memcpy(packet.data, segment->data, packet.size);
+                packet.addr = std::move(segment->addr);
+                packet.timestampNs = segment->timestampNs;
+                ++received;
+            }
+            return received;
+        }
+
+        while (received < packets.size()) {
+            const size_t chunk = std::min(packets.size() - received, kMaxBatchSize);
+
+            mmsghdr msgs[kMaxBatchSize];
+            iovec iovs[kMaxBatchSize];
+            sockaddr_storage srcs[kMaxBatchSize];
+            alignas(cmsghdr) char controls[kMaxBatchSize][kRecvControlSize];
+
+            for (size_t i = 0; i < chunk; ++i) {
+                auto& packet = packets[received + i];
+                iovs[i] = iovec{ .iov_base = packet.data, .iov_len = max_datagram_size_ };
+                msgs[i] = mmsghdr{};
+                msgs[i].msg_hdr.msg_name = &srcs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                if (control_size_ > 0) {
+                    msgs[i].msg_hdr.msg_control = controls[i];
+                    msgs[i].msg_hdr.msg_controllen = control_size_;
+                }
+            }
+
+            int count = ::recvmmsg(sockfd_, msgs, static_cast<unsigned int>(chunk), MSG_DONTWAIT, nullptr);
+            if (count < 0) {
+                if (received > 0) {
+                    break; // Hand back what we have; a persistent error resurfaces on the next call.
+                }
+                return map_rev_error(errno);
+            }
+
+            // Datagrams with an empty payload or an undecodable source are dropped, exactly like
+            // recvFrom() rejects them; oversized ones are dropped and reported. Survivors are compacted
+            // to the front by swapping buffers.
+            size_t kept = received;
+            for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+                auto& packet = packets[received + i];
+                if (msgs[i].msg_len == 0) {
+                    continue;
+                }
+                if (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                    truncated = true;
+                    continue;
+                }
+
+                auto addr = Addr::FromSockaddr(&srcs[i], msgs[i].msg_hdr.msg_namelen);
+                if (!addr || addr->port() == 0) {
+                    continue;
+                }
+
+                packet.size = msgs[i].msg_len;
+                packet.addr = std::move(*addr);
+                packet.timestampNs = control_size_ > 0 ? readRxControl(msgs[i].msg_hdr) : 0;
+                if (kept != received + i) {
+                    std::swap(packets[kept], packet);
+                }
+                ++kept;
+            }
+            received = kept;
+
+            if (static_cast<size_t>(count) < chunk) {
+                break; // Socket queue drained.
+            }
+        }
+
+        if (received == 0) {
+            return make_unexpected(truncated ? ErrorCode::Truncated : ErrorCode::WouldBlock);
+        }
+        truncation_pending_ = truncated;
+        return received;
+#else
+        // No recvmmsg here (e.g. macOS), so fall back to one recvfrom per datagram.
+        size_t received = 0;
+        for (auto& packet : packets) {
+            auto result = receiveInto(ReceivedPacket{ .data = packet.data, .size = 0, .capacity = packet.capacity, .addr = {} });
+            if (!result) {
+                if (received > 0) {
+                    truncation_pending_ = result.error() == ErrorCode::Truncated;
+                    break;
+                }
+                return make_unexpected(result.error());
+            }
+            packets[received++] = std::move(*result);
+        }
+        return received;
+#endif
+    }
+
+    std::expected<size_t, Error> SocketUnix::readTxTimestamps(std::span<TxTimestamp> timestamps) {
+#if defined(__linux__)
+        if (!tx_timestamps_) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+
+        size_t count = 0;
+        while (count < timestamps.size()) {
+            // OPT_TSONLY entries carry no payload: just the stamp and a sock_extended_err holding the send's id.
+            alignas(cmsghdr) char control[kTimestampControlSize + CMSG_SPACE(sizeof(sock_extended_err) + sizeof(sockaddr_storage))];
+            msghdr msg{};
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+
+            if (::recvmsg(sockfd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+                if (count > 0) {
+                    break;
+                }
+                return map_rev_error(errno);
+            }
+
+            int64_t timestamp_ns = 0;
+            const sock_extended_err* extended = nullptr;
+            for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+                if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                    timestamp_ns = read_software_timestamp(cmsg);
+                } else if ((cmsg->cmsg_level == SOL_IP && cmsg->cmsg_type == IP_RECVERR) ||
+                           (cmsg->cmsg_level == SOL_IPV6 && cmsg->cmsg_type == IPV6_RECVERR)) {
+                    extended = reinterpret_cast<const sock_extended_err*>(CMSG_DATA(cmsg));
+                }
+            }
+
+            // Anything else on the error queue (ICMP errors with IP_RECVERR set elsewhere) is dropped.
+            if (extended != nullptr && extended->ee_origin == SO_EE_ORIGIN_TIMESTAMPING && timestamp_ns != 0) {
+                timestamps[count++] = TxTimestamp{ .id = extended->ee_data, .timestampNs = timestamp_ns };
+            }
+        }
+        return count;
+#else
+        return make_unexpected(ErrorCode::Unsupported);
+#endif
+    }
+
+#if defined(__linux__)
+    int64_t SocketUnix::readRxControl(msghdr& msg) noexcept {
+        const RxControl control = read_rx_control(msg);
+        if (control.drops != 0 && counters_) {
+            counters_->recordKernelDrops(control.drops);
+        }
+        return control.timestamp_ns;
+    }
+#endif
+
+    bool SocketUnix::enableGro() {
+#if defined(__linux__)
+        int enable = 1;
+        if (setsockopt(sockfd_, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) < 0) {
+            return false;
+        }
+
+        gro_arena_.reset(new (std::nothrow) uint8_t[kGroSlots * kGroSlotSize]);
+        if (!gro_arena_) {
+            enable = 0;
+            setsockopt(sockfd_, SOL_UDP, UDP_GRO, &enable, sizeof(enable));
+            return false;
+        }
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    std::expected<void, Error> SocketUnix::fillGroReads() {
+#if defined(__linux__)
+        gro_read_count_ = 0;
+        gro_read_index_ = 0;
+        gro_offset_ = 0;
+
+        while (gro_read_count_ == 0) {
+            mmsghdr msgs[kGroSlots];
+            iovec iovs[kGroSlots];
+            sockaddr_storage srcs[kGroSlots];
+            alignas(cmsghdr) char controls[kGroSlots][CMSG_SPACE(sizeof(int)) + kRecvControlSize];
+            const size_t control_size = CMSG_SPACE(sizeof(int)) + control_size_;
+
+            for (size_t i = 0; i < kGroSlots; ++i) {
+                iovs[i] = iovec{ .iov_base = gro_arena_.get() + i * kGroSlotSize, .iov_len = kGroSlotSize };
+                msgs[i] = mmsghdr{};
+                msgs[i].msg_hdr.msg_name = &srcs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+                msgs[i].msg_hdr.msg_iov = &iovs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                msgs[i].msg_hdr.msg_control = controls[i];
+                msgs[i].msg_hdr.msg_controllen = control_size;
+            }
+
+            int count = ::recvmmsg(sockfd_, msgs, kGroSlots, MSG_DONTWAIT, nullptr);
+            if (count < 0) {
+                return map_rev_error(errno);
+            }
+
+            for (size_t i = 0; i < static_cast<size_t>(count); ++i) {
+                if (msgs[i].msg_len == 0) {
+                    continue;
+                }
+
+                auto addr = Addr::FromSockaddr(&srcs[i], msgs[i].msg_hdr.msg_namelen);
+                if (!addr || addr->port() == 0) {
+                    continue;
+                }
+
+                // Without a UDP_GRO control message the read is a single, uncoalesced datagram.
+                size_t segment_size = msgs[i].msg_len;
+                int64_t timestamp_ns = 0;
+                for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+                    if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                        int gso_size = 0;
+                        std::memcpy(&gso_size, CMSG_DATA(cmsg), sizeof(gso_size));
+                        if (gso_size > 0) {
+                            segment_size = static_cast<size_t>(gso_size);
+                        }
+                    } else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_TIMESTAMPING) {
+                        timestamp_ns = read_software_timestamp(cmsg); // GRO keeps the first segment's stamp
+                    } else if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL && counters_) {
+                        counters_->recordKernelDrops(read_drop_count(cmsg));
+                    }
+                }
+
+                auto& read = gro_reads_[gro_read_count_++];
+                read.data = static_cast<uint8_t*>(iovs[i].iov_base);
+                read.length = msgs[i].msg_len;
+                read.segment_size = segment_size;
+                read.addr = std::move(*addr);
+                read.timestamp_ns = timestamp_ns;
+            }
+        }
+        return {};
+#else
+        return make_unexpected(ErrorCode::RecvFailed);
+#endif
+    }
+
+    std::expected<ReceivedPacket, Error> SocketUnix::nextGroSegment() {
+        if (gro_read_index_ == gro_read_count_) {
+            if (auto filled = fillGroReads(); !filled) {
+                return std::unexpected(filled.error());
+            }
+        }
+
+        auto& read = gro_reads_[gro_read_index_];
+        const size_t size = std::min(read.segment_size, read.length - gro_offset_);
+        ReceivedPacket segment{
+            .data = read.data + gro_offset_,
+            .size = size,
+            .capacity = size,
+            .addr = read.addr,
+            .timestampNs = read.timestamp_ns,
+        };
+
+        gro_offset_ += size;
+        if (gro_offset_ == read.length) {
+            ++gro_read_index_;
+            gro_offset_ = 0;
+        }
+        // The arena takes datagrams of any size, so the per-socket limit is enforced here instead.
+        if (size > max_datagram_size_) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+        return segment;
+    }
+
     std::expected<int, Error> SocketUnix::getHandle() const {
         if (sockfd_ == -1) {
             return make_unexpected(ErrorCode::InvalidSocket);
@@ -145,118 +1176,234 @@ namespace pulse::net::udp {
         }
     }
 
-    std::expected<Addr, Error> SocketUnix::DecodeAddr(const sockaddr* addr) {
-        char ip[INET6_ADDRSTRLEN];
-        uint16_t port = 0;
-    
-        if (addr->sa_family == AF_INET) {
-            auto* a = reinterpret_cast<const sockaddr_in*>(addr);
-            if (!inet_ntop(AF_INET, &a->sin_addr, ip, sizeof(ip))) {
-                return make_unexpected(ErrorCode::InvalidAddress);
-            }
-            port = ntohs(a->sin_port);
-        } else if (addr->sa_family == AF_INET6) {
-            auto* a = reinterpret_cast<const sockaddr_in6*>(addr);
-            if (!inet_ntop(AF_INET6, &a->sin6_addr, ip, sizeof(ip))) {
-                return make_unexpected(ErrorCode::InvalidAddress);
-            }
-            port = ntohs(a->sin6_port);
-        } else {
-            return make_unexpected(ErrorCode::UnsupportedAddressFamily);
-        }
-    
-        return Addr::Create(ip, port);
-    }
-
-    std::expected<std::unique_ptr<ISocket>, Error> SocketUnix::Listen(const Addr& bind_addr) {
-        int family = AF_INET;
-        const void* addr_ptr = nullptr;
-
-        sockaddr_in addr4{};
-        sockaddr_in6 addr6{};
-
-        if (inet_pton(AF_INET, bind_addr.ip.c_str(), &addr4.sin_addr) == 1) {
-            family = AF_INET;
-            addr4.sin_family = AF_INET;
-            addr4.sin_port = htons(bind_addr.port);
-            addr_ptr = &addr4;
-        } else if (inet_pton(AF_INET6, bind_addr.ip.c_str(), &addr6.sin6_addr) == 1) {
-            family = AF_INET6;
-            addr6.sin6_family = AF_INET6;
-            addr6.sin6_port = htons(bind_addr.port);
-            addr_ptr = &addr6;
-        } else {
+    std::expected<int, Error> SocketUnix::OpenBound(const Addr& bind_addr, const SocketOptions& options) {
+        const auto* addr = static_cast<const sockaddr*>(bind_addr.sockaddrData());
+        const int family = addr->sa_family;
+        if (family != AF_INET && family != AF_INET6) {
             return make_unexpected(ErrorCode::InvalidAddress);
         }
 
         int sockfd = ::socket(family, SOCK_DGRAM, 0);
         if (sockfd < 0) {
-            return make_unexpected(ErrorCode::SocketCreateFailed);
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
         }
 
         // Make socket non-blocking
         int flags = fcntl(sockfd, F_GETFL, 0);
         if (flags < 0 || fcntl(sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            const int err = errno;
+            ::close(sockfd);
+            return make_unexpected(ErrorCode::SocketConfigFailed, err);
+        }
+
+        if (auto applied = apply_socket_options(sockfd, family, options); !applied) {
             ::close(sockfd);
-            return make_unexpected(ErrorCode::SocketConfigFailed);
+            return std::unexpected(applied.error());
         }
 
         // Bind
-        socklen_t socklen = (family == AF_INET) ? sizeof(sockaddr_in) : sizeof(sockaddr_in6);
-        if (::bind(sockfd, reinterpret_cast<const sockaddr*>(addr_ptr), socklen) < 0) {
+        if (::bind(sockfd, addr, static_cast<socklen_t>(bind_addr.sockaddrLen())) < 0) {
+            const int err = errno;
             ::close(sockfd);
-            return make_unexpected(ErrorCode::BindFailed);
+            return make_unexpected(ErrorCode::BindFailed, err);
         }
 
-        return std::make_unique<SocketUnix>(sockfd);
+        return sockfd;
     }
 
-    std::expected<std::unique_ptr<ISocket>, Error> SocketUnix::Dial(const Addr& remote_addr) {
-        int family = AF_INET;
-        sockaddr_storage remote_sock{};
-        socklen_t remote_len = 0;
+    std::expected<std::vector<int>, Error> SocketUnix::OpenBoundGroup(const Addr& bind_addr, size_t shards, const SocketOptions& options) {
+        if (shards == 0) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+#if defined(__linux__)
+        std::vector<int> sockfds;
+        try {
+            sockfds.reserve(shards);
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
 
-        if (inet_pton(AF_INET, remote_addr.ip.c_str(), &reinterpret_cast<sockaddr_in*>(&remote_sock)->sin_addr) == 1) {
-            auto* addr4 = reinterpret_cast<sockaddr_in*>(&remote_sock);
-            family = AF_INET;
-            addr4->sin_family = AF_INET;
-            addr4->sin_port = htons(remote_addr.port);
-            remote_len = sizeof(sockaddr_in);
-        } else if (inet_pton(AF_INET6, remote_addr.ip.c_str(), &reinterpret_cast<sockaddr_in6*>(&remote_sock)->sin6_addr) == 1) {
-            auto* addr6 = reinterpret_cast<sockaddr_in6*>(&remote_sock);
-            family = AF_INET6;
-            addr6->sin6_family = AF_INET6;
-            addr6->sin6_port = htons(remote_addr.port);
-            remote_len = sizeof(sockaddr_in6);
-        } else {
+        auto close_all = [&sockfds]() {
+            for (int fd : sockfds) {
+                ::close(fd);
+            }
+        };
+
+        SocketOptions group_options = options;
+        group_options.reusePort = true;
+
+        auto first = OpenBound(bind_addr, group_options);
+        if (!first) {
+            return std::unexpected(first.error());
+        }
+        sockfds.push_back(*first);
+
+        // Port 0 would give every shard its own ephemeral port, so the rest join whatever the first got.
+        Addr group_addr = bind_addr;
+        if (bind_addr.port() == 0) {
+            sockaddr_storage bound{};
+            socklen_t bound_len = sizeof(bound);
+            if (::getsockname(*first, reinterpret_cast<sockaddr*>(&bound), &bound_len) < 0) {
+                const int err = errno;
+                close_all();
+                return make_unexpected(ErrorCode::BindFailed, err);
+            }
+            auto decoded = Addr::FromSockaddr(&bound, bound_len);
+            if (!decoded) {
+                close_all();
+                return std::unexpected(decoded.error());
+            }
+            group_addr = std::move(*decoded);
+        }
+
+        for (size_t i = 1; i < shards; ++i) {
+            auto sockfd = OpenBound(group_addr, group_options);
+            if (!sockfd) {
+                close_all();
+                return std::unexpected(sockfd.error());
+            }
+            sockfds.push_back(*sockfd);
+        }
+
+        return sockfds;
+#else
+        // BSD-style SO_REUSEPORT doesn't balance unicast datagrams across the group.
+        return make_unexpected(ErrorCode::Unsupported);
+#endif
+    }
+
+    std::expected<int, Error> SocketUnix::OpenConnected(const Addr& remote_addr, const SocketOptions& options) {
+        const auto* addr = static_cast<const sockaddr*>(remote_addr.sockaddrData());
+        const int family = addr->sa_family;
+        if (family != AF_INET && family != AF_INET6) {
             return make_unexpected(ErrorCode::InvalidAddress);
         }
 
         int sockfd = socket(family, SOCK_DGRAM, 0);
         if (sockfd < 0) {
-            return make_unexpected(ErrorCode::SocketCreateFailed);
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno);
         }
 
         // Make socket non-blocking
         int flags = fcntl(sockfd, F_GETFL, 0);
         if (flags < 0 || fcntl(sockfd, F_SETFL, flags | O_NONBLOCK) < 0) {
+            const int err = errno;
             ::close(sockfd);
-            return make_unexpected(ErrorCode::SocketConfigFailed);
+            return make_unexpected(ErrorCode::SocketConfigFailed, err);
         }
 
-        if (connect(sockfd, reinterpret_cast<sockaddr*>(&remote_sock), remote_len) < 0) {
+        if (auto applied = apply_socket_options(sockfd, family, options); !applied) {
             ::close(sockfd);
-            return make_unexpected(ErrorCode::ConnectFailed);
+            return std::unexpected(applied.error());
         }
 
+        if (connect(sockfd, addr, static_cast<socklen_t>(remote_addr.sockaddrLen())) < 0) {
+            const int err = errno;
+            ::close(sockfd);
+            return make_unexpected(ErrorCode::ConnectFailed, err);
+        }
+
+        return sockfd;
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketUnix::Listen(const Addr& bind_addr, const SocketOptions& options) {
+        if (auto checked = check_socket_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        auto sockfd = OpenBound(bind_addr, options);
+        if (!sockfd) {
+            return std::unexpected(sockfd.error());
+        }
+
+        std::unique_ptr<SocketUnix> socket; // Owns the descriptor once set, and closes it on the way out
         try {
-            return std::make_unique<SocketUnix>(sockfd);
+            socket = std::make_unique<SocketUnix>(*sockfd, options);
+            if (auto paced = socket->enablePacing(options, nullptr); !paced) {
+                return std::unexpected(paced.error());
+            }
+
+            // Best effort: kernels without UDP_GRO simply keep delivering one datagram per read.
+            if (options.receiveCoalescing) {
+                socket->enableGro();
+            }
+
+            return socket;
         } catch (std::bad_alloc& err) {
-            ::close(sockfd);
+            if (!socket) {
+                ::close(*sockfd);
+            }
             return make_unexpected(ErrorCode::SocketCreateFailed, err);
         } catch (...) {
-            ::close(sockfd);
-            return make_unexpected(ErrorCode::Unknown, "Unknown error occurred while creating SocketUnix");
+            if (!socket) {
+                ::close(*sockfd);
+            }
+            return make_unexpected(ErrorCode::Unknown, "Unexpected exception while creating SocketUnix");
+        }
+    }
+
+    std::expected<std::vector<std::unique_ptr<ISocket>>, Error> SocketUnix::ListenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options) {
+        if (auto checked = check_socket_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        auto sockfds = OpenBoundGroup(bind_addr, shards, options);
+        if (!sockfds) {
+            return std::unexpected(sockfds.error());
+        }
+
+        std::vector<std::unique_ptr<ISocket>> sockets;
+        size_t adopted = 0; // Descriptors before this one belong to a SocketUnix, which closes them
+        try {
+            sockets.reserve(sockfds->size());
+            while (adopted < sockfds->size()) {
+                auto socket = std::make_unique<SocketUnix>((*sockfds)[adopted], options);
+                ++adopted;
+                if (auto paced = socket->enablePacing(options, nullptr); !paced) {
+                    for (size_t i = adopted; i < sockfds->size(); ++i) {
+                        ::close((*sockfds)[i]);
+                    }
+                    return std::unexpected(paced.error());
+                }
+                if (options.receiveCoalescing) {
+                    socket->enableGro();
+                }
+                sockets.push_back(std::move(socket));
+            }
+        } catch (std::bad_alloc& err) {
+            for (size_t i = adopted; i < sockfds->size(); ++i) {
+                ::close((*sockfds)[i]);
+            }
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        return sockets;
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketUnix::Dial(const Addr& remote_addr, const SocketOptions& options) {
+        if (auto checked = check_socket_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
+        auto sockfd = OpenConnected(remote_addr, options);
+        if (!sockfd) {
+            return std::unexpected(sockfd.error());
+        }
+
+        std::unique_ptr<SocketUnix> socket; // Owns the descriptor once set, and closes it on the way out
+        try {
+            socket = std::make_unique<SocketUnix>(*sockfd, options);
+            if (auto paced = socket->enablePacing(options, &remote_addr); !paced) {
+                return std::unexpected(paced.error());
+            }
+            return socket;
+        } catch (std::bad_alloc& err) {
+            if (!socket) {
+                ::close(*sockfd);
+            }
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        } catch (...) {
+            if (!socket) {
+                ::close(*sockfd);
+            }
+            return make_unexpected(ErrorCode::Unknown, "Unexpected exception while creating SocketUnix");
         }
     }
 
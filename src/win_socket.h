@@ -1,11 +1,16 @@
 #include <pulse/net/udp/udp.h>
 #include <winsock2.h>
 
+#include <memory>
+
+#include "capture_tap.h"
+#include "socket_counters.h"
+
 namespace pulse::net::udp {
 
-    class SocketWindows : public ISocket {
+    class SocketWindows final : public ISocket {
     public:
-        SocketWindows(SOCKET sock);
+        SocketWindows(SOCKET sock, const SocketOptions& options = {});
         ~SocketWindows();
 
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
@@ -13,29 +18,68 @@ namespace pulse::net::udp {
         
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         std::expected<void, Error> send(const uint8_t* data, size_t length) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendBatch(std::span<OutgoingPacket> packets) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segmentSize) override;
         
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         std::expected<ReceivedPacket, Error> recvFrom() override;
     
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         std::expected<ReceivedPacket, Error> recvFrom(ReceivedPacket&& packet) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatch(std::span<ReceivedPacket> packets) override;
         
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<SocketMetrics, Error> metrics() const override;
+
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
         std::expected<int, Error> getHandle() const override;
 
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        SpinBudget* spinBudget() noexcept override {
+            return &spin_budget_;
+        }
+
         void close() override;
         
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
-        static std::expected<Addr, Error> DecodeAddr(const sockaddr* addr);
-        
-        [[nodiscard("You're ignoring an error message. Don't do that.")]]
-        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bindAddr);
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bindAddr, const SocketOptions& options = {});
         
         [[nodiscard("You're ignoring an error message. Don't do that.")]]
-        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remoteAddr);
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remoteAddr, const SocketOptions& options = {});
         
     private:
+        // The unrecorded operations behind the public ones, which add them to counters_ once they return.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmitTo(const Addr& addr, const uint8_t* data, size_t length);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> transmit(const uint8_t* data, size_t length);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> transmitBatch(std::span<OutgoingPacket> packets);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> transmitSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> receiveInto(ReceivedPacket&& packet);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> receiveBatch(std::span<ReceivedPacket> packets);
+
         SOCKET sock_;
+        size_t max_datagram_size_;
+        std::unique_ptr<uint8_t[]> recv_buffer_; // Behind recvFrom() without a caller buffer
+        bool truncation_pending_ = false; // Held back by a recvBatch() that returned other datagrams
+        std::unique_ptr<SocketCounters> counters_; // Null unless SocketOptions::metrics; no drop counts here
+        std::unique_ptr<CaptureTap> tap_; // Null unless SocketOptions::capture
+        SpinBudget spin_budget_; // What recvFromUntil() has learned about arrival gaps here
         
     };
 
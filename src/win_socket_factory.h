@@ -7,12 +7,28 @@ namespace pulse::net::udp {
 
     class WindowsSocketFactory : public ISocketFactory {
     public:
+        using ISocketFactory::listen;
+        using ISocketFactory::dial;
+
         std::expected<std::unique_ptr<ISocket>, Error> listen(const Addr& bind_addr) override {
-            return SocketWindows::Listen(bind_addr);
+            return SocketWindows::Listen(bind_addr, {});
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> listenWithOptions(const Addr& bind_addr, const SocketOptions& options) override {
+            return SocketWindows::Listen(bind_addr, options);
+        }
+
+        std::expected<std::vector<std::unique_ptr<ISocket>>, Error> listenSharded(const Addr&, size_t, const SocketOptions& = {}) override {
+            // Winsock has no load-balancing equivalent of SO_REUSEPORT.
+            return make_unexpected(ErrorCode::Unsupported);
         }
 
         std::expected<std::unique_ptr<ISocket>, Error> dial(const Addr& remote_addr) override {
-            return SocketWindows::Dial(remote_addr);
+            return SocketWindows::Dial(remote_addr, {});
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> dialWithOptions(const Addr& remote_addr, const SocketOptions& options) override {
+            return SocketWindows::Dial(remote_addr, options);
         }
     };
 
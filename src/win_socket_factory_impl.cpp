@@ -2,6 +2,8 @@
 #include <pulse/net/udp/udp.h>
 #include <pulse/net/udp/error_code.h>
 #include <pulse/net/udp/udp_addr.h>
+#include <pulse/net/udp/reactor.h>
+#include <pulse/net/udp/async.h>
 
 #include "win_socket_factory.h"
 
@@ -28,5 +30,25 @@ namespace pulse::net::udp {
     {
         current_factory = nullptr;
     }
+
+    std::expected<ISocketFactory *, Error> get_io_uring_socket_factory()
+    {
+        return make_unexpected(ErrorCode::Unsupported);
+    }
     
+    std::expected<std::unique_ptr<ISocketFactory>, Error> create_xdp_socket_factory(const XdpOptions&)
+    {
+        return make_unexpected(ErrorCode::Unsupported);
+    }
+
+    std::expected<std::unique_ptr<Reactor>, Error> create_reactor()
+    {
+        return make_unexpected(ErrorCode::Unsupported);
+    }
+
+    std::expected<std::unique_ptr<EventLoop>, Error> create_event_loop()
+    {
+        return make_unexpected(ErrorCode::Unsupported);
+    }
+
 } // namespace pulse::net::udp
\ No newline at end of file
@@ -8,14 +8,19 @@
 #include <memory>
 #include <atomic>
 #include <mutex>
+#include <array>
+#include <algorithm>
+#include <optional>
+#include <utility>
 
 #include "win_socket.h"
+#include "socket_options_check.h"
 
 #pragma comment(lib, "ws2_32.lib")
 
 namespace pulse::net::udp {
 
-    constexpr size_t kPacketBufferSize = 2048;
+    constexpr size_t kMaxBatchSize = 64;
 
     static std::atomic<int> wsa_ref_count{0};
     static std::mutex wsa_mutex;
@@ -25,8 +30,8 @@ namespace pulse::net::udp {
         std::lock_guard<std::mutex> lock(wsa_mutex);
         if (wsa_ref_count == 0) {
             WSADATA wsaData;
-            if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
-                return make_unexpected(ErrorCode::WSAStartupFailed);
+            if (int result = WSAStartup(MAKEWORD(2, 2), &wsaData); result != 0) {
+                return make_unexpected(ErrorCode::WSAStartupFailed, result); // WSAStartup returns its error directly
             }
         }
         ++wsa_ref_count;
@@ -34,6 +39,48 @@ namespace pulse::net::udp {
     }
 
 
+    [[nodiscard("You're ignoring an error message. Don't do that.")]]
+    static std::expected<void, Error> set_int_option(SOCKET sock, int level, int name, int value, const char* label) {
+        if (setsockopt(sock, level, name, reinterpret_cast<const char*>(&value), sizeof(value)) != 0) {
+            return make_unexpected(ErrorCode::SocketConfigFailed, WSAGetLastError(), label);
+        }
+        return {};
+    }
+
+    // Applies every option the caller set, stopping at the first one Winsock refuses. Buffer sizes we
+    // don't get told about keep the generous defaults this backend has always used.
+    [[nodiscard("You're ignoring an error message. Don't do that.")]]
+    static std::expected<void, Error> apply_socket_options(SOCKET sock, int family, const SocketOptions& options) {
+        std::expected<void, Error> result;
+        auto set = [&](bool wanted, int level, int name, int value, const char* label) {
+            if (wanted && result) {
+                result = set_int_option(sock, level, name, value, label);
+            }
+        };
+        auto unsupported = [&](bool wanted, const char* label) {
+            if (wanted && result) {
+                result = make_unexpected(ErrorCode::Unsupported, label);
+            }
+        };
+
+        set(options.reuseAddress, SOL_SOCKET, SO_REUSEADDR, 1, "SO_REUSEADDR");
+        unsupported(options.reusePort, "SO_REUSEPORT");
+        set(true, SOL_SOCKET, SO_RCVBUF, options.receiveBufferSize.value_or(1 * 1024 * 1024), "SO_RCVBUF");
+        set(true, SOL_SOCKET, SO_SNDBUF, options.sendBufferSize.value_or(4 * 1024 * 1024), "SO_SNDBUF");
+        if (family == AF_INET6) {
+            set(options.tos.has_value(), IPPROTO_IPV6, IPV6_TCLASS, options.tos.value_or(0), "IPV6_TCLASS");
+        } else {
+            set(options.tos.has_value(), IPPROTO_IP, IP_TOS, options.tos.value_or(0), "IP_TOS");
+        }
+        unsupported(options.priority.has_value(), "SO_PRIORITY");
+        unsupported(options.busyPollMicros.has_value(), "SO_BUSY_POLL");
+        unsupported(options.preferBusyPoll, "SO_PREFER_BUSY_POLL");
+        unsupported(options.incomingCpu.has_value(), "SO_INCOMING_CPU");
+        unsupported(options.rxTimestamps || options.txTimestamps, "SO_TIMESTAMPING");
+        unsupported(options.pacingRate.has_value(), "pacing");
+        return result;
+    }
+
     static void cleanup_wsa() {
         std::lock_guard<std::mutex> lock(wsa_mutex);
         if (wsa_ref_count > 0) {
@@ -47,33 +94,49 @@ namespace pulse::net::udp {
     [[nodiscard("Why ask for an ErrorCode and then ignore it?")]]
     inline std::unexpected<Error> map_wsa_send_error(int err) {
         switch (err) {
-            case WSAEWOULDBLOCK: return make_unexpected(ErrorCode::WouldBlock);
+            case WSAEWOULDBLOCK: return make_unexpected(ErrorCode::WouldBlock, err);
             case WSAENOTSOCK:
-            case WSAEBADF:       return make_unexpected(ErrorCode::InvalidSocket);
-            case WSAECONNRESET:  return make_unexpected(ErrorCode::ConnectionReset);
-            default:             return make_unexpected(ErrorCode::SendFailed);
+            case WSAEBADF:       return make_unexpected(ErrorCode::InvalidSocket, err);
+            case WSAECONNRESET:  return make_unexpected(ErrorCode::ConnectionReset, err);
+            default:             return make_unexpected(ErrorCode::SendFailed, err);
         }
     }
     
     [[nodiscard("Why ask for an ErrorCode and then ignore it?")]]
     inline std::unexpected<Error> map_wsa_receive_error(int err) {
         switch (err) {
-            case WSAEWOULDBLOCK: return make_unexpected(ErrorCode::WouldBlock);
+            case WSAEWOULDBLOCK: return make_unexpected(ErrorCode::WouldBlock, err);
             case WSAENOTSOCK:
-            case WSAEBADF:       return make_unexpected(ErrorCode::InvalidSocket);
-            default:             return make_unexpected(ErrorCode::RecvFailed);
+            case WSAEBADF:       return make_unexpected(ErrorCode::InvalidSocket, err);
+            case WSAEMSGSIZE:    return make_unexpected(ErrorCode::Truncated, err); // The datagram is consumed
+            default:             return make_unexpected(ErrorCode::RecvFailed, err);
         }
     }
 
-    SocketWindows::SocketWindows(SOCKET sock) : sock_(sock) {
-        // Increase socket buffer sizes but don't start receiving thread
-        int send_buf_size = 4 * 1024 * 1024; // 4MB
-        setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (char*)&send_buf_size, sizeof(send_buf_size));
-        
-        // We still need a reasonable receive buffer for any responses
-        int recv_buf_size = 1 * 1024 * 1024; // 1MB is enough for client
-        setsockopt(sock, SOL_SOCKET, SO_RCVBUF, (char*)&recv_buf_size, sizeof(recv_buf_size));
-        
+    // The socket is bound, and connected if dialed, by the time it's wrapped, so both ends are known.
+    static std::unique_ptr<CaptureTap> make_capture_tap(SOCKET sock, std::shared_ptr<PacketCapture> capture) {
+        sockaddr_storage name{};
+        int name_len = sizeof(name);
+        Addr local;
+        if (getsockname(sock, reinterpret_cast<sockaddr*>(&name), &name_len) == 0) {
+            local = Addr::FromSockaddr(&name, name_len).value_or(Addr{});
+        }
+        std::optional<Addr> peer;
+        name_len = sizeof(name);
+        if (getpeername(sock, reinterpret_cast<sockaddr*>(&name), &name_len) == 0) {
+            if (auto decoded = Addr::FromSockaddr(&name, name_len)) {
+                peer = *decoded;
+            }
+        }
+        return std::make_unique<CaptureTap>(std::move(capture), local, peer);
+    }
+
+    SocketWindows::SocketWindows(SOCKET sock, const SocketOptions& options)
+        : sock_(sock),
+          max_datagram_size_(options.maxDatagramSize),
+          recv_buffer_(std::make_unique_for_overwrite<uint8_t[]>(options.maxDatagramSize)),
+          counters_(options.metrics ? std::make_unique<SocketCounters>() : nullptr),
+          tap_(options.capture ? make_capture_tap(sock, options.capture) : nullptr) {
         // Disable connection reset behavior
         BOOL new_behavior = FALSE;
         DWORD bytes_returned = 0;
@@ -87,6 +150,95 @@ namespace pulse::net::udp {
     }
 
     std::expected<void, Error> SocketWindows::sendTo(const Addr& addr, const uint8_t* data, size_t length) {
+        auto result = transmitTo(addr, data, length);
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, addr, data, length);
+        }
+        return result;
+    }
+
+    std::expected<void, Error> SocketWindows::send(const uint8_t* data, size_t length) {
+        auto result = transmit(data, length);
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, data, length);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketWindows::sendBatch(std::span<OutgoingPacket> packets) {
+        auto result = transmitBatch(packets);
+        if (counters_) {
+            counters_->recordSendBatch(packets);
+        }
+        if (tap_) {
+            tap_->recordSendBatch(packets);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketWindows::sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        auto result = transmitSegmented(addr, data, length, segment_size);
+        if (counters_) {
+            counters_->recordSendSegmented(result, length, segment_size);
+        }
+        if (tap_) {
+            tap_->recordSendSegmented(result, addr, data, length, segment_size);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketWindows::recvFrom() {
+        auto result = receiveInto(ReceivedPacket{
+            .data = recv_buffer_.get(),
+            .size = 0,
+            .capacity = max_datagram_size_,
+            .addr = {},
+        });
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketWindows::recvFrom(ReceivedPacket&& packet) {
+        auto result = receiveInto(std::move(packet));
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketWindows::recvBatch(std::span<ReceivedPacket> packets) {
+        auto result = receiveBatch(packets);
+        if (counters_) {
+            counters_->recordRecvBatch(result, packets);
+        }
+        if (tap_) {
+            tap_->recordRecvBatch(result, packets);
+        }
+        return result;
+    }
+
+    std::expected<SocketMetrics, Error> SocketWindows::metrics() const {
+        if (!counters_) {
+            return make_unexpected(ErrorCode::InvalidArgument, "metrics not enabled in SocketOptions");
+        }
+        return counters_->snapshot();
+    }
+
+    std::expected<void, Error> SocketWindows::transmitTo(const Addr& addr, const uint8_t* data, size_t length) {
         int sent = ::sendto(
             sock_,
             reinterpret_cast<const char*>(data),
@@ -108,7 +260,7 @@ namespace pulse::net::udp {
         return {};
     }
 
-    std::expected<void, Error> SocketWindows::send(const uint8_t* data, size_t length) {
+    std::expected<void, Error> SocketWindows::transmit(const uint8_t* data, size_t length) {
         int sent = ::send(sock_, reinterpret_cast<const char*>(data), static_cast<int>(length), 0);
     
         if (sent == SOCKET_ERROR) {
@@ -123,19 +275,84 @@ namespace pulse::net::udp {
         return {};
     }
 
-    std::expected<ReceivedPacket, Error> SocketWindows::recvFrom() {
-        static thread_local uint8_t buf[kPacketBufferSize];
-    
-        return recvFrom(ReceivedPacket{
-            .data = buf,
-            .size = 0,
-            .capacity = kPacketBufferSize
-        });
+    std::expected<size_t, Error> SocketWindows::transmitBatch(std::span<OutgoingPacket> packets) {
+        // Winsock has no sendmmsg; issue one sendto per packet with the same stop-at-WouldBlock rules.
+        size_t sent = 0;
+        size_t next = 0;
+
+        while (next < packets.size()) {
+            auto& packet = packets[next];
+            auto result = transmitTo(packet.addr, packet.data, packet.size);
+            if (result) {
+                packet.result = {};
+                ++sent;
+                ++next;
+                continue;
+            }
+
+            auto error = std::unexpected(result.error());
+            if (error.error() == ErrorCode::InvalidSocket || error.error() == ErrorCode::WouldBlock) {
+                for (; next < packets.size(); ++next) {
+                    packets[next].result = error;
+                }
+                if (error.error() == ErrorCode::InvalidSocket && sent == 0) {
+                    return error;
+                }
+                break;
+            }
+
+            packets[next++].result = error;
+        }
+
+        return sent;
     }
 
-    std::expected<ReceivedPacket, Error> SocketWindows::recvFrom(ReceivedPacket&& packet) {
-        if (packet.data == nullptr || packet.capacity < kPacketBufferSize) {
-            return make_unexpected(ErrorCode::InvalidAddress);
+    std::expected<size_t, Error> SocketWindows::transmitSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        if (data == nullptr || segment_size == 0) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+
+        // No segmentation offload through this path; split the buffer into a batched send instead.
+        size_t sent = 0;
+        size_t offset = 0;
+        std::array<OutgoingPacket, kMaxBatchSize> packets{};
+
+        while (offset < length) {
+            size_t count = 0;
+            for (size_t chunk_offset = offset; chunk_offset < length && count < kMaxBatchSize; chunk_offset += segment_size) {
+                auto& packet = packets[count++];
+                packet.data = data + chunk_offset;
+                packet.size = std::min(segment_size, length - chunk_offset);
+                packet.addr = addr;
+            }
+
+            auto batch = std::span<OutgoingPacket>(packets.data(), count);
+            auto result = transmitBatch(batch);
+            if (!result) {
+                return result;
+            }
+
+            for (const auto& packet : batch) {
+                if (!packet.result) {
+                    if (sent > 0 && packet.result.error() == ErrorCode::WouldBlock) {
+                        return sent;
+                    }
+                    return std::unexpected(packet.result.error());
+                }
+                ++sent;
+                offset += packet.size;
+            }
+        }
+
+        return sent;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketWindows::receiveInto(ReceivedPacket&& packet) {
+        if (packet.data == nullptr || packet.capacity < max_datagram_size_) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        if (std::exchange(truncation_pending_, false)) {
+            return make_unexpected(ErrorCode::Truncated);
         }
 
         sockaddr_storage src{};
@@ -144,7 +361,7 @@ namespace pulse::net::udp {
         int received = ::recvfrom(
             sock_,
             reinterpret_cast<char*>(packet.data),
-            packet.capacity,
+            static_cast<int>(max_datagram_size_),
             0,
             reinterpret_cast<sockaddr*>(&src),
             &srclen
@@ -155,12 +372,12 @@ namespace pulse::net::udp {
             return map_wsa_receive_error(err);
         }
     
-        auto addr = DecodeAddr(reinterpret_cast<sockaddr*>(&src));
+        auto addr = Addr::FromSockaddr(&src, static_cast<size_t>(srclen));
         if (!addr) {
             return make_unexpected(addr.error());
         }
     
-        if (addr->port == 0) {
+        if (addr->port() == 0) {
             return make_unexpected(ErrorCode::InvalidAddress);
         }
 
@@ -170,6 +387,23 @@ namespace pulse::net::udp {
         return std::move(packet);
     }
     
+    std::expected<size_t, Error> SocketWindows::receiveBatch(std::span<ReceivedPacket> packets) {
+        // Winsock has no recvmmsg equivalent for plain UDP sockets, so drain one datagram at a time.
+        size_t received = 0;
+        for (auto& packet : packets) {
+            auto result = receiveInto(ReceivedPacket{ .data = packet.data, .size = 0, .capacity = packet.capacity, .addr = {} });
+            if (!result) {
+                if (received > 0) {
+                    truncation_pending_ = result.error() == ErrorCode::Truncated;
+                    break;
+                }
+                return make_unexpected(result.error());
+            }
+            packets[received++] = std::move(*result);
+        }
+        return received;
+    }
+
     std::expected<int, Error> SocketWindows::getHandle() const {
         if (sock_ == INVALID_SOCKET) {
             return make_unexpected(ErrorCode::InvalidSocket);
@@ -185,129 +419,94 @@ namespace pulse::net::udp {
         }
     }
 
-    std::expected<Addr, Error> SocketWindows::DecodeAddr(const sockaddr* addr) {
-        char ip[INET6_ADDRSTRLEN];
-        uint16_t port = 0;
-    
-        if (addr->sa_family == AF_INET) {
-            auto* a = reinterpret_cast<const sockaddr_in*>(addr);
-            if (!inet_ntop(AF_INET, &a->sin_addr, ip, sizeof(ip))) {
-                return make_unexpected(ErrorCode::InvalidAddress);
-            }
-            port = ntohs(a->sin_port);
-        } else if (addr->sa_family == AF_INET6) {
-            auto* a = reinterpret_cast<const sockaddr_in6*>(addr);
-            if (!inet_ntop(AF_INET6, &a->sin6_addr, ip, sizeof(ip))) {
-                return make_unexpected(ErrorCode::InvalidAddress);
-            }
-            port = ntohs(a->sin6_port);
-        } else {
-            return make_unexpected(ErrorCode::UnsupportedAddressFamily);
+    std::expected<std::unique_ptr<ISocket>, Error> SocketWindows::Listen(const Addr& bind_addr, const SocketOptions& options) {
+        if (auto checked = check_socket_options(options); !checked) {
+            return std::unexpected(checked.error());
         }
-    
-        return Addr::Create(ip, port);
-    }
-
-    std::expected<std::unique_ptr<ISocket>, Error> SocketWindows::Listen(const Addr& bind_addr) {
         if (auto err = init_wsa(); !err) {
             return std::unexpected(err.error());
         }
 
-        int family = AF_INET;
-        const void* addr_ptr = nullptr;
-
-        sockaddr_in addr4{};
-        sockaddr_in6 addr6{};
-
-        if (inet_pton(AF_INET, bind_addr.ip.c_str(), &addr4.sin_addr) == 1) {
-            family = AF_INET;
-            addr4.sin_family = AF_INET;
-            addr4.sin_port = htons(bind_addr.port);
-            addr_ptr = &addr4;
-        } else if (inet_pton(AF_INET6, bind_addr.ip.c_str(), &addr6.sin6_addr) == 1) {
-            family = AF_INET6;
-            addr6.sin6_family = AF_INET6;
-            addr6.sin6_port = htons(bind_addr.port);
-            addr_ptr = &addr6;
-        } else {
+        const auto* addr = static_cast<const sockaddr*>(bind_addr.sockaddrData());
+        const int family = addr->sa_family;
+        if (family != AF_INET && family != AF_INET6) {
             return make_unexpected(ErrorCode::InvalidAddress);
         }
 
         SOCKET sock = socket(family, SOCK_DGRAM, IPPROTO_UDP);
         if (sock == INVALID_SOCKET) {
-            return make_unexpected(ErrorCode::SocketCreateFailed);
+            return make_unexpected(ErrorCode::SocketCreateFailed, WSAGetLastError());
         }
 
         u_long mode = 1;
         if (ioctlsocket(sock, FIONBIO, &mode) != 0) {
+            const int err = WSAGetLastError();
             closesocket(sock);
-            return make_unexpected(ErrorCode::SocketConfigFailed);
+            return make_unexpected(ErrorCode::SocketConfigFailed, err);
         }
 
-        int result = bind(
-            sock,
-            reinterpret_cast<const sockaddr*>(addr_ptr),
-            (family == AF_INET) ? sizeof(sockaddr_in) : sizeof(sockaddr_in6)
-        );
+        if (auto applied = apply_socket_options(sock, family, options); !applied) {
+            closesocket(sock);
+            return std::unexpected(applied.error());
+        }
+
+        int result = bind(sock, addr, static_cast<int>(bind_addr.sockaddrLen()));
 
         if (result < 0) {
+            const int err = WSAGetLastError();
             closesocket(sock);
-            return make_unexpected(ErrorCode::BindFailed);
+            return make_unexpected(ErrorCode::BindFailed, err);
         }
 
-        return std::make_unique<SocketWindows>(sock);
+        return std::make_unique<SocketWindows>(sock, options);
     }
 
-    std::expected<std::unique_ptr<ISocket>, Error> SocketWindows::Dial(const Addr& remote_addr) {
+    std::expected<std::unique_ptr<ISocket>, Error> SocketWindows::Dial(const Addr& remote_addr, const SocketOptions& options) {
+        if (auto checked = check_socket_options(options); !checked) {
+            return std::unexpected(checked.error());
+        }
         if (auto err = init_wsa(); !err) {
             return std::unexpected(err.error());
         }
 
-        int family = AF_INET;
-        sockaddr_storage remote_sock{};
-        int remote_len = 0;
-
-        if (InetPtonA(AF_INET, remote_addr.ip.c_str(), &reinterpret_cast<sockaddr_in*>(&remote_sock)->sin_addr) == 1) {
-            auto* addr4 = reinterpret_cast<sockaddr_in*>(&remote_sock);
-            family = AF_INET;
-            addr4->sin_family = AF_INET;
-            addr4->sin_port = htons(remote_addr.port);
-            remote_len = sizeof(sockaddr_in);
-        } else if (InetPtonA(AF_INET6, remote_addr.ip.c_str(), &reinterpret_cast<sockaddr_in6*>(&remote_sock)->sin6_addr) == 1) {
-            auto* addr6 = reinterpret_cast<sockaddr_in6*>(&remote_sock);
-            family = AF_INET6;
-            addr6->sin6_family = AF_INET6;
-            addr6->sin6_port = htons(remote_addr.port);
-            remote_len = sizeof(sockaddr_in6);
-        } else {
+        const auto* addr = static_cast<const sockaddr*>(remote_addr.sockaddrData());
+        const int family = addr->sa_family;
+        if (family != AF_INET && family != AF_INET6) {
             return make_unexpected(ErrorCode::InvalidAddress);
         }
 
         SOCKET sock = socket(family, SOCK_DGRAM, 0);
         if (sock == INVALID_SOCKET) {
-            return make_unexpected(ErrorCode::SocketCreateFailed);
+            return make_unexpected(ErrorCode::SocketCreateFailed, WSAGetLastError());
         }
 
         // Non-blocking
         u_long mode = 1;
         if (ioctlsocket(sock, FIONBIO, &mode) != 0) {
+            const int err = WSAGetLastError();
+            closesocket(sock);
+            return make_unexpected(ErrorCode::SocketConfigFailed, err);
+        }
+
+        if (auto applied = apply_socket_options(sock, family, options); !applied) {
             closesocket(sock);
-            return make_unexpected(ErrorCode::SocketConfigFailed);
+            return std::unexpected(applied.error());
         }
 
-        if (connect(sock, reinterpret_cast<sockaddr*>(&remote_sock), remote_len) == SOCKET_ERROR) {
+        if (connect(sock, addr, static_cast<int>(remote_addr.sockaddrLen())) == SOCKET_ERROR) {
+            const int err = WSAGetLastError();
             closesocket(sock);
-            return make_unexpected(ErrorCode::ConnectFailed);
+            return make_unexpected(ErrorCode::ConnectFailed, err);
         }
 
         try {
-            return std::make_unique<SocketWindows>(sock);
+            return std::make_unique<SocketWindows>(sock, options);
         } catch (std::bad_alloc& err) {
             closesocket(sock);
             return make_unexpected(ErrorCode::SocketCreateFailed, err);
         } catch (...) {
             closesocket(sock);
-            return make_unexpected(ErrorCode::SocketCreateFailed, "Unknown error occurred while creating SocketWindows");
+            return make_unexpected(ErrorCode::SocketCreateFailed, "Unexpected exception while creating SocketWindows");
         }
     }
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <pulse/net/udp/error_code.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <memory>
+
+namespace pulse::net::udp {
+
+    // The XDP program that steers our UDP traffic into AF_XDP sockets, plus the XSKMAP it redirects
+    // through. It matches IPv4/UDP frames for one local address and port (the address may be 0 for
+    // any) and hands them to the socket registered for the receive queue they arrived on; everything
+    // else, ARP included, goes on to the kernel stack. Loaded with raw bpf() calls rather than libbpf
+    // so the library keeps zero dependencies, and attached through a BPF link (Linux 5.9+), so the
+    // program comes off the interface when the last descriptor closes, even if we crash.
+    class XdpProgram {
+    public:
+        ~XdpProgram();
+
+        XdpProgram(const XdpProgram&) = delete;
+        XdpProgram& operator=(const XdpProgram&) = delete;
+
+        // `ip` and `port` are in network byte order. `queues` is the number of XSKMAP slots.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<XdpProgram>, Error> Load(uint32_t ip, uint16_t port, uint32_t queues);
+
+        // Attaches in driver (native) mode, or generic SKB mode, which any interface supports.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> attach(unsigned ifindex, bool native);
+
+        void detach();
+
+        // Points `queue`'s slot at a bound AF_XDP socket.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> registerSocket(uint32_t queue, int xsk_fd);
+
+    private:
+        XdpProgram() = default;
+
+        int map_fd_ = -1;
+        int prog_fd_ = -1;
+        int link_fd_ = -1;
+    };
+
+} // namespace pulse::net::udp
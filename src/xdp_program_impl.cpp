@@ -0,0 +1,196 @@
+#include "xdp_program.h"
+
+#include <linux/bpf.h>
+#include <linux/if_link.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <errno.h>
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+namespace pulse::net::udp {
+
+    namespace {
+
+        int sys_bpf(int cmd, bpf_attr* attr) {
+            return static_cast<int>(::syscall(__NR_bpf, cmd, attr, sizeof(*attr)));
+        }
+
+        constexpr bpf_insn insn(uint8_t code, uint8_t dst, uint8_t src, int16_t off, int32_t imm) {
+            bpf_insn instruction{};
+            instruction.code = code;
+            instruction.dst_reg = dst & 0xf;
+            instruction.src_reg = src & 0xf;
+            instruction.off = off;
+            instruction.imm = imm;
+            return instruction;
+        }
+
+        // Frame offsets, all behind a 14-byte Ethernet header and an option-less 20-byte IPv4 header.
+        constexpr int16_t kEtherTypeOffset = 12;
+        constexpr int16_t kIpVersionOffset = 14;
+        constexpr int16_t kIpFragmentOffset = 20;
+        constexpr int16_t kIpProtocolOffset = 23;
+        constexpr int16_t kIpDestinationOffset = 30;
+        constexpr int16_t kUdpDestinationOffset = 36;
+        constexpr int32_t kHeadersSize = 42;
+
+        // Builds the program. Loads from the packet land in registers in memory order, so every
+        // constant compared against them is spelled in network byte order and the program reads the
+        // same on either endianness. 32-bit compares (BPF_JMP32, 5.1+) keep the IPv4 address from
+        // being sign-extended.
+        class Assembler {
+        public:
+            void emit(bpf_insn instruction) { program_[size_++] = instruction; }
+
+            void load(uint8_t size, uint8_t dst, uint8_t src, int16_t offset) {
+                emit(insn(BPF_LDX | size | BPF_MEM, dst, src, offset, 0));
+            }
+
+            // Jumps to the XDP_PASS exit unless `reg` == `value`.
+            void passUnless(uint8_t reg, int32_t value) {
+                passes_[pass_count_++] = size_;
+                emit(insn(BPF_JMP32 | BPF_JNE | BPF_K, reg, 0, 0, value));
+            }
+
+            void passIfPastEnd(uint8_t end_reg, uint8_t limit_reg) {
+                passes_[pass_count_++] = size_;
+                emit(insn(BPF_JMP | BPF_JGT | BPF_X, end_reg, limit_reg, 0, 0));
+            }
+
+            void finish() {
+                emit(insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+                const size_t pass = size_;
+                emit(insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_0, 0, 0, XDP_PASS));
+                emit(insn(BPF_JMP | BPF_EXIT, 0, 0, 0, 0));
+                for (size_t i = 0; i < pass_count_; ++i) {
+                    program_[passes_[i]].off = static_cast<int16_t>(pass - passes_[i] - 1);
+                }
+            }
+
+            const bpf_insn* data() const { return program_.data(); }
+            size_t size() const { return size_; }
+
+        private:
+            std::array<bpf_insn, 48> program_{};
+            size_t size_ = 0;
+            std::array<size_t, 16> passes_{};
+            size_t pass_count_ = 0;
+        };
+
+    } // namespace
+
+    XdpProgram::~XdpProgram() {
+        detach();
+        if (prog_fd_ >= 0) {
+            ::close(prog_fd_);
+        }
+        if (map_fd_ >= 0) {
+            ::close(map_fd_);
+        }
+    }
+
+    std::expected<std::unique_ptr<XdpProgram>, Error> XdpProgram::Load(uint32_t ip, uint16_t port, uint32_t queues) {
+        std::unique_ptr<XdpProgram> program;
+        try {
+            program.reset(new XdpProgram());
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+
+        bpf_attr attr{};
+        attr.map_type = BPF_MAP_TYPE_XSKMAP;
+        attr.key_size = sizeof(uint32_t);
+        attr.value_size = sizeof(uint32_t);
+        attr.max_entries = queues;
+        std::strncpy(attr.map_name, "pulsenet_xsks", sizeof(attr.map_name) - 1);
+        program->map_fd_ = sys_bpf(BPF_MAP_CREATE, &attr);
+        if (program->map_fd_ < 0) {
+            return make_unexpected(errno == EPERM || errno == ENOSYS ? ErrorCode::Unsupported : ErrorCode::SocketCreateFailed, errno, "BPF_MAP_CREATE");
+        }
+
+        Assembler code;
+        code.emit(insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_6, BPF_REG_1, 0, 0));                  // r6 = ctx
+        code.load(BPF_W, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, data));                            // r2 = data
+        code.load(BPF_W, BPF_REG_3, BPF_REG_6, offsetof(xdp_md, data_end));                        // r3 = data_end
+        code.emit(insn(BPF_ALU64 | BPF_MOV | BPF_X, BPF_REG_4, BPF_REG_2, 0, 0));
+        code.emit(insn(BPF_ALU64 | BPF_ADD | BPF_K, BPF_REG_4, 0, 0, kHeadersSize));
+        code.passIfPastEnd(BPF_REG_4, BPF_REG_3);                                                  // Too short for UDP/IPv4
+        code.load(BPF_H, BPF_REG_5, BPF_REG_2, kEtherTypeOffset);
+        code.passUnless(BPF_REG_5, htons(0x0800));                                                 // IPv4
+        code.load(BPF_B, BPF_REG_5, BPF_REG_2, kIpVersionOffset);
+        code.passUnless(BPF_REG_5, 0x45);                                                          // No IP options
+        code.load(BPF_B, BPF_REG_5, BPF_REG_2, kIpProtocolOffset);
+        code.passUnless(BPF_REG_5, IPPROTO_UDP);
+        code.load(BPF_H, BPF_REG_5, BPF_REG_2, kIpFragmentOffset);
+        code.emit(insn(BPF_ALU | BPF_AND | BPF_K, BPF_REG_5, 0, 0, htons(0x3fff)));
+        code.passUnless(BPF_REG_5, 0);                                                             // Fragments go to the stack
+        code.load(BPF_H, BPF_REG_5, BPF_REG_2, kUdpDestinationOffset);
+        code.passUnless(BPF_REG_5, port);
+        if (ip != 0) {
+            code.load(BPF_W, BPF_REG_5, BPF_REG_2, kIpDestinationOffset);
+            code.passUnless(BPF_REG_5, static_cast<int32_t>(ip));
+        }
+        code.emit(insn(BPF_LD | BPF_DW | BPF_IMM, BPF_REG_1, BPF_PSEUDO_MAP_FD, 0, program->map_fd_));
+        code.emit(insn(0, 0, 0, 0, 0));
+        code.load(BPF_W, BPF_REG_2, BPF_REG_6, offsetof(xdp_md, rx_queue_index));
+        code.emit(insn(BPF_ALU64 | BPF_MOV | BPF_K, BPF_REG_3, 0, 0, XDP_PASS));                   // Empty slot: pass
+        code.emit(insn(BPF_JMP | BPF_CALL, 0, 0, 0, BPF_FUNC_redirect_map));
+        code.finish();
+
+        static const char license[] = "GPL";
+        attr = bpf_attr{};
+        attr.prog_type = BPF_PROG_TYPE_XDP;
+        attr.expected_attach_type = BPF_XDP;
+        attr.insns = reinterpret_cast<uint64_t>(code.data());
+        attr.insn_cnt = static_cast<uint32_t>(code.size());
+        attr.license = reinterpret_cast<uint64_t>(license);
+        std::strncpy(attr.prog_name, "pulsenet_xsk", sizeof(attr.prog_name) - 1);
+        program->prog_fd_ = sys_bpf(BPF_PROG_LOAD, &attr);
+        if (program->prog_fd_ < 0) {
+            return make_unexpected(errno == EPERM ? ErrorCode::Unsupported : ErrorCode::SocketCreateFailed, errno, "BPF_PROG_LOAD");
+        }
+
+        return program;
+    }
+
+    std::expected<void, Error> XdpProgram::attach(unsigned ifindex, bool native) {
+        detach();
+
+        bpf_attr attr{};
+        attr.link_create.prog_fd = static_cast<uint32_t>(prog_fd_);
+        attr.link_create.target_ifindex = ifindex;
+        attr.link_create.attach_type = BPF_XDP;
+        attr.link_create.flags = native ? XDP_FLAGS_DRV_MODE : XDP_FLAGS_SKB_MODE;
+        link_fd_ = sys_bpf(BPF_LINK_CREATE, &attr);
+        if (link_fd_ < 0) {
+            // EBUSY: something else already owns the interface's XDP hook.
+            return make_unexpected(errno == EBUSY ? ErrorCode::BindFailed : ErrorCode::Unsupported, errno, "BPF_LINK_CREATE");
+        }
+        return {};
+    }
+
+    void XdpProgram::detach() {
+        if (link_fd_ >= 0) {
+            ::close(link_fd_);
+            link_fd_ = -1;
+        }
+    }
+
+    std::expected<void, Error> XdpProgram::registerSocket(uint32_t queue, int xsk_fd) {
+        const uint32_t value = static_cast<uint32_t>(xsk_fd);
+        bpf_attr attr{};
+        attr.map_fd = static_cast<uint32_t>(map_fd_);
+        attr.key = reinterpret_cast<uint64_t>(&queue);
+        attr.value = reinterpret_cast<uint64_t>(&value);
+        attr.flags = BPF_ANY;
+        if (sys_bpf(BPF_MAP_UPDATE_ELEM, &attr) < 0) {
+            return make_unexpected(ErrorCode::SocketConfigFailed, errno, "XSKMAP update");
+        }
+        return {};
+    }
+
+} // namespace pulse::net::udp
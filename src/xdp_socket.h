@@ -0,0 +1,203 @@
+#pragma once
+
+#include <pulse/net/udp/socket_factory.h>
+#include <pulse/net/udp/udp.h>
+#include <pulse/net/udp/error_code.h>
+#include <pulse/net/udp/udp_addr.h>
+
+#include "capture_tap.h"
+#include "socket_counters.h"
+#include "xdp_program.h"
+
+#include <linux/if_xdp.h>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pulse::net::udp {
+
+    // What the sockets from one listen(), dial() or listenSharded() share: the interface, the XDP program
+    // on it, and a kernel UDP socket bound to the same address and port, so nothing else on the host is
+    // handed the port while we're using it. Addresses and ports are in network byte order.
+    struct XdpInterface {
+        ~XdpInterface();
+
+        std::string name;
+        unsigned ifindex = 0;
+        bool loopback = false;
+        std::array<uint8_t, 6> mac{};
+        uint32_t ip = 0;
+        uint32_t netmask = 0;
+        uint16_t port = 0;
+        size_t mtu = 1500;
+        int reservation_fd = -1;
+        std::unique_ptr<XdpProgram> program;
+    };
+
+    // One of the four single-producer/single-consumer rings an AF_XDP socket shares with the kernel.
+    // For the rings we produce into (fill, TX) `cached` is our producer index; for the ones we consume
+    // from (RX, completion) it's our consumer index.
+    template <typename Entry>
+    struct XdpRing {
+        uint32_t* producer = nullptr;
+        uint32_t* consumer = nullptr;
+        uint32_t* flags = nullptr;
+        Entry* entries = nullptr;
+        uint32_t mask = 0;
+        uint32_t cached = 0;
+        void* map = nullptr;
+        size_t map_size = 0;
+    };
+
+    // ISocket on an AF_XDP socket. Datagrams arrive as raw Ethernet frames in UMEM, memory shared with
+    // the kernel, and are parsed in place; sends build the frame in UMEM and queue it for the driver.
+    // recvFrom() without a buffer hands back a view straight into the frame. Calls never block: an
+    // empty RX ring or a TX side out of frames is WouldBlock, as on every other backend.
+    class SocketXdp final : public ISocket {
+    public:
+        ~SocketXdp() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> sendTo(const Addr& addr, const uint8_t* data, size_t length) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> send(const uint8_t* data, size_t length) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendBatch(std::span<OutgoingPacket> packets) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segmentSize) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFrom() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> recvFrom(ReceivedPacket&& packet) override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> recvBatch(std::span<ReceivedPacket> packets) override;
+
+        // kernelDrops comes from XDP_STATISTICS: frames the kernel couldn't put on a full RX ring.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<SocketMetrics, Error> metrics() const override;
+
+        // The AF_XDP socket, which polls readable while the RX ring has frames.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<int, Error> getHandle() const override;
+
+        [[nodiscard("Why did you ask for this and then ignore it?")]]
+        SpinBudget* spinBudget() noexcept override {
+            return &spin_budget_;
+        }
+
+        void close() override;
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<ISocket>, Error> Listen(const Addr& bindAddr, const SocketOptions& options, const XdpOptions& xdpOptions);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::vector<std::unique_ptr<ISocket>>, Error> ListenSharded(const Addr& bindAddr, size_t shards, const SocketOptions& options, const XdpOptions& xdpOptions);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<ISocket>, Error> Dial(const Addr& remoteAddr, const SocketOptions& options, const XdpOptions& xdpOptions);
+
+    private:
+        static constexpr size_t kFrameSize = 4096;
+        static constexpr size_t kNeighbourSlots = 256;
+        static constexpr std::chrono::milliseconds kNeighbourRetry{100};
+
+        // Where datagrams for one destination go, keyed by the destination rather than the next hop, so a
+        // send that hits never reads /proc. Unresolved entries keep the route's answer and only ask the
+        // ARP table again once kNeighbourRetry has passed.
+        struct Neighbour {
+            uint32_t ip = 0;       // Destination
+            uint32_t next_hop = 0; // ip itself if on-link, else the gateway; unused once resolved
+            std::array<uint8_t, 6> mac{};
+            bool resolved = false;
+            std::chrono::steady_clock::time_point retry_at{};
+        };
+
+        SocketXdp() = default;
+
+        // Sockets for queues 0..queues-1 on the interface `reservation_fd` is bound to, with the program
+        // attached and every socket bound. Takes ownership of `reservation_fd`.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::vector<std::unique_ptr<SocketXdp>>, Error> OpenGroup(int reservation_fd, size_t queues, const SocketOptions& options, const XdpOptions& xdp_options, const Addr* remote);
+
+        // Creates the socket, its UMEM and rings; not yet bound to a queue.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        static std::expected<std::unique_ptr<SocketXdp>, Error> Create(std::shared_ptr<XdpInterface> interface, uint32_t queue, const SocketOptions& options, const XdpOptions& xdp_options);
+
+        // Binds to the queue and hands the kernel the receive frames.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> bindQueue(uint16_t flags);
+
+        // The unrecorded operations behind the public ones, which add them to counters_ once they return.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> transmitBatch(std::span<OutgoingPacket> packets);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> receiveView();
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> receiveInto(ReceivedPacket&& packet);
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<size_t, Error> receiveBatch(std::span<ReceivedPacket> packets);
+
+        // Next datagram off the RX ring, as a view into its frame. The frame is lent out through `frame`
+        // and must be handed back with recycleFrame(). Frames that aren't for us are recycled here, as
+        // are oversized datagrams, which are reported as Truncated.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<ReceivedPacket, Error> nextRecv(uint64_t& frame);
+
+        void recycleFrame(uint64_t frame);
+        void recycleHeldFrame();
+
+        // Writes one datagram into a free TX frame and queues it; flushTx() hands the queue to the kernel.
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> queueFrame(const Addr& addr, const uint8_t* data, size_t length);
+        void flushTx();
+        void reclaimTxFrames();
+
+        // Ethernet address of the next hop towards `ip`, from datagrams we've received or the kernel's
+        // neighbour table. False if neither knows it yet.
+        bool resolveNextHop(uint32_t ip, std::array<uint8_t, 6>& mac);
+        // Replies to `ip` go back the way its datagram came: to the frame's source MAC.
+        void learnNeighbour(uint32_t ip, const uint8_t* mac) noexcept;
+        Neighbour& neighbourSlot(uint32_t ip) noexcept;
+
+        std::shared_ptr<XdpInterface> interface_;
+        uint32_t queue_ = 0;
+        int xsk_fd_ = -1;
+        bool copy_mode_ = true;
+
+        uint8_t* umem_ = nullptr;
+        size_t umem_size_ = 0;
+        uint32_t ring_size_ = 0;
+        XdpRing<uint64_t> fill_;
+        XdpRing<uint64_t> completion_;
+        XdpRing<xdp_desc> rx_;
+        XdpRing<xdp_desc> tx_;
+        std::vector<uint64_t> free_tx_frames_;
+
+        size_t max_datagram_size_ = 0;
+        uint8_t tos_ = 0;
+        uint16_t ip_id_ = 0;
+        bool connected_ = false; // Dialed: only the remote's datagrams are received, and send() goes to it
+        Addr remote_;
+        uint32_t remote_ip_ = 0;
+        uint16_t remote_port_ = 0;
+        bool truncation_pending_ = false; // Held back by a recvBatch() that returned other datagrams
+        int64_t held_frame_ = -1; // Frame behind the last recvFrom() view, recycled on the next receive
+
+        std::array<Neighbour, kNeighbourSlots> neighbours_{};
+        std::unique_ptr<SocketCounters> counters_;
+        std::unique_ptr<CaptureTap> tap_;
+        SpinBudget spin_budget_; // What recvFromUntil() has learned about arrival gaps here
+    };
+
+} // namespace pulse::net::udp
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <pulse/net/udp/socket_factory.h>
+#include "xdp_socket.h"
+
+namespace pulse::net::udp {
+
+    class XdpSocketFactory : public ISocketFactory {
+    public:
+        explicit XdpSocketFactory(const XdpOptions& options) : options_(options) {}
+
+        using ISocketFactory::listen;
+        using ISocketFactory::dial;
+
+        std::expected<std::unique_ptr<ISocket>, Error> listen(const Addr& bind_addr) override {
+            return SocketXdp::Listen(bind_addr, {}, options_);
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> listenWithOptions(const Addr& bind_addr, const SocketOptions& options) override {
+            return SocketXdp::Listen(bind_addr, options, options_);
+        }
+
+        std::expected<std::vector<std::unique_ptr<ISocket>>, Error> listenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options = {}) override {
+            return SocketXdp::ListenSharded(bind_addr, shards, options, options_);
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> dial(const Addr& remote_addr) override {
+            return SocketXdp::Dial(remote_addr, {}, options_);
+        }
+
+        std::expected<std::unique_ptr<ISocket>, Error> dialWithOptions(const Addr& remote_addr, const SocketOptions& options) override {
+            return SocketXdp::Dial(remote_addr, options, options_);
+        }
+
+    private:
+        XdpOptions options_;
+    };
+
+} // namespace pulse::net::udp
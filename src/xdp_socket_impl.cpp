@@ -0,0 +1,990 @@
+#include "pulse/net/udp/udp.h"
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netinet/in.h>
+#include <ifaddrs.h>
+#include <unistd.h>
+#include <errno.h>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+#include "xdp_socket.h"
+#include "unix_socket.h"
+#include "unix_error_map.h"
+#include "socket_options_check.h"
+
+#if !defined(SOL_XDP)
+#define SOL_XDP 283
+#endif
+
+namespace pulse::net::udp {
+
+    namespace {
+
+        constexpr size_t kEthernetHeaderSize = 14;
+        constexpr size_t kIpv4HeaderSize = 20;
+        constexpr size_t kUdpHeaderSize = 8;
+        constexpr size_t kHeadersSize = kEthernetHeaderSize + kIpv4HeaderSize + kUdpHeaderSize;
+        constexpr size_t kMaxBatchSize = 64;
+
+        // Zero-copy drivers put the frame XDP_PACKET_HEADROOM bytes into its chunk, so that's lost.
+        constexpr size_t kFrameHeadroom = 256;
+
+        uint32_t load_acquire(uint32_t* p) {
+            return std::atomic_ref<uint32_t>(*p).load(std::memory_order_acquire);
+        }
+
+        void store_release(uint32_t* p, uint32_t value) {
+            std::atomic_ref<uint32_t>(*p).store(value, std::memory_order_release);
+        }
+
+        template <typename Entry>
+        std::expected<void, Error> map_ring(int fd, const xdp_ring_offset& offsets, uint32_t entries, off_t page_offset, XdpRing<Entry>& ring) {
+            ring.map_size = offsets.desc + entries * sizeof(Entry);
+            void* map = ::mmap(nullptr, ring.map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, page_offset);
+            if (map == MAP_FAILED) {
+                ring.map = nullptr;
+                return make_unexpected(ErrorCode::SocketCreateFailed, errno, "AF_XDP ring mmap");
+            }
+            auto* base = static_cast<uint8_t*>(map);
+            ring.map = map;
+            ring.producer = reinterpret_cast<uint32_t*>(base + offsets.producer);
+            ring.consumer = reinterpret_cast<uint32_t*>(base + offsets.consumer);
+            ring.flags = reinterpret_cast<uint32_t*>(base + offsets.flags);
+            ring.entries = reinterpret_cast<Entry*>(base + offsets.desc);
+            ring.mask = entries - 1;
+            ring.cached = 0;
+            return {};
+        }
+
+        template <typename Entry>
+        void unmap_ring(XdpRing<Entry>& ring) {
+            if (ring.map) {
+                ::munmap(ring.map, ring.map_size);
+                ring = XdpRing<Entry>{};
+            }
+        }
+
+        // Ones' complement sum of big-endian 16-bit words, folded by finish_checksum().
+        uint32_t add_checksum(uint32_t sum, const uint8_t* data, size_t length) {
+            for (; length > 1; data += 2, length -= 2) {
+                sum += static_cast<uint32_t>(data[0] << 8 | data[1]);
+            }
+            if (length == 1) {
+                sum += static_cast<uint32_t>(data[0] << 8);
+            }
+            return sum;
+        }
+
+        uint16_t finish_checksum(uint32_t sum) {
+            while (sum >> 16) {
+                sum = (sum & 0xffff) + (sum >> 16);
+            }
+            return static_cast<uint16_t>(~sum);
+        }
+
+        void put16(uint8_t* p, uint16_t value) {
+            p[0] = static_cast<uint8_t>(value >> 8);
+            p[1] = static_cast<uint8_t>(value);
+        }
+
+        uint16_t get16(const uint8_t* p) {
+            return static_cast<uint16_t>(p[0] << 8 | p[1]);
+        }
+
+        sockaddr_in ipv4_of(const Addr& addr) {
+            sockaddr_in in{};
+            std::memcpy(&in, addr.sockaddrData(), sizeof(in));
+            return in;
+        }
+
+        // Fills in the interface that owns `ip`: name, index, netmask, hardware address and MTU.
+        std::expected<void, Error> find_interface(int fd, uint32_t ip, XdpInterface& interface) {
+            ifaddrs* addrs = nullptr;
+            if (::getifaddrs(&addrs) < 0) {
+                return make_unexpected(ErrorCode::SocketConfigFailed, errno, "getifaddrs");
+            }
+            for (ifaddrs* it = addrs; it != nullptr; it = it->ifa_next) {
+                if (it->ifa_addr == nullptr || it->ifa_addr->sa_family != AF_INET) {
+                    continue;
+                }
+                if (reinterpret_cast<const sockaddr_in*>(it->ifa_addr)->sin_addr.s_addr != ip) {
+                    continue;
+                }
+                try {
+                    interface.name = it->ifa_name;
+                } catch (std::bad_alloc& err) {
+                    ::freeifaddrs(addrs);
+                    return make_unexpected(ErrorCode::SocketCreateFailed, err);
+                }
+                interface.loopback = (it->ifa_flags & IFF_LOOPBACK) != 0;
+                if (it->ifa_netmask != nullptr) {
+                    interface.netmask = reinterpret_cast<const sockaddr_in*>(it->ifa_netmask)->sin_addr.s_addr;
+                }
+                break;
+            }
+            ::freeifaddrs(addrs);
+
+            if (interface.name.empty()) {
+                return make_unexpected(ErrorCode::InvalidAddress, "No interface has this address");
+            }
+            interface.ifindex = ::if_nametoindex(interface.name.c_str());
+            if (interface.ifindex == 0) {
+                return make_unexpected(ErrorCode::SocketConfigFailed, errno, "if_nametoindex");
+            }
+
+            ifreq request{};
+            std::strncpy(request.ifr_name, interface.name.c_str(), IFNAMSIZ - 1);
+            if (::ioctl(fd, SIOCGIFHWADDR, &request) < 0) {
+                return make_unexpected(ErrorCode::SocketConfigFailed, errno, "SIOCGIFHWADDR");
+            }
+            std::memcpy(interface.mac.data(), request.ifr_hwaddr.sa_data, interface.mac.size());
+            if (::ioctl(fd, SIOCGIFMTU, &request) < 0) {
+                return make_unexpected(ErrorCode::SocketConfigFailed, errno, "SIOCGIFMTU");
+            }
+            interface.mtu = static_cast<size_t>(request.ifr_mtu);
+            return {};
+        }
+
+        // The gateway /proc/net/route picks for `ip` on `interface`, or `ip` itself if it's on-link.
+        uint32_t route_next_hop(const std::string& interface, uint32_t ip) {
+            FILE* routes = std::fopen("/proc/net/route", "re");
+            if (routes == nullptr) {
+                return ip;
+            }
+            uint32_t next_hop = ip;
+            int best_prefix = -1;
+            char line[256];
+            char name[IFNAMSIZ + 1];
+            unsigned destination = 0, gateway = 0, flags = 0, mask = 0;
+            while (std::fgets(line, sizeof(line), routes)) {
+                // Addresses are printed as raw network-order words, so they read back as s_addr values.
+                if (std::sscanf(line, "%16s %x %x %x %*d %*d %*d %x", name, &destination, &gateway, &flags, &mask) != 5) {
+                    continue;
+                }
+                const int prefix = std::popcount(mask);
+                if (interface != name || (ip & mask) != destination || prefix <= best_prefix) {
+                    continue;
+                }
+                best_prefix = prefix;
+                next_hop = (flags & 0x2) != 0 ? gateway : ip; // RTF_GATEWAY
+            }
+            std::fclose(routes);
+            return next_hop;
+        }
+
+        // A complete entry for `ip` on `interface` in the kernel's ARP table.
+        bool read_arp_entry(const std::string& interface, uint32_t ip, std::array<uint8_t, 6>& mac) {
+            FILE* table = std::fopen("/proc/net/arp", "re");
+            if (table == nullptr) {
+                return false;
+            }
+            bool found = false;
+            char line[256];
+            char address[64], hardware[64], device[IFNAMSIZ + 1];
+            unsigned flags = 0;
+            while (!found && std::fgets(line, sizeof(line), table)) {
+                if (std::sscanf(line, "%63s %*s %x %63s %*s %16s", address, &flags, hardware, device) != 4) {
+                    continue;
+                }
+                in_addr parsed{};
+                if ((flags & 0x2) == 0 || interface != device || ::inet_pton(AF_INET, address, &parsed) != 1 || parsed.s_addr != ip) {
+                    continue; // ATF_COM marks a resolved entry
+                }
+                unsigned bytes[6];
+                if (std::sscanf(hardware, "%x:%x:%x:%x:%x:%x", &bytes[0], &bytes[1], &bytes[2], &bytes[3], &bytes[4], &bytes[5]) == 6) {
+                    for (size_t i = 0; i < mac.size(); ++i) {
+                        mac[i] = static_cast<uint8_t>(bytes[i]);
+                    }
+                    found = true;
+                }
+            }
+            std::fclose(table);
+            return found;
+        }
+
+    } // namespace
+
+    XdpInterface::~XdpInterface() {
+        program.reset(); // Detach before the port goes back to the kernel
+        if (reservation_fd >= 0) {
+            ::close(reservation_fd);
+        }
+    }
+
+    SocketXdp::~SocketXdp() {
+        close();
+    }
+
+    std::expected<std::unique_ptr<SocketXdp>, Error> SocketXdp::Create(std::shared_ptr<XdpInterface> interface, uint32_t queue, const SocketOptions& options, const XdpOptions& xdp_options) {
+        std::unique_ptr<SocketXdp> socket;
+        try {
+            socket.reset(new SocketXdp());
+            socket->free_tx_frames_.reserve(xdp_options.ringSize);
+            if (options.metrics) {
+                socket->counters_ = std::make_unique<SocketCounters>();
+            }
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        if (options.capture) {
+            sockaddr_in local{};
+            local.sin_family = AF_INET;
+            local.sin_port = interface->port;
+            local.sin_addr.s_addr = interface->ip;
+            try {
+                socket->tap_ = std::make_unique<CaptureTap>(options.capture, Addr::FromSockaddr(&local, sizeof(local)).value_or(Addr{}), std::nullopt);
+            } catch (std::bad_alloc& err) {
+                return make_unexpected(ErrorCode::SocketCreateFailed, err);
+            }
+        }
+        socket->interface_ = std::move(interface);
+        socket->queue_ = queue;
+        socket->ring_size_ = xdp_options.ringSize;
+        socket->max_datagram_size_ = options.maxDatagramSize;
+        socket->tos_ = options.tos.value_or(0);
+
+        socket->xsk_fd_ = ::socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC, 0);
+        if (socket->xsk_fd_ < 0) {
+            return make_unexpected(errno == EAFNOSUPPORT || errno == EPERM ? ErrorCode::Unsupported : ErrorCode::SocketCreateFailed, errno, "AF_XDP");
+        }
+
+        // Receive frames come first in the UMEM, send frames after them.
+        const uint32_t frames = 2 * xdp_options.ringSize;
+        socket->umem_size_ = static_cast<size_t>(frames) * kFrameSize;
+        void* umem = ::mmap(nullptr, socket->umem_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (umem == MAP_FAILED) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno, "UMEM mmap");
+        }
+        socket->umem_ = static_cast<uint8_t*>(umem);
+
+        xdp_umem_reg reg{};
+        reg.addr = reinterpret_cast<uint64_t>(socket->umem_);
+        reg.len = socket->umem_size_;
+        reg.chunk_size = kFrameSize;
+        if (::setsockopt(socket->xsk_fd_, SOL_XDP, XDP_UMEM_REG, &reg, sizeof(reg)) < 0) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno, "XDP_UMEM_REG");
+        }
+
+        const int ring_size = static_cast<int>(xdp_options.ringSize);
+        for (int option : { XDP_UMEM_FILL_RING, XDP_UMEM_COMPLETION_RING, XDP_RX_RING, XDP_TX_RING }) {
+            if (::setsockopt(socket->xsk_fd_, SOL_XDP, option, &ring_size, sizeof(ring_size)) < 0) {
+                return make_unexpected(ErrorCode::SocketCreateFailed, errno, "AF_XDP ring size");
+            }
+        }
+
+        xdp_mmap_offsets offsets{};
+        socklen_t offsets_size = sizeof(offsets);
+        if (::getsockopt(socket->xsk_fd_, SOL_XDP, XDP_MMAP_OFFSETS, &offsets, &offsets_size) < 0) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, errno, "XDP_MMAP_OFFSETS");
+        }
+
+        const uint32_t entries = xdp_options.ringSize;
+        if (auto mapped = map_ring(socket->xsk_fd_, offsets.fr, entries, XDP_UMEM_PGOFF_FILL_RING, socket->fill_); !mapped) {
+            return std::unexpected(mapped.error());
+        }
+        if (auto mapped = map_ring(socket->xsk_fd_, offsets.cr, entries, XDP_UMEM_PGOFF_COMPLETION_RING, socket->completion_); !mapped) {
+            return std::unexpected(mapped.error());
+        }
+        if (auto mapped = map_ring(socket->xsk_fd_, offsets.rx, entries, XDP_PGOFF_RX_RING, socket->rx_); !mapped) {
+            return std::unexpected(mapped.error());
+        }
+        if (auto mapped = map_ring(socket->xsk_fd_, offsets.tx, entries, XDP_PGOFF_TX_RING, socket->tx_); !mapped) {
+            return std::unexpected(mapped.error());
+        }
+
+        for (uint32_t i = 0; i < xdp_options.ringSize; ++i) {
+            socket->free_tx_frames_.push_back(static_cast<uint64_t>(xdp_options.ringSize + i) * kFrameSize);
+        }
+        return socket;
+    }
+
+    std::expected<void, Error> SocketXdp::bindQueue(uint16_t flags) {
+        sockaddr_xdp addr{};
+        addr.sxdp_family = AF_XDP;
+        addr.sxdp_flags = flags | XDP_USE_NEED_WAKEUP;
+        addr.sxdp_ifindex = interface_->ifindex;
+        addr.sxdp_queue_id = queue_;
+        if (::bind(xsk_fd_, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+            return make_unexpected(ErrorCode::BindFailed, errno, (flags & XDP_ZEROCOPY) ? "AF_XDP zero-copy bind" : "AF_XDP bind");
+        }
+        copy_mode_ = (flags & XDP_ZEROCOPY) == 0;
+
+        // Every receive frame starts out with the kernel.
+        for (uint32_t i = 0; i < ring_size_; ++i) {
+            fill_.entries[fill_.cached++ & fill_.mask] = static_cast<uint64_t>(i) * kFrameSize;
+        }
+        store_release(fill_.producer, fill_.cached);
+        return {};
+    }
+
+    std::expected<std::vector<std::unique_ptr<SocketXdp>>, Error> SocketXdp::OpenGroup(int reservation_fd, size_t queues, const SocketOptions& options, const XdpOptions& xdp_options, const Addr* remote) {
+        std::shared_ptr<XdpInterface> interface;
+        try {
+            interface = std::make_shared<XdpInterface>();
+        } catch (std::bad_alloc& err) {
+            ::close(reservation_fd);
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        interface->reservation_fd = reservation_fd;
+
+        sockaddr_in local{};
+        socklen_t local_size = sizeof(local);
+        if (::getsockname(reservation_fd, reinterpret_cast<sockaddr*>(&local), &local_size) < 0) {
+            return make_unexpected(ErrorCode::BindFailed, errno);
+        }
+        interface->ip = local.sin_addr.s_addr;
+        interface->port = local.sin_port;
+        if (auto found = find_interface(reservation_fd, interface->ip, *interface); !found) {
+            return std::unexpected(found.error());
+        }
+
+        auto program = XdpProgram::Load(interface->ip, interface->port, static_cast<uint32_t>(queues));
+        if (!program) {
+            return std::unexpected(program.error());
+        }
+        interface->program = std::move(*program);
+
+        // Native mode first when allowed, since only it can do zero-copy; a socket bound in one mode
+        // can't be rebound, so each attempt starts from fresh sockets.
+        const bool modes[2] = { true, false };
+        const bool* first = xdp_options.mode == XdpMode::Generic ? modes + 1 : modes;
+        const bool* last = xdp_options.mode == XdpMode::Native ? modes + 1 : modes + 2;
+        Error failure(ErrorCode::Unsupported);
+
+        for (const bool* native = first; native != last; ++native) {
+            if (auto attached = interface->program->attach(interface->ifindex, *native); !attached) {
+                failure = attached.error();
+                if (failure == ErrorCode::BindFailed) {
+                    break; // Someone else's program; another mode won't help.
+                }
+                continue;
+            }
+
+            std::vector<std::unique_ptr<SocketXdp>> sockets;
+            try {
+                sockets.reserve(queues);
+            } catch (std::bad_alloc& err) {
+                return make_unexpected(ErrorCode::SocketCreateFailed, err);
+            }
+
+            bool bound = true;
+            for (size_t queue = 0; queue < queues && bound; ++queue) {
+                auto socket = Create(interface, static_cast<uint32_t>(queue), options, xdp_options);
+                if (!socket) {
+                    return std::unexpected(socket.error());
+                }
+                auto result = *native ? (*socket)->bindQueue(XDP_ZEROCOPY) : std::expected<void, Error>(make_unexpected(ErrorCode::Unsupported));
+                if (!result) {
+                    result = (*socket)->bindQueue(XDP_COPY);
+                }
+                if (result) {
+                    result = interface->program->registerSocket(static_cast<uint32_t>(queue), (*socket)->xsk_fd_);
+                }
+                if (!result) {
+                    failure = result.error();
+                    bound = false;
+                    break;
+                }
+                if (remote != nullptr) {
+                    const sockaddr_in peer = ipv4_of(*remote);
+                    (*socket)->connected_ = true;
+                    (*socket)->remote_ = *remote;
+                    (*socket)->remote_ip_ = peer.sin_addr.s_addr;
+                    (*socket)->remote_port_ = peer.sin_port;
+                }
+                sockets.push_back(std::move(*socket));
+            }
+            if (bound) {
+                return sockets;
+            }
+            interface->program->detach();
+        }
+
+        return std::unexpected(failure);
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketXdp::Listen(const Addr& bind_addr, const SocketOptions& options, const XdpOptions& xdp_options) {
+        auto sockets = ListenSharded(bind_addr, 1, options, xdp_options);
+        if (!sockets) {
+            return std::unexpected(sockets.error());
+        }
+        return std::move(sockets->front());
+    }
+
+    namespace {
+
+        [[nodiscard("You're ignoring an error message. Don't do that.")]]
+        std::expected<void, Error> check_xdp_options(const Addr& addr, const SocketOptions& options, const XdpOptions& xdp_options, size_t frame_size) {
+            if (auto checked = check_socket_options(options); !checked) {
+                return checked;
+            }
+            if (addr.isIPv6()) {
+                return make_unexpected(ErrorCode::UnsupportedAddressFamily, "AF_XDP sockets are IPv4 only");
+            }
+            if (xdp_options.ringSize == 0 || !std::has_single_bit(xdp_options.ringSize)) {
+                return make_unexpected(ErrorCode::InvalidArgument, "ringSize must be a power of two");
+            }
+            if (options.maxDatagramSize > frame_size - kFrameHeadroom - kHeadersSize) {
+                return make_unexpected(ErrorCode::InvalidArgument, "maxDatagramSize doesn't fit an AF_XDP frame");
+            }
+            if (options.rxTimestamps || options.txTimestamps) {
+                return make_unexpected(ErrorCode::Unsupported, "SO_TIMESTAMPING");
+            }
+            if (options.pacingRate) {
+                return make_unexpected(ErrorCode::Unsupported, "pacing");
+            }
+            return {};
+        }
+
+    } // namespace
+
+    std::expected<std::vector<std::unique_ptr<ISocket>>, Error> SocketXdp::ListenSharded(const Addr& bind_addr, size_t shards, const SocketOptions& options, const XdpOptions& xdp_options) {
+        if (auto checked = check_xdp_options(bind_addr, options, xdp_options, kFrameSize); !checked) {
+            return std::unexpected(checked.error());
+        }
+        if (shards == 0) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        if (ipv4_of(bind_addr).sin_addr.s_addr == INADDR_ANY) {
+            return make_unexpected(ErrorCode::InvalidAddress, "AF_XDP needs the interface's own address, not 0.0.0.0");
+        }
+
+        auto reservation = SocketUnix::OpenBound(bind_addr, options);
+        if (!reservation) {
+            return std::unexpected(reservation.error());
+        }
+        auto group = OpenGroup(*reservation, shards, options, xdp_options, nullptr);
+        if (!group) {
+            return std::unexpected(group.error());
+        }
+
+        std::vector<std::unique_ptr<ISocket>> sockets;
+        try {
+            sockets.reserve(group->size());
+        } catch (std::bad_alloc& err) {
+            return make_unexpected(ErrorCode::SocketCreateFailed, err);
+        }
+        for (auto& socket : *group) {
+            sockets.push_back(std::move(socket));
+        }
+        return sockets;
+    }
+
+    std::expected<std::unique_ptr<ISocket>, Error> SocketXdp::Dial(const Addr& remote_addr, const SocketOptions& options, const XdpOptions& xdp_options) {
+        if (auto checked = check_xdp_options(remote_addr, options, xdp_options, kFrameSize); !checked) {
+            return std::unexpected(checked.error());
+        }
+
+        // The kernel picks the source address and port for us, and keeps them ours.
+        auto reservation = SocketUnix::OpenConnected(remote_addr, options);
+        if (!reservation) {
+            return std::unexpected(reservation.error());
+        }
+        auto group = OpenGroup(*reservation, 1, options, xdp_options, &remote_addr);
+        if (!group) {
+            return std::unexpected(group.error());
+        }
+        return std::unique_ptr<ISocket>(std::move(group->front()));
+    }
+
+    void SocketXdp::recycleFrame(uint64_t frame) {
+        // Frames never outnumber the fill ring's slots, so there is always room.
+        fill_.entries[fill_.cached++ & fill_.mask] = frame;
+        store_release(fill_.producer, fill_.cached);
+    }
+
+    void SocketXdp::recycleHeldFrame() {
+        if (held_frame_ >= 0) {
+            recycleFrame(static_cast<uint64_t>(held_frame_));
+            held_frame_ = -1;
+        }
+    }
+
+    SocketXdp::Neighbour& SocketXdp::neighbourSlot(uint32_t ip) noexcept {
+        return neighbours_[(ip ^ (ip >> 8) ^ (ip >> 16) ^ (ip >> 24)) & (kNeighbourSlots - 1)];
+    }
+
+    void SocketXdp::learnNeighbour(uint32_t ip, const uint8_t* mac) noexcept {
+        Neighbour& slot = neighbourSlot(ip);
+        slot.ip = ip;
+        std::memcpy(slot.mac.data(), mac, slot.mac.size());
+        slot.resolved = true;
+    }
+
+    bool SocketXdp::resolveNextHop(uint32_t ip, std::array<uint8_t, 6>& mac) {
+        if (interface_->loopback) {
+            mac = {}; // Loopback frames carry all-zero addresses
+            return true;
+        }
+        const uint32_t subnet_broadcast = (interface_->ip & interface_->netmask) | ~interface_->netmask;
+        if (ip == INADDR_BROADCAST || ip == subnet_broadcast) {
+            mac.fill(0xff);
+            return true;
+        }
+
+        Neighbour& slot = neighbourSlot(ip);
+        const auto now = std::chrono::steady_clock::now();
+        if (slot.ip == ip && ip != 0) {
+            if (slot.resolved) {
+                mac = slot.mac;
+                return true;
+            }
+            if (now < slot.retry_at) {
+                return false;
+            }
+        } else {
+            slot = Neighbour{};
+            slot.ip = ip;
+            slot.next_hop = (ip & interface_->netmask) == (interface_->ip & interface_->netmask)
+                ? ip : route_next_hop(interface_->name, ip);
+        }
+
+        if (!read_arp_entry(interface_->name, slot.next_hop, mac)) {
+            slot.retry_at = now + kNeighbourRetry;
+            return false;
+        }
+        slot.mac = mac;
+        slot.resolved = true;
+        return true;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketXdp::nextRecv(uint64_t& frame) {
+        bool woken = false;
+        while (true) {
+            if (load_acquire(rx_.producer) == rx_.cached) {
+                // Zero-copy drivers stop filling until we say there are frames to fill.
+                if (!woken && (load_acquire(fill_.flags) & XDP_RING_NEED_WAKEUP)) {
+                    woken = true;
+                    (void)::recvfrom(xsk_fd_, nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+                    continue;
+                }
+                return make_unexpected(ErrorCode::WouldBlock);
+            }
+
+            const xdp_desc desc = rx_.entries[rx_.cached++ & rx_.mask];
+            store_release(rx_.consumer, rx_.cached);
+            const uint64_t base = desc.addr & ~static_cast<uint64_t>(kFrameSize - 1);
+            const uint8_t* data = umem_ + desc.addr;
+
+            // The program only passes untagged, option-less IPv4/UDP for our port, but the frame came
+            // off the wire, so check everything we rely on.
+            if (desc.len < kHeadersSize || get16(data + 12) != 0x0800 || data[14] != 0x45 || data[23] != IPPROTO_UDP) {
+                recycleFrame(base);
+                continue;
+            }
+            const uint8_t* ip = data + kEthernetHeaderSize;
+            const uint8_t* udp = ip + kIpv4HeaderSize;
+            const size_t ip_length = get16(ip + 2);
+            const size_t udp_length = get16(udp + 4);
+            if (ip_length > desc.len - kEthernetHeaderSize || udp_length < kUdpHeaderSize || udp_length > ip_length - kIpv4HeaderSize) {
+                recycleFrame(base);
+                continue;
+            }
+
+            uint32_t source_ip, destination_ip;
+            uint16_t source_port, destination_port;
+            std::memcpy(&source_ip, ip + 12, sizeof(source_ip));
+            std::memcpy(&destination_ip, ip + 16, sizeof(destination_ip));
+            std::memcpy(&source_port, udp, sizeof(source_port));
+            std::memcpy(&destination_port, udp + 2, sizeof(destination_port));
+            if (destination_port != interface_->port || destination_ip != interface_->ip
+                || (connected_ && (source_ip != remote_ip_ || source_port != remote_port_)) || source_port == 0) {
+                recycleFrame(base);
+                continue;
+            }
+
+            learnNeighbour(source_ip, data + 6);
+
+            const size_t size = udp_length - kUdpHeaderSize;
+            if (size > max_datagram_size_) {
+                recycleFrame(base);
+                return make_unexpected(ErrorCode::Truncated);
+            }
+
+            sockaddr_in source{};
+            source.sin_family = AF_INET;
+            source.sin_addr.s_addr = source_ip;
+            source.sin_port = source_port;
+            auto addr = Addr::FromSockaddr(&source, sizeof(source));
+            if (!addr) {
+                recycleFrame(base);
+                continue;
+            }
+
+            frame = base;
+            return ReceivedPacket{
+                .data = umem_ + desc.addr + kHeadersSize,
+                .size = size,
+                .capacity = max_datagram_size_,
+                .addr = std::move(*addr),
+            };
+        }
+    }
+
+    std::expected<ReceivedPacket, Error> SocketXdp::recvFrom() {
+        auto result = receiveView();
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketXdp::recvFrom(ReceivedPacket&& packet) {
+        auto result = receiveInto(std::move(packet));
+        if (counters_) {
+            counters_->recordRecv(result);
+        }
+        if (tap_) {
+            tap_->recordRecv(result);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketXdp::recvBatch(std::span<ReceivedPacket> packets) {
+        auto result = receiveBatch(packets);
+        if (counters_) {
+            counters_->recordRecvBatch(result, packets);
+        }
+        if (tap_) {
+            tap_->recordRecvBatch(result, packets);
+        }
+        return result;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketXdp::receiveView() {
+        if (xsk_fd_ < 0) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        recycleHeldFrame();
+        if (std::exchange(truncation_pending_, false)) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+
+        uint64_t frame = 0;
+        auto packet = nextRecv(frame);
+        if (!packet) {
+            return packet;
+        }
+        // Zero-copy: the view points into the UMEM frame, which we keep until the next receive.
+        held_frame_ = static_cast<int64_t>(frame);
+        if (packet->size == 0) {
+            return make_unexpected(ErrorCode::Closed);
+        }
+        return packet;
+    }
+
+    std::expected<ReceivedPacket, Error> SocketXdp::receiveInto(ReceivedPacket&& packet) {
+        if (packet.data == nullptr || packet.capacity < max_datagram_size_) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+        if (xsk_fd_ < 0) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        recycleHeldFrame();
+        if (std::exchange(truncation_pending_, false)) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+
+        uint64_t frame = 0;
+        auto received = nextRecv(frame);
+        if (!received) {
+            return std::unexpected(received.error());
+        }
+        packet.size = received->size;
+        std::memcpy(packet.data, received->data, packet.size);
+        packet.addr = std::move(received->addr);
+        recycleFrame(frame);
+
+        if (packet.size == 0) {
+            return make_unexpected(ErrorCode::Closed); // rare, but possible
+        }
+        return std::move(packet);
+    }
+
+    std::expected<size_t, Error> SocketXdp::receiveBatch(std::span<ReceivedPacket> packets) {
+        for (const auto& packet : packets) {
+            if (packet.data == nullptr || packet.capacity < max_datagram_size_) {
+                return make_unexpected(ErrorCode::InvalidArgument);
+            }
+        }
+        if (xsk_fd_ < 0) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        recycleHeldFrame();
+        if (std::exchange(truncation_pending_, false)) {
+            return make_unexpected(ErrorCode::Truncated);
+        }
+
+        size_t received = 0;
+        while (received < packets.size()) {
+            uint64_t frame = 0;
+            auto next = nextRecv(frame);
+            if (!next) {
+                if (received > 0) {
+                    truncation_pending_ = next.error() == ErrorCode::Truncated;
+                    break;
+                }
+                return std::unexpected(next.error());
+            }
+
+            // Zero-length datagrams are dropped, as in SocketUnix::recvBatch.
+            auto& packet = packets[received];
+            if (next->size > 0) {
+                packet.size = next->size;
+                std::memcpy(packet.data, next->data, packet.size);
+                packet.addr = std::move(next->addr);
+                packet.timestampNs = 0;
+                ++received;
+            }
+            recycleFrame(frame);
+        }
+        return received;
+    }
+
+    void SocketXdp::reclaimTxFrames() {
+        const uint32_t available = load_acquire(completion_.producer) - completion_.cached;
+        for (uint32_t i = 0; i < available; ++i) {
+            free_tx_frames_.push_back(completion_.entries[completion_.cached++ & completion_.mask]);
+        }
+        if (available > 0) {
+            store_release(completion_.consumer, completion_.cached);
+        }
+    }
+
+    std::expected<void, Error> SocketXdp::queueFrame(const Addr& addr, const uint8_t* data, size_t length) {
+        if (addr.isIPv6()) {
+            return make_unexpected(ErrorCode::UnsupportedAddressFamily);
+        }
+        if (length + kIpv4HeaderSize + kUdpHeaderSize > interface_->mtu || length + kHeadersSize > kFrameSize) {
+            return make_unexpected(ErrorCode::SendFailed, EMSGSIZE);
+        }
+
+        const sockaddr_in destination = ipv4_of(addr);
+        std::array<uint8_t, 6> next_hop;
+        if (!resolveNextHop(destination.sin_addr.s_addr, next_hop)) {
+            return make_unexpected(ErrorCode::SendFailed, EHOSTUNREACH, "Next hop not in the neighbour table yet");
+        }
+
+        if (free_tx_frames_.empty()) {
+            reclaimTxFrames();
+            if (free_tx_frames_.empty()) {
+                return make_unexpected(ErrorCode::WouldBlock);
+            }
+        }
+        const uint64_t frame = free_tx_frames_.back();
+        free_tx_frames_.pop_back();
+
+        uint8_t* ethernet = umem_ + frame;
+        std::memcpy(ethernet, next_hop.data(), 6);
+        std::memcpy(ethernet + 6, interface_->mac.data(), 6);
+        put16(ethernet + 12, 0x0800);
+
+        uint8_t* ip = ethernet + kEthernetHeaderSize;
+        ip[0] = 0x45;
+        ip[1] = tos_;
+        put16(ip + 2, static_cast<uint16_t>(kIpv4HeaderSize + kUdpHeaderSize + length));
+        put16(ip + 4, ip_id_++);
+        put16(ip + 6, 0x4000); // Don't fragment
+        ip[8] = 64;
+        ip[9] = IPPROTO_UDP;
+        put16(ip + 10, 0);
+        std::memcpy(ip + 12, &interface_->ip, 4);
+        std::memcpy(ip + 16, &destination.sin_addr.s_addr, 4);
+        put16(ip + 10, finish_checksum(add_checksum(0, ip, kIpv4HeaderSize)));
+
+        uint8_t* udp = ip + kIpv4HeaderSize;
+        const uint16_t udp_length = static_cast<uint16_t>(kUdpHeaderSize + length);
+        std::memcpy(udp, &interface_->port, 2);
+        std::memcpy(udp + 2, &destination.sin_port, 2);
+        put16(udp + 4, udp_length);
+        put16(udp + 6, 0);
+        std::memcpy(udp + kUdpHeaderSize, data, length);
+
+        // Nothing offloads it here, so the checksum is ours: pseudo-header, then header and payload.
+        uint32_t sum = add_checksum(0, ip + 12, 8);
+        sum += IPPROTO_UDP + udp_length;
+        uint16_t checksum = finish_checksum(add_checksum(sum, udp, udp_length));
+        put16(udp + 6, checksum == 0 ? 0xffff : checksum);
+
+        tx_.entries[tx_.cached++ & tx_.mask] = xdp_desc{ .addr = frame, .len = static_cast<uint32_t>(kHeadersSize + length), .options = 0 };
+        return {};
+    }
+
+    void SocketXdp::flushTx() {
+        store_release(tx_.producer, tx_.cached);
+        // Copy mode transmits inside sendto(); zero-copy drivers only need it when they've gone idle.
+        if (copy_mode_ || (load_acquire(tx_.flags) & XDP_RING_NEED_WAKEUP)) {
+            (void)::sendto(xsk_fd_, nullptr, 0, MSG_DONTWAIT, nullptr, 0); // EAGAIN/EBUSY: retried by the next kick
+        }
+        reclaimTxFrames();
+    }
+
+    std::expected<void, Error> SocketXdp::sendTo(const Addr& addr, const uint8_t* data, size_t length) {
+        OutgoingPacket packet{ .data = data, .size = length, .addr = addr, .result = {} };
+        auto sent = transmitBatch(std::span<OutgoingPacket>(&packet, 1));
+        auto result = sent ? packet.result : std::expected<void, Error>(std::unexpected(sent.error()));
+        if (counters_) {
+            counters_->recordSend(result, length);
+        }
+        if (tap_) {
+            tap_->recordSend(result, addr, data, length);
+        }
+        return result;
+    }
+
+    std::expected<void, Error> SocketXdp::send(const uint8_t* data, size_t length) {
+        if (!connected_) {
+            auto result = std::expected<void, Error>(make_unexpected(ErrorCode::SendFailed, EDESTADDRREQ));
+            if (counters_) {
+                counters_->recordSend(result, length);
+            }
+            return result;
+        }
+        return sendTo(remote_, data, length);
+    }
+
+    std::expected<size_t, Error> SocketXdp::sendBatch(std::span<OutgoingPacket> packets) {
+        auto result = transmitBatch(packets);
+        if (counters_) {
+            counters_->recordSendBatch(packets);
+        }
+        if (tap_) {
+            tap_->recordSendBatch(packets);
+        }
+        return result;
+    }
+
+    std::expected<size_t, Error> SocketXdp::transmitBatch(std::span<OutgoingPacket> packets) {
+        if (xsk_fd_ < 0) {
+            for (auto& packet : packets) {
+                packet.result = make_unexpected(ErrorCode::InvalidSocket);
+            }
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+
+        // Every frame goes on the TX ring first and the kernel hears about them once.
+        size_t sent = 0;
+        size_t next = 0;
+        for (; next < packets.size(); ++next) {
+            auto& packet = packets[next];
+            packet.result = queueFrame(packet.addr, packet.data, packet.size);
+            if (packet.result) {
+                ++sent;
+            } else if (packet.result.error() == ErrorCode::WouldBlock) {
+                for (; next < packets.size(); ++next) {
+                    packets[next].result = make_unexpected(ErrorCode::WouldBlock);
+                }
+                break;
+            }
+        }
+        if (sent > 0) {
+            flushTx();
+        }
+        return sent;
+    }
+
+    std::expected<size_t, Error> SocketXdp::sendSegmented(const Addr& addr, const uint8_t* data, size_t length, size_t segment_size) {
+        if (data == nullptr || segment_size == 0) {
+            return make_unexpected(ErrorCode::InvalidArgument);
+        }
+
+        // No segmentation offload on this path; every segment is its own frame.
+        size_t sent = 0;
+        size_t offset = 0;
+        std::array<OutgoingPacket, kMaxBatchSize> packets{};
+        std::expected<size_t, Error> result = 0;
+
+        while (offset < length) {
+            size_t count = 0;
+            for (size_t chunk_offset = offset; chunk_offset < length && count < kMaxBatchSize; chunk_offset += segment_size) {
+                auto& packet = packets[count++];
+                packet.data = data + chunk_offset;
+                packet.size = std::min(segment_size, length - chunk_offset);
+                packet.addr = addr;
+            }
+
+            auto batch = std::span<OutgoingPacket>(packets.data(), count);
+            if (auto queued = transmitBatch(batch); !queued) {
+                result = queued;
+                break;
+            }
+
+            bool stopped = false;
+            for (const auto& packet : batch) {
+                if (!packet.result) {
+                    if (sent == 0 || packet.result.error() != ErrorCode::WouldBlock) {
+                        result = std::unexpected(packet.result.error());
+                    }
+                    stopped = true;
+                    break;
+                }
+                ++sent;
+                offset += packet.size;
+            }
+            if (stopped) {
+                break;
+            }
+        }
+
+        if (result && *result == 0) {
+            result = sent;
+        }
+        if (counters_) {
+            counters_->recordSendSegmented(result, length, segment_size);
+        }
+        if (tap_) {
+            tap_->recordSendSegmented(result, addr, data, length, segment_size);
+        }
+        return result;
+    }
+
+    std::expected<SocketMetrics, Error> SocketXdp::metrics() const {
+        if (!counters_) {
+            return make_unexpected(ErrorCode::InvalidArgument, "metrics not enabled in SocketOptions");
+        }
+        SocketMetrics metrics = counters_->snapshot();
+        xdp_statistics statistics{};
+        socklen_t size = sizeof(statistics);
+        if (xsk_fd_ >= 0 && ::getsockopt(xsk_fd_, SOL_XDP, XDP_STATISTICS, &statistics, &size) == 0) {
+            metrics.kernelDrops = statistics.rx_dropped + statistics.rx_ring_full;
+        }
+        return metrics;
+    }
+
+    std::expected<int, Error> SocketXdp::getHandle() const {
+        if (xsk_fd_ < 0) {
+            return make_unexpected(ErrorCode::InvalidSocket);
+        }
+        return xsk_fd_;
+    }
+
+    void SocketXdp::close() {
+        held_frame_ = -1;
+        // Closing the socket first takes it out of the XSKMAP, so the kernel is done with the rings.
+        if (xsk_fd_ >= 0) {
+            ::close(xsk_fd_);
+            xsk_fd_ = -1;
+        }
+        unmap_ring(fill_);
+        unmap_ring(completion_);
+        unmap_ring(rx_);
+        unmap_ring(tx_);
+        if (umem_) {
+            ::munmap(umem_, umem_size_);
+            umem_ = nullptr;
+        }
+        interface_.reset();
+    }
+
+} // namespace pulse::net::udp
@@ -1,6 +1,7 @@
 #include <pulse/net/udp/udp.h>
+#include <pulse/net/udp/reactor.h>
+#include <pulse/net/udp/peer_table.h>
 #include <iostream>
-#include <unordered_map>
 #include <chrono>
 #include <thread>
 #include <atomic>
@@ -26,28 +27,36 @@ int handleServer() {
 
     auto& server = *sockResult;
 
-    std::unordered_map<std::string, int> clientDatagramCount;
+    auto reactorResult = create_reactor();
+    if (!reactorResult) {
+        std::cerr << "Failed to create reactor: " << to_string(reactorResult) << std::endl;
+        return 1;
+    }
+    auto& reactor = *reactorResult;
 
-    while (true) {
-        auto packet = server->recvFrom();
-        if (!packet.has_value()) {
-            if (packet.error() == ErrorCode::WouldBlock) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
-                continue;
-            }
-            std::cerr << "recvFrom failed: " << to_string(packet) << std::endl;
-            continue;
-        }
+    PeerTable<int> clientDatagramCount;
 
-        const auto& [data, length, unused, addr] = *packet;
-        (void)unused; // Unused variable, but we need to keep it for the tuple unpacking
-        std::string clientKey = addr.ip + ":" + std::to_string(addr.port);
-        clientDatagramCount[clientKey]++;
+    auto addResult = reactor->add(*server, [&](ISocket& socket, const ReceivedPacket& packet) {
+        const auto& [data, length, unused, addr, timestamp] = packet;
+        (void)unused; // Unused variables, but we need to keep them for the tuple unpacking
+        (void)timestamp;
+        ++clientDatagramCount.findOrEmplace(addr, 0);
 
-        auto result = server->sendTo(addr, data, length);
+        auto result = socket.sendTo(addr, data, length);
         if (!result) {
             std::cerr << "sendTo failed: " << to_string(result) << std::endl;
         }
+    });
+    if (!addResult) {
+        std::cerr << "Failed to register server: " << to_string(addResult) << std::endl;
+        return 1;
+    }
+
+    while (true) {
+        auto polled = reactor->poll(-1);
+        if (!polled) {
+            std::cerr << "poll failed: " << to_string(polled) << std::endl;
+        }
     }
 
     return 0;
@@ -82,18 +91,15 @@ void sendDatagrams(const std::string& serverIp, uint16_t serverPort,
     std::vector<uint8_t> message = {'h', 'e', 'l', 'l', 'o'};
 
     while (!stopFlag->load()) {
-        if (waitingForResponse &&
-            std::chrono::steady_clock::now() < timeSinceLastSend + maxWaitTime) {
-            auto maybe = client->recvFrom();
+        if (waitingForResponse) {
+            auto maybe = client->recvFromUntil(timeSinceLastSend + maxWaitTime);
             if (maybe.has_value()) {
-                waitingForResponse = false;
                 datagramCount->fetch_add(1);
-            } else if (maybe.error() != ErrorCode::WouldBlock) {
+            } else if (maybe.error() == ErrorCode::Timeout) {
+                datagramTimeoutCount->fetch_add(1);
+            } else {
                 std::cerr << "recvFrom failed: " << to_string(maybe) << std::endl;
-                waitingForResponse = false;
             }
-        } else if (waitingForResponse) {
-            datagramTimeoutCount->fetch_add(1);
             waitingForResponse = false;
         } else {
             std::this_thread::sleep_for(maxWaitTime - (std::chrono::steady_clock::now() - timeSinceLastSend));
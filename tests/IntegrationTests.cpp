@@ -1,14 +1,71 @@
 #include <iostream>
 #include <tuple>
 #include <pulse/net/udp/udp.h>
+#include <pulse/net/udp/reactor.h>
+#include <pulse/net/udp/async.h>
+#include <pulse/net/udp/socket.h>
+#include <string_view>
+#include <chrono>
+#include <thread>
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#endif
 
-int main () {
-    using namespace pulse::net::udp;
+using namespace pulse::net::udp;
 
-    // We're an integration test so we'll use the get_socket_factory() to get the socket factory
-    // and create a socket. This is the same as the client code.
-    auto factory = get_socket_factory();
+// Echoes `count` datagrams back to whoever sent them.
+Task echoTask(AsyncSocket& socket, size_t count, size_t& echoed) {
+    for (size_t i = 0; i < count; ++i) {
+        auto packet = co_await socket.recv();
+        if (!packet) {
+            co_return;
+        }
+        auto sent = co_await socket.sendTo(packet->addr, packet->data, packet->size);
+        if (sent) {
+            ++echoed;
+        }
+    }
+    (void)socket.socket().flushPaced(); // No receive follows the last echo to submit it
+}
+
+// Sends `count` pings one after another, waiting for each echo before the next.
+Task pingTask(AsyncSocket& socket, size_t count, size_t& answered) {
+    uint8_t reply[2048];
+    for (size_t i = 0; i < count; ++i) {
+        const uint8_t ping[] = {'p', static_cast<uint8_t>('0' + i)};
+        if (auto sent = co_await socket.send(ping, sizeof(ping)); !sent) {
+            co_return;
+        }
+        auto echo = co_await socket.recv(ReceivedPacket{ .data = reply, .size = 0, .capacity = sizeof(reply), .addr = {} });
+        if (echo && echo->size == sizeof(ping) && echo->data[1] == ping[1]) {
+            ++answered;
+        }
+    }
+}
+
+Task waitForeverTask(AsyncSocket& socket, std::expected<ReceivedPacket, Error>& outcome) {
+    outcome = co_await socket.recv();
+}
 
+// The io_uring backend holds sends until the socket's next receive; when it's the peer that waits for
+// them, push them out first.
+bool flushSends(ISocket& socket) {
+    auto flushed = socket.flushPaced();
+    if (!flushed) {
+        std::cerr << "A queued send failed: " << to_string(flushed) << std::endl;
+    }
+    return flushed.has_value();
+}
+
+int runIntegration(ISocketFactory* factory) {
     std::cout << "Creating a server to receive packets..." << std::endl;
     auto serverAddrResult = Addr::Create("127.0.0.1", 12345);
     if (!serverAddrResult) {
@@ -16,7 +73,8 @@ int main () {
         return 1;
     }
     auto& serverAddr = *serverAddrResult;
-    auto serverSocketResult = factory->listen(serverAddr);
+    // Coalescing on, so the segmented upload below can arrive as one GRO read.
+    auto serverSocketResult = factory->listen(serverAddr, { .receiveCoalescing = true });
     if (!serverSocketResult) {
         std::cerr << "Failed to create server socket: " << to_string(serverSocketResult) << std::endl;
         return 1;
@@ -24,6 +82,14 @@ int main () {
     auto& serverSocket = *serverSocketResult;
     std::cout << "Server socket created successfully." << std::endl;
 
+    // The port is taken now, so a second bind must fail and say why.
+    auto duplicateResult = factory->listen(serverAddr);
+    if (duplicateResult || duplicateResult.error() != ErrorCode::BindFailed || duplicateResult.error().native_value() == 0) {
+        std::cerr << "Binding a taken port should fail with BindFailed and an OS error code." << std::endl;
+        return 1;
+    }
+    std::cout << "Duplicate bind rejected: " << to_string(duplicateResult) << std::endl;
+
     std::cout << "Creating a client to send packets..." << std::endl;
     auto clientSocketResult = factory->dial(serverAddr);
     if (!clientSocketResult) {
@@ -41,6 +107,9 @@ int main () {
         std::cerr << "Failed to send data: " << to_string(sendResult) << std::endl;
         return 1;
     }
+    if (!flushSends(*clientSocket)) {
+        return 1;
+    }
     std::cout << "Data sent successfully." << std::endl;
 
     auto recvResult = serverSocket->recvFrom();
@@ -49,10 +118,10 @@ int main () {
         return 1;
     }
 
-    const auto& [recvData, length, unused, addr] = *recvResult;
+    const auto& [recvData, length, unused, addr, recvTimestamp] = *recvResult;
     (void)unused; // Unused variable, but we need to keep it for the tuple unpacking
     std::string receivedMessage(reinterpret_cast<const char*>(recvData), length);
-    std::cout << "Received a " << length << " byte message: " << receivedMessage << " from " << addr.ip << ":" << addr.port << std::endl;
+    std::cout << "Received a " << length << " byte message: " << receivedMessage << " from " << addr.ip() << ":" << addr.port() << std::endl;
 
     if (receivedMessage != message) {
         std::cerr << "Received message does not match sent message." << std::endl;
@@ -60,6 +129,1044 @@ int main () {
     }
 
     std::cout << "Received message matches sent message." << std::endl;
+
+    // A datagram the OS refuses fails the send, or the next flushPaced() where sends are queued.
+    auto broadcastAddr = Addr::Create("255.255.255.255", 9);
+    if (!broadcastAddr) {
+        std::cerr << "Failed to create broadcast address: " << to_string(broadcastAddr) << std::endl;
+        return 1;
+    }
+    auto refusedSend = serverSocket->sendTo(*broadcastAddr, data.data(), data.size());
+    auto refusedFlush = serverSocket->flushPaced();
+    if (refusedSend.has_value() == refusedFlush.has_value()) {
+        std::cerr << "A broadcast without SO_BROADCAST should be refused exactly once." << std::endl;
+        return 1;
+    }
+    std::cout << "Refused broadcast reported: " << (refusedSend ? to_string(refusedFlush) : to_string(refusedSend)) << std::endl;
+
+    std::cout << "Sending a burst to receive as a batch..." << std::endl;
+    constexpr size_t kBurstSize = 3;
+    for (size_t i = 0; i < kBurstSize; ++i) {
+        std::vector<uint8_t> burst = {'b', static_cast<uint8_t>('0' + i)};
+        if (auto res = clientSocket->send(burst.data(), burst.size()); !res) {
+            std::cerr << "Failed to send burst datagram " << i << ": " << to_string(res) << std::endl;
+            return 1;
+        }
+    }
+    if (!flushSends(*clientSocket)) {
+        return 1;
+    }
+
+    std::vector<std::vector<uint8_t>> batchBuffers(8, std::vector<uint8_t>(2048));
+    std::vector<ReceivedPacket> batch;
+    for (auto& buffer : batchBuffers) {
+        batch.push_back(ReceivedPacket{ .data = buffer.data(), .size = 0, .capacity = buffer.size(), .addr = {} });
+    }
+
+    auto batchResult = serverSocket->recvBatch(batch);
+    if (!batchResult) {
+        std::cerr << "Failed to receive batch: " << to_string(batchResult) << std::endl;
+        return 1;
+    }
+    if (*batchResult != kBurstSize) {
+        std::cerr << "Expected " << kBurstSize << " datagrams in the batch, got " << *batchResult << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < kBurstSize; ++i) {
+        if (batch[i].size != 2 || batch[i].data[0] != 'b' || batch[i].data[1] != '0' + i) {
+            std::cerr << "Batch datagram " << i << " has unexpected contents." << std::endl;
+            return 1;
+        }
+    }
+
+    auto emptyBatch = serverSocket->recvBatch(batch);
+    if (emptyBatch || emptyBatch.error() != ErrorCode::WouldBlock) {
+        std::cerr << "Expected WouldBlock from an empty socket." << std::endl;
+        return 1;
+    }
+    auto noRoom = serverSocket->recvBatch(std::span<ReceivedPacket>());
+    if (!noRoom || *noRoom != 0) {
+        std::cerr << "Expected 0 from a batch with no room." << std::endl;
+        return 1;
+    }
+    std::cout << "Batch receive returned " << kBurstSize << " datagrams in order." << std::endl;
+
+    std::cout << "Replying to the client with a batched send..." << std::endl;
+    std::vector<uint8_t> replyA = {'r', 'a'};
+    std::vector<uint8_t> replyB = {'r', 'b'};
+    std::vector<OutgoingPacket> replies = {
+        OutgoingPacket{ .data = replyA.data(), .size = replyA.size(), .addr = addr, .result = {} },
+        OutgoingPacket{ .data = replyB.data(), .size = replyB.size(), .addr = addr, .result = {} },
+    };
+
+    auto sendBatchResult = serverSocket->sendBatch(replies);
+    if (!sendBatchResult || *sendBatchResult != replies.size()) {
+        std::cerr << "Batched send did not send every reply." << std::endl;
+        return 1;
+    }
+    for (const auto& reply : replies) {
+        if (!reply.result) {
+            std::cerr << "Batched reply failed: " << to_string(reply.result) << std::endl;
+            return 1;
+        }
+    }
+
+    for (const auto& expected : {replyA, replyB}) {
+        auto reply = clientSocket->recvFrom();
+        if (!reply) {
+            std::cerr << "Client failed to receive batched reply: " << to_string(reply) << std::endl;
+            return 1;
+        }
+        if (reply->size != expected.size() || reply->data[1] != expected[1]) {
+            std::cerr << "Client received an unexpected batched reply." << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Client received both batched replies." << std::endl;
+
+    std::cout << "Streaming a segmented burst to the client..." << std::endl;
+    constexpr size_t kSegmentSize = 100;
+    std::vector<uint8_t> snapshot(kSegmentSize * 4 + 30);
+    for (size_t i = 0; i < snapshot.size(); ++i) {
+        snapshot[i] = static_cast<uint8_t>(i / kSegmentSize);
+    }
+
+    auto segmentedResult = serverSocket->sendSegmented(addr, snapshot.data(), snapshot.size(), kSegmentSize);
+    if (!segmentedResult || *segmentedResult != 5) {
+        std::cerr << "Segmented send did not send 5 datagrams." << std::endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < 5; ++i) {
+        auto segment = clientSocket->recvFrom();
+        if (!segment) {
+            std::cerr << "Client failed to receive segment " << i << ": " << to_string(segment) << std::endl;
+            return 1;
+        }
+        size_t expectedSize = (i < 4) ? kSegmentSize : 30;
+        if (segment->size != expectedSize || segment->data[0] != i) {
+            std::cerr << "Segment " << i << " arrived with size " << segment->size << " and tag " << int(segment->data[0]) << std::endl;
+            return 1;
+        }
+    }
+    std::cout << "Client received all 5 segments." << std::endl;
+
+    if (auto oversized = serverSocket->sendSegmented(addr, snapshot.data(), snapshot.size(), 70000);
+        oversized || oversized.error() != ErrorCode::InvalidArgument) {
+        std::cerr << "Segments bigger than a datagram should be refused." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Uploading a segmented burst to the server..." << std::endl;
+    auto uploadResult = clientSocket->sendSegmented(serverAddr, snapshot.data(), snapshot.size(), kSegmentSize);
+    if (!uploadResult || *uploadResult != 5) {
+        std::cerr << "Segmented upload did not send 5 datagrams." << std::endl;
+        return 1;
+    }
+
+    // The server may receive the burst coalesced; it must still come out as 5 separate datagrams.
+    for (size_t i = 0; i < 5; ++i) {
+        auto segment = serverSocket->recvFrom();
+        if (!segment) {
+            std::cerr << "Server failed to receive segment " << i << ": " << to_string(segment) << std::endl;
+            return 1;
+        }
+        size_t expectedSize = (i < 4) ? kSegmentSize : 30;
+        if (segment->size != expectedSize || segment->data[0] != i) {
+            std::cerr << "Uploaded segment " << i << " arrived with size " << segment->size << " and tag " << int(segment->data[0]) << std::endl;
+            return 1;
+        }
+    }
+    if (auto extra = serverSocket->recvFrom(); extra || extra.error() != ErrorCode::WouldBlock) {
+        std::cerr << "Server received more datagrams than were sent." << std::endl;
+        return 1;
+    }
+    std::cout << "Server received all 5 segments." << std::endl;
+
+    std::cout << "Receiving into a packet pool..." << std::endl;
+    auto poolResult = PacketPool::Create({ .bufferSize = 2048, .bufferCount = 4, .hugePages = true });
+    if (!poolResult) {
+        std::cerr << "Failed to create packet pool: " << to_string(poolResult) << std::endl;
+        return 1;
+    }
+    auto& pool = **poolResult;
+    for (uint8_t tag = 0; tag < 4; ++tag) {
+        std::vector<uint8_t> pooled = {'p', tag};
+        if (auto res = clientSocket->send(pooled.data(), pooled.size()); !res) {
+            std::cerr << "Failed to send pooled datagram: " << to_string(res) << std::endl;
+            return 1;
+        }
+    }
+    if (!flushSends(*clientSocket)) {
+        return 1;
+    }
+    auto firstPooled = serverSocket->recvPooled(pool);
+    if (!firstPooled) {
+        std::cerr << "Failed to receive into the pool: " << to_string(firstPooled) << std::endl;
+        return 1;
+    }
+    PooledPacket pooledBatch[4];
+    auto pooledCount = serverSocket->recvBatchPooled(pool, pooledBatch);
+    if (!pooledCount || *pooledCount != 3) {
+        std::cerr << "Pooled batch received " << (pooledCount ? *pooledCount : 0) << " datagrams, expected 3." << std::endl;
+        return 1;
+    }
+    // Later receives must not have touched the first packet, and every buffer is now checked out.
+    if (firstPooled->size() != 2 || firstPooled->data()[1] != 0 || pool.available() != 0) {
+        std::cerr << "Pooled packet was overwritten or the pool miscounted its buffers." << std::endl;
+        return 1;
+    }
+    if (auto exhausted = pool.acquire(); exhausted || exhausted.error() != ErrorCode::PoolExhausted) {
+        std::cerr << "An empty pool should report PoolExhausted." << std::endl;
+        return 1;
+    }
+    PooledPacket shared = pooledBatch[0];
+    for (auto& packet : pooledBatch) {
+        packet.reset();
+    }
+    if (shared.useCount() != 1 || shared.size() != 2 || pool.available() != 2) {
+        std::cerr << "Released packets did not return to the pool." << std::endl;
+        return 1;
+    }
+    std::cout << "Pooled receives stayed valid and returned to the pool." << std::endl;
+
+    std::cout << "Capping the datagram size..." << std::endl;
+    auto cappedAddrResult = Addr::Create("127.0.0.1", 12347);
+    if (!cappedAddrResult) {
+        std::cerr << "Failed to create capped address: " << to_string(cappedAddrResult) << std::endl;
+        return 1;
+    }
+    if (auto invalid = factory->listen(*cappedAddrResult, { .maxDatagramSize = 0 }); invalid || invalid.error() != ErrorCode::InvalidArgument) {
+        std::cerr << "A zero maxDatagramSize should be rejected." << std::endl;
+        return 1;
+    }
+    auto cappedServer = factory->listen(*cappedAddrResult, { .maxDatagramSize = 512 });
+    auto cappedClient = factory->dial(*cappedAddrResult, { .maxDatagramSize = 9000 });
+    if (!cappedServer || !cappedClient) {
+        std::cerr << "Failed to open capped sockets." << std::endl;
+        return 1;
+    }
+    std::vector<uint8_t> small(100, 's');
+    std::vector<uint8_t> oversized(600, 'o');
+    for (const auto* payload : {&small, &oversized, &small}) {
+        if (auto res = (*cappedClient)->send(payload->data(), payload->size()); !res) {
+            std::cerr << "Failed to send to the capped server: " << to_string(res) << std::endl;
+            return 1;
+        }
+    }
+    if (!flushSends(**cappedClient)) {
+        return 1;
+    }
+    // 512-byte buffers are enough now; the oversized datagram must surface as Truncated, never as a cut packet.
+    std::vector<std::vector<uint8_t>> cappedBuffers(4, std::vector<uint8_t>(512));
+    size_t cappedReceived = 0;
+    size_t cappedTruncated = 0;
+    Addr cappedPeer;
+    while (true) {
+        std::vector<ReceivedPacket> cappedBatch;
+        for (auto& buffer : cappedBuffers) {
+            cappedBatch.push_back(ReceivedPacket{ .data = buffer.data(), .size = 0, .capacity = buffer.size(), .addr = {} });
+        }
+        auto result = (*cappedServer)->recvBatch(cappedBatch);
+        if (!result && result.error() == ErrorCode::WouldBlock) {
+            break;
+        }
+        if (!result && result.error() == ErrorCode::Truncated) {
+            ++cappedTruncated;
+            continue;
+        }
+        if (!result) {
+            std::cerr << "Capped receive failed: " << to_string(result) << std::endl;
+            return 1;
+        }
+        for (size_t i = 0; i < *result; ++i) {
+            if (cappedBatch[i].size != small.size()) {
+                std::cerr << "Capped server returned a " << cappedBatch[i].size << " byte datagram." << std::endl;
+                return 1;
+            }
+            cappedPeer = cappedBatch[i].addr;
+        }
+        cappedReceived += *result;
+    }
+    if (cappedReceived != 2 || cappedTruncated != 1) {
+        std::cerr << "Capped server received " << cappedReceived << " datagrams and " << cappedTruncated << " truncations." << std::endl;
+        return 1;
+    }
+
+    // The client side was opened for jumbo frames, so a 9000-byte reply must arrive whole.
+    std::vector<uint8_t> jumbo(9000, 'j');
+    if (auto res = (*cappedServer)->sendTo(cappedPeer, jumbo.data(), jumbo.size()); !res) {
+        std::cerr << "Failed to send a jumbo datagram: " << to_string(res) << std::endl;
+        return 1;
+    }
+    auto jumboResult = (*cappedClient)->recvFrom();
+    if (!jumboResult || jumboResult->size != jumbo.size()) {
+        std::cerr << "Jumbo datagram did not arrive whole: " << (jumboResult ? std::to_string(jumboResult->size) : to_string(jumboResult)) << std::endl;
+        return 1;
+    }
+    std::cout << "Oversized datagram reported as Truncated; jumbo datagram received whole." << std::endl;
+
+#if defined(__linux__)
+    std::cout << "Tuning socket options..." << std::endl;
+    auto tunedAddrResult = Addr::Create("127.0.0.1", 12348);
+    if (!tunedAddrResult) {
+        std::cerr << "Failed to create tuned address: " << to_string(tunedAddrResult) << std::endl;
+        return 1;
+    }
+    SocketOptions tuning{
+        .receiveBufferSize = 1 << 20,
+        .sendBufferSize = 1 << 20,
+        .priority = 3,
+        .tos = 46 << 2, // DSCP EF
+        .incomingCpu = 0,
+        .reuseAddress = true,
+        .reusePort = true,
+    };
+    auto tunedServer = factory->listen(*tunedAddrResult, tuning);
+    if (!tunedServer) {
+        std::cerr << "Failed to listen with tuning options: " << to_string(tunedServer) << std::endl;
+        return 1;
+    }
+    auto tunedHandle = (*tunedServer)->getHandle();
+    int tos = 0;
+    int priority = 0;
+    socklen_t optionLength = sizeof(int);
+    if (!tunedHandle
+        || getsockopt(*tunedHandle, IPPROTO_IP, IP_TOS, &tos, &optionLength) < 0 || tos != *tuning.tos
+        || getsockopt(*tunedHandle, SOL_SOCKET, SO_PRIORITY, &priority, &optionLength) < 0 || priority != *tuning.priority) {
+        std::cerr << "Tuning options were not applied (tos " << tos << ", priority " << priority << ")." << std::endl;
+        return 1;
+    }
+
+    // A refused option fails the call and names itself.
+    auto refused = factory->dial(*tunedAddrResult, { .busyPollMicros = -1 });
+    if (refused || refused.error() != ErrorCode::SocketConfigFailed || refused.error().detail == nullptr
+        || std::string_view(refused.error().detail) != "SO_BUSY_POLL" || refused.error().native_value() != EINVAL) {
+        std::cerr << "A refused option should fail with SocketConfigFailed naming SO_BUSY_POLL: " << to_string(refused) << std::endl;
+        return 1;
+    }
+    std::cout << "Options applied; refused option reported as: " << to_string(refused) << std::endl;
+
+    std::cout << "Timestamping sends and receives..." << std::endl;
+    auto stampedAddrResult = Addr::Create("127.0.0.1", 12349);
+    if (!stampedAddrResult) {
+        std::cerr << "Failed to create timestamping address: " << to_string(stampedAddrResult) << std::endl;
+        return 1;
+    }
+    auto stampedServer = factory->listen(*stampedAddrResult, { .rxTimestamps = true });
+    auto stampedClient = factory->dial(*stampedAddrResult, { .txTimestamps = true });
+    if (!stampedServer || !stampedClient) {
+        std::cerr << "Failed to create timestamping sockets: " << (!stampedServer ? to_string(stampedServer) : to_string(stampedClient)) << std::endl;
+        return 1;
+    }
+    const auto stampedSince = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    for (size_t i = 0; i < 3; ++i) {
+        if (auto sent = (*stampedClient)->send(data.data(), data.size()); !sent) {
+            std::cerr << "Failed to send timestamped datagram: " << to_string(sent) << std::endl;
+            return 1;
+        }
+    }
+    if (!flushSends(**stampedClient)) {
+        return 1;
+    }
+    const auto stampedUntil = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    auto stamped = (*stampedServer)->recvFrom();
+    std::vector<uint8_t> stampedStorage(2 * 2048);
+    ReceivedPacket stampedBatch[2] = {
+        { .data = stampedStorage.data(), .size = 0, .capacity = 2048, .addr = {} },
+        { .data = stampedStorage.data() + 2048, .size = 0, .capacity = 2048, .addr = {} },
+    };
+    auto stampedBatchResult = (*stampedServer)->recvBatch(stampedBatch);
+    if (!stamped || stamped->timestampNs < stampedSince || stamped->timestampNs > stampedUntil
+        || !stampedBatchResult || *stampedBatchResult != 2
+        || stampedBatch[0].timestampNs < stamped->timestampNs || stampedBatch[1].timestampNs < stamped->timestampNs) {
+        std::cerr << "Received datagrams should carry kernel timestamps taken while they were sent." << std::endl;
+        return 1;
+    }
+
+    TxTimestamp txStamps[4];
+    auto txCount = (*stampedClient)->readTxTimestamps(txStamps);
+    if (!txCount || *txCount != 3 || txStamps[0].id != 0 || txStamps[2].id != 2
+        || txStamps[0].timestampNs < stampedSince || txStamps[2].timestampNs > stampedUntil) {
+        std::cerr << "Expected a transmit timestamp for each send, got " << (txCount ? std::to_string(*txCount) : to_string(txCount)) << std::endl;
+        return 1;
+    }
+    if (auto drained = (*stampedClient)->readTxTimestamps(txStamps); drained || drained.error() != ErrorCode::WouldBlock) {
+        std::cerr << "A drained error queue should report WouldBlock." << std::endl;
+        return 1;
+    }
+    if (recvTimestamp != 0) {
+        std::cerr << "Sockets without rxTimestamps should leave timestampNs at 0." << std::endl;
+        return 1;
+    }
+    std::cout << "Datagram queued for " << (stamped->timestampNs - txStamps[0].timestampNs) << " ns between transmit and receive stamps." << std::endl;
+#endif
+
+    std::cout << "Counting traffic with socket metrics..." << std::endl;
+    auto meteredAddrResult = Addr::Create("127.0.0.1", 12350);
+    if (!meteredAddrResult) {
+        std::cerr << "Failed to create metrics address: " << to_string(meteredAddrResult) << std::endl;
+        return 1;
+    }
+    // A tiny receive buffer so a burst overflows it and the kernel has drops to report.
+    auto meteredServer = factory->listen(*meteredAddrResult, { .receiveBufferSize = 4096, .metrics = true });
+    auto meteredClient = factory->dial(*meteredAddrResult, { .metrics = true });
+    if (!meteredServer || !meteredClient) {
+        std::cerr << "Failed to create metered sockets: " << (!meteredServer ? to_string(meteredServer) : to_string(meteredClient)) << std::endl;
+        return 1;
+    }
+    if (auto unmetered = clientSocket->metrics(); unmetered || unmetered.error() != ErrorCode::InvalidArgument) {
+        std::cerr << "Sockets without metrics should refuse to report them." << std::endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < 3; ++i) {
+        if (auto sent = (*meteredClient)->send(data.data(), data.size()); !sent) {
+            std::cerr << "Failed to send metered datagram: " << to_string(sent) << std::endl;
+            return 1;
+        }
+    }
+    if (!flushSends(**meteredClient)) {
+        return 1;
+    }
+    size_t meteredReceived = 0;
+    while ((*meteredServer)->recvFrom()) {
+        ++meteredReceived;
+    }
+    std::vector<uint8_t> tooSmall(16);
+    (void)(*meteredServer)->recvFrom(ReceivedPacket{ .data = tooSmall.data(), .size = 0, .capacity = tooSmall.size(), .addr = {} });
+
+    auto serverMetrics = (*meteredServer)->metrics();
+    auto clientMetrics = (*meteredClient)->metrics();
+    if (!serverMetrics || !clientMetrics) {
+        std::cerr << "Failed to read metrics: " << (!serverMetrics ? to_string(serverMetrics) : to_string(clientMetrics)) << std::endl;
+        return 1;
+    }
+    if (meteredReceived != 3 || serverMetrics->packetsReceived != 3 || serverMetrics->bytesReceived != 3 * data.size()
+        || serverMetrics->recvWouldBlock != 1 || serverMetrics->errorCount(ErrorCode::InvalidArgument) != 1
+        || clientMetrics->packetsSent != 3 || clientMetrics->bytesSent != 3 * data.size() || clientMetrics->packetsReceived != 0) {
+        std::cerr << "Metrics don't match the traffic: received " << serverMetrics->packetsReceived << "/" << serverMetrics->bytesReceived
+                  << " B, sent " << clientMetrics->packetsSent << "/" << clientMetrics->bytesSent << " B." << std::endl;
+        return 1;
+    }
+
+#if defined(__linux__)
+    // Flood the small buffer without reading, drain it, then send one more: the kernel reports its drop
+    // total with the next datagram it delivers.
+    constexpr size_t kFlood = 1024;
+    std::vector<uint8_t> floodPayload(1024, 'f');
+    for (size_t i = 0; i < kFlood; ++i) {
+        if (auto sent = (*meteredClient)->send(floodPayload.data(), floodPayload.size()); !sent) {
+            std::cerr << "Failed to flood the metered socket: " << to_string(sent) << std::endl;
+            return 1;
+        }
+    }
+    if (!flushSends(**meteredClient)) {
+        return 1;
+    }
+    while ((*meteredServer)->recvFrom()) {
+    }
+    if (auto sent = (*meteredClient)->send(data.data(), data.size()); !sent) {
+        std::cerr << "Failed to send after the flood: " << to_string(sent) << std::endl;
+        return 1;
+    }
+    if (!flushSends(**meteredClient)) {
+        return 1;
+    }
+    while ((*meteredServer)->recvFrom()) {
+    }
+    serverMetrics = (*meteredServer)->metrics();
+    if (!serverMetrics || serverMetrics->kernelDrops == 0 || serverMetrics->packetsReceived + serverMetrics->kernelDrops != 3 + kFlood + 1) {
+        std::cerr << "Every flooded datagram should be either received or counted as a kernel drop." << std::endl;
+        return 1;
+    }
+    std::cout << "Kernel dropped " << serverMetrics->kernelDrops << " of " << kFlood << " flooded datagrams." << std::endl;
+#endif
+
+    std::cout << "Pacing sends..." << std::endl;
+    auto pacedAddrResult = Addr::Create("127.0.0.1", 12353);
+    if (!pacedAddrResult) {
+        std::cerr << "Failed to create pacing address: " << to_string(pacedAddrResult) << std::endl;
+        return 1;
+    }
+    auto pacedServer = factory->listen(*pacedAddrResult);
+    auto pacedClient = factory->dial(*pacedAddrResult, { .pacingRate = 100'000, .pacingMode = PacingMode::Userspace });
+    if (!pacedServer) {
+        std::cerr << "Failed to create the pacing server: " << to_string(pacedServer) << std::endl;
+        return 1;
+    }
+    auto drainPaced = [&]() {
+        size_t count = 0;
+        while ((*pacedServer)->recvFrom()) {
+            ++count;
+        }
+        return count;
+    };
+    if (!pacedClient && pacedClient.error() == ErrorCode::Unsupported) {
+        std::cout << "Skipping pacing: " << to_string(pacedClient) << std::endl;
+    } else if (!pacedClient) {
+        std::cerr << "Failed to create a paced socket: " << to_string(pacedClient) << std::endl;
+        return 1;
+    } else {
+        if (auto unpaced = clientSocket->setPacingRate(*pacedAddrResult, 1000); unpaced || unpaced.error() != ErrorCode::InvalidArgument) {
+            std::cerr << "Sockets without pacing should refuse a pacing rate." << std::endl;
+            return 1;
+        }
+
+        // 10 x 1000 bytes at 100 kB/s: the first leaves at once, the rest 10 ms apart.
+        constexpr size_t kPaced = 10;
+        const std::vector<uint8_t> payload(1000, 'p');
+        const auto pacingStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < kPaced; ++i) {
+            if (auto sent = (*pacedClient)->send(payload.data(), payload.size()); !sent) {
+                std::cerr << "Paced send failed: " << to_string(sent) << std::endl;
+                return 1;
+            }
+        }
+        size_t pacedReceived = drainPaced();
+        if (pacedReceived != 1) {
+            std::cerr << "Pacing let " << pacedReceived << " datagrams through at once." << std::endl;
+            return 1;
+        }
+        for (auto delay = (*pacedClient)->flushPaced(); delay && *delay >= 0; delay = (*pacedClient)->flushPaced()) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(*delay));
+        }
+        const auto pacedFor = std::chrono::steady_clock::now() - pacingStart;
+        pacedReceived += drainPaced();
+        if (pacedReceived != kPaced || pacedFor < std::chrono::milliseconds(85)) {
+            std::cerr << "Paced burst delivered " << pacedReceived << " datagrams in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(pacedFor).count() << " ms." << std::endl;
+            return 1;
+        }
+
+        // No socket-wide cap, just one destination held to 10 kB/s.
+        auto perDestination = factory->listen(*Addr::Create("127.0.0.1", 0), { .pacingRate = 0, .pacingMode = PacingMode::Userspace });
+        if (!perDestination || !(*perDestination)->setPacingRate(*pacedAddrResult, 10'000)) {
+            std::cerr << "Failed to set a per-destination pacing rate." << std::endl;
+            return 1;
+        }
+        (void)(*perDestination)->sendTo(*pacedAddrResult, payload.data(), payload.size());
+        (void)(*perDestination)->sendTo(*pacedAddrResult, payload.data(), payload.size());
+        auto nextDue = (*perDestination)->flushPaced();
+        if (drainPaced() != 1 || !nextDue || *nextDue < 50'000'000) {
+            std::cerr << "Per-destination pacing didn't hold back the second datagram." << std::endl;
+            return 1;
+        }
+        if (auto oversized = factory->dial(*pacedAddrResult, { .pacingRate = 100'000, .pacingQueueSize = size_t{ 1 } << 20 });
+            oversized || oversized.error() != ErrorCode::InvalidArgument) {
+            std::cerr << "A 2 GiB pacing queue should be refused." << std::endl;
+            return 1;
+        }
+
+#if defined(__linux__)
+        // Kernel pacing stamps departure times; loopback has no fq to honour them, but they must still arrive.
+        auto kernelPaced = factory->dial(*pacedAddrResult, { .pacingRate = 1'000'000, .pacingMode = PacingMode::Kernel });
+        if (kernelPaced) {
+            std::vector<OutgoingPacket> stamped;
+            for (size_t i = 0; i < 4; ++i) {
+                stamped.push_back(OutgoingPacket{ .data = payload.data(), .size = payload.size(), .addr = *pacedAddrResult, .result = {} });
+            }
+            auto sent = (*kernelPaced)->sendBatch(stamped);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            if (!sent || *sent != stamped.size() || drainPaced() != stamped.size()) {
+                std::cerr << "SO_TXTIME-stamped datagrams went missing." << std::endl;
+                return 1;
+            }
+        } else if (kernelPaced.error() != ErrorCode::Unsupported) {
+            std::cerr << "Kernel pacing failed: " << to_string(kernelPaced) << std::endl;
+            return 1;
+        }
+
+        // Loopback has no fq, so Auto must fall back to the userspace queue rather than unheeded stamps.
+        auto autoPaced = factory->dial(*pacedAddrResult, { .pacingRate = 10'000 });
+        if (!autoPaced) {
+            std::cerr << "Auto pacing failed: " << to_string(autoPaced) << std::endl;
+            return 1;
+        }
+        (void)(*autoPaced)->send(payload.data(), payload.size());
+        (void)(*autoPaced)->send(payload.data(), payload.size());
+        auto autoDue = (*autoPaced)->flushPaced();
+        if (drainPaced() != 1 || !autoDue || *autoDue <= 0) {
+            std::cerr << "Auto pacing didn't queue in userspace without fq." << std::endl;
+            return 1;
+        }
+#endif
+        std::cout << "Paced " << kPaced << " datagrams over "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(pacedFor).count() << " ms." << std::endl;
+    }
+
+    std::cout << "Listening on a sharded group..." << std::endl;
+    constexpr size_t kShards = 4;
+    constexpr size_t kShardClients = 16;
+    auto shardAddrResult = Addr::Create("127.0.0.1", 12346);
+    if (!shardAddrResult) {
+        std::cerr << "Failed to create shard address: " << to_string(shardAddrResult) << std::endl;
+        return 1;
+    }
+    auto shardsResult = factory->listenSharded(*shardAddrResult, kShards);
+    if (!shardsResult && shardsResult.error() == ErrorCode::Unsupported) {
+        std::cout << "Skipping sharded listen: " << to_string(shardsResult) << std::endl;
+    } else if (!shardsResult || shardsResult->size() != kShards) {
+        std::cerr << "Failed to listen on " << kShards << " shards: " << to_string(shardsResult) << std::endl;
+        return 1;
+    } else {
+        // Each client is its own flow, so the kernel spreads them over the group.
+        std::vector<std::unique_ptr<ISocket>> shardClients;
+        std::vector<uint8_t> hello = {'s'};
+        for (size_t i = 0; i < kShardClients; ++i) {
+            auto shardClient = factory->dial(*shardAddrResult);
+            if (!shardClient) {
+                std::cerr << "Failed to dial the sharded group: " << to_string(shardClient) << std::endl;
+                return 1;
+            }
+            if (auto res = (*shardClient)->send(hello.data(), hello.size()); !res) {
+                std::cerr << "Failed to send to the sharded group: " << to_string(res) << std::endl;
+                return 1;
+            }
+            if (!flushSends(**shardClient)) {
+                return 1;
+            }
+            shardClients.push_back(std::move(*shardClient));
+        }
+
+        size_t shardTotal = 0;
+        size_t shardsUsed = 0;
+        for (auto& shard : *shardsResult) {
+            size_t shardCount = 0;
+            while (shard->recvFrom()) {
+                ++shardCount;
+            }
+            shardTotal += shardCount;
+            shardsUsed += (shardCount > 0) ? 1 : 0;
+        }
+        if (shardTotal != kShardClients || shardsUsed < 2) {
+            std::cerr << "Sharded group received " << shardTotal << " datagrams on " << shardsUsed << " shards." << std::endl;
+            return 1;
+        }
+        std::cout << "Sharded group received " << shardTotal << " datagrams across " << shardsUsed << " shards." << std::endl;
+    }
+
+    std::cout << "Receiving with a deadline..." << std::endl;
+    const auto waitStart = std::chrono::steady_clock::now();
+    auto timedOut = serverSocket->recvFromUntil(waitStart + std::chrono::milliseconds(20));
+    if (timedOut || timedOut.error() != ErrorCode::Timeout || std::chrono::steady_clock::now() - waitStart < std::chrono::milliseconds(20)) {
+        std::cerr << "An empty socket should wait out the deadline and report Timeout." << std::endl;
+        return 1;
+    }
+    std::thread lateSender([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::vector<uint8_t> late = {'l'};
+        (void)clientSocket->send(late.data(), late.size());
+        (void)clientSocket->flushPaced();
+    });
+    auto parkedResult = serverSocket->recvBatchUntil(batch, std::chrono::steady_clock::now() + std::chrono::seconds(2));
+    lateSender.join();
+    if (!parkedResult || *parkedResult != 1 || batch[0].size != 1 || batch[0].data[0] != 'l') {
+        std::cerr << "A parked receive should wake for the datagram: " << to_string(parkedResult) << std::endl;
+        return 1;
+    }
+    std::cout << "Timed out on an empty socket, then woke for a late datagram." << std::endl;
+
+    auto reactorResult = create_reactor();
+    if (!reactorResult) {
+        std::cout << "Skipping the reactor: " << to_string(reactorResult) << std::endl;
+        return 0;
+    }
+    auto& reactor = *reactorResult;
+
+    std::cout << "Waiting for traffic through the reactor..." << std::endl;
+    size_t reactorPackets = 0;
+    auto addResult = reactor->add(*serverSocket, [&](ISocket&, const ReceivedPacket& packet) {
+        if (packet.size == 2 && packet.data[0] == 'e') {
+            ++reactorPackets;
+        }
+    });
+    if (!addResult) {
+        std::cerr << "Failed to register the server: " << to_string(addResult) << std::endl;
+        return 1;
+    }
+
+    for (uint8_t tag : {'0', '1'}) {
+        std::vector<uint8_t> event = {'e', tag};
+        if (auto res = clientSocket->send(event.data(), event.size()); !res) {
+            std::cerr << "Failed to send reactor datagram: " << to_string(res) << std::endl;
+            return 1;
+        }
+    }
+    if (!flushSends(*clientSocket)) {
+        return 1;
+    }
+
+    for (int attempt = 0; attempt < 10 && reactorPackets < 2; ++attempt) {
+        if (auto polled = reactor->poll(100); !polled) {
+            std::cerr << "Reactor poll failed: " << to_string(polled) << std::endl;
+            return 1;
+        }
+    }
+    if (reactorPackets != 2) {
+        std::cerr << "Reactor dispatched " << reactorPackets << " datagrams, expected 2." << std::endl;
+        return 1;
+    }
+
+    // With nothing queued, wake() is the only thing that can end an infinite wait.
+    reactor->wake();
+    auto woken = reactor->poll(-1);
+    if (!woken || *woken != 0) {
+        std::cerr << "Woken reactor poll did not return cleanly." << std::endl;
+        return 1;
+    }
+
+    if (auto removed = reactor->remove(*serverSocket); !removed) {
+        std::cerr << "Failed to unregister the server: " << to_string(removed) << std::endl;
+        return 1;
+    }
+    std::cout << "Reactor dispatched both datagrams." << std::endl;
+
+    auto loopResult = create_event_loop();
+    if (!loopResult) {
+        std::cerr << "Failed to create an event loop: " << to_string(loopResult) << std::endl;
+        return 1;
+    }
+    auto& loop = *loopResult;
+    auto asyncServer = AsyncSocket::Create(*loop, *serverSocket);
+    auto asyncClient = AsyncSocket::Create(*loop, *clientSocket);
+    if (!asyncServer || !asyncClient) {
+        std::cerr << "Failed to attach sockets to the event loop: " << (!asyncServer ? to_string(asyncServer) : to_string(asyncClient)) << std::endl;
+        return 1;
+    }
+
+    std::cout << "Ping-pong between coroutines..." << std::endl;
+    constexpr size_t kPings = 5;
+    size_t echoed = 0;
+    size_t answered = 0;
+    if (auto spawned = loop->spawn(echoTask(**asyncServer, kPings, echoed)); !spawned) {
+        std::cerr << "Failed to spawn the echo task: " << to_string(spawned) << std::endl;
+        return 1;
+    }
+    if (auto spawned = loop->spawn(pingTask(**asyncClient, kPings, answered)); !spawned) {
+        std::cerr << "Failed to spawn the ping task: " << to_string(spawned) << std::endl;
+        return 1;
+    }
+    for (int attempt = 0; attempt < 100 && answered < kPings; ++attempt) {
+        if (auto polled = loop->poll(100); !polled) {
+            std::cerr << "Event loop poll failed: " << to_string(polled) << std::endl;
+            return 1;
+        }
+    }
+    if (echoed != kPings || answered != kPings) {
+        std::cerr << "Coroutines echoed " << echoed << " and got back " << answered << " of " << kPings << " pings." << std::endl;
+        return 1;
+    }
+
+    // A task parked on a socket that goes away is resumed with an error rather than left hanging.
+    std::expected<ReceivedPacket, Error> orphaned = make_unexpected(ErrorCode::Unknown);
+    if (auto spawned = loop->spawn(waitForeverTask(**asyncServer, orphaned)); !spawned) {
+        std::cerr << "Failed to spawn the waiting task: " << to_string(spawned) << std::endl;
+        return 1;
+    }
+    (void)loop->poll(0);
+    asyncServer->reset();
+    if (orphaned || orphaned.error() != ErrorCode::Unknown) {
+        std::cerr << "The orphaned task ran inside ~AsyncSocket instead of on the loop." << std::endl;
+        return 1;
+    }
+    (void)loop->poll(0);
+    if (orphaned || orphaned.error() != ErrorCode::InvalidSocket) {
+        std::cerr << "Expected the orphaned task to see InvalidSocket." << std::endl;
+        return 1;
+    }
+    std::cout << "Coroutines exchanged " << kPings << " pings." << std::endl;
+
+    return 0;
+}
+
+#if defined(__linux__)
+// Deadline for receives that should succeed; anything crossing the veth pair turns up well within it.
+std::chrono::steady_clock::time_point inOneSecond() {
+    return std::chrono::steady_clock::now() + std::chrono::seconds(1);
+}
+
+// Runs AF_XDP sockets against a kernel socket across a veth pair, the far end in its own network
+// namespace so the traffic really crosses the link. Needs root; skipped when anything is missing.
+int runXdp(XdpMode mode) {
+    const auto teardown = [] { (void)std::system("ip link del pnx0 >/dev/null 2>&1; ip netns del pulsenet_xdp >/dev/null 2>&1"); };
+    teardown();
+    if (std::system("ip netns add pulsenet_xdp >/dev/null 2>&1"
+                    " && ip link add pnx0 type veth peer name pnx1 >/dev/null 2>&1"
+                    " && ip link set pnx1 netns pulsenet_xdp"
+                    " && ip addr add 10.177.0.1/24 dev pnx0 && ip link set pnx0 up"
+                    " && ip -n pulsenet_xdp addr add 10.177.0.2/24 dev pnx1"
+                    " && ip -n pulsenet_xdp link set pnx1 up") != 0) {
+        teardown();
+        std::cout << "Skipping AF_XDP: can't create the veth pair." << std::endl;
+        return 0;
+    }
+
+    auto factory = create_xdp_socket_factory(XdpOptions{ .mode = mode, .ringSize = 256 });
+    if (!factory) {
+        teardown();
+        std::cout << "Skipping AF_XDP: " << to_string(factory) << std::endl;
+        return 0;
+    }
+
+    auto localAddr = Addr::Create("10.177.0.1", 12351);
+    auto peerAddr = Addr::Create("10.177.0.2", 12351);
+    if (!localAddr || !peerAddr) {
+        teardown();
+        std::cerr << "Failed to create the veth addresses." << std::endl;
+        return 1;
+    }
+
+    // The peer is an ordinary kernel socket, created inside the namespace and usable from out here.
+    const int home = ::open("/proc/self/ns/net", O_RDONLY | O_CLOEXEC);
+    const int away = ::open("/var/run/netns/pulsenet_xdp", O_RDONLY | O_CLOEXEC);
+    std::expected<std::unique_ptr<ISocket>, Error> peerResult = std::unexpected(Error(ErrorCode::Unsupported));
+    if (home >= 0 && away >= 0 && ::setns(away, CLONE_NEWNET) == 0) {
+        peerResult = get_socket_factory()->listen(*peerAddr);
+        (void)::setns(home, CLONE_NEWNET);
+    }
+    if (home >= 0) ::close(home);
+    if (away >= 0) ::close(away);
+    if (!peerResult) {
+        teardown();
+        std::cout << "Skipping AF_XDP: can't open the peer socket." << std::endl;
+        return 0;
+    }
+    auto& peer = *peerResult;
+
+    auto serverResult = (*factory)->listen(*localAddr, SocketOptions{ .metrics = true });
+    if (!serverResult) {
+        teardown();
+        if (serverResult.error() == ErrorCode::Unsupported) {
+            std::cout << "Skipping AF_XDP: " << to_string(serverResult) << std::endl;
+            return 0;
+        }
+        std::cerr << "Failed to listen on AF_XDP: " << to_string(serverResult) << std::endl;
+        return 1;
+    }
+    auto& server = *serverResult;
+
+    const uint8_t hello[] = "hello over xdp";
+    if (auto sent = peer->sendTo(*localAddr, hello, sizeof(hello)); !sent) {
+        teardown();
+        std::cerr << "Peer failed to send: " << to_string(sent) << std::endl;
+        return 1;
+    }
+    auto received = server->recvFromUntil(inOneSecond());
+    if (!received || received->size != sizeof(hello) || std::memcmp(received->data, hello, sizeof(hello)) != 0
+        || received->addr.ip() != "10.177.0.2" || received->addr.port() != 12351) {
+        teardown();
+        std::cerr << "AF_XDP socket didn't receive the peer's datagram." << std::endl;
+        return 1;
+    }
+
+    // The reply's next hop was learned from the datagram it answers.
+    const Addr replyTo = received->addr;
+    if (auto sent = server->sendTo(replyTo, hello, sizeof(hello)); !sent) {
+        teardown();
+        std::cerr << "AF_XDP reply failed: " << to_string(sent) << std::endl;
+        return 1;
+    }
+    uint8_t buffer[2048];
+    auto reply = peer->recvFromUntil(ReceivedPacket{ .data = buffer, .size = 0, .capacity = sizeof(buffer), .addr = {} }, inOneSecond());
+    if (!reply || reply->size != sizeof(hello) || std::memcmp(reply->data, hello, sizeof(hello)) != 0 || reply->addr.port() != 12351) {
+        teardown();
+        std::cerr << "Peer didn't receive the AF_XDP reply (checksums or headers wrong?)." << std::endl;
+        return 1;
+    }
+
+    constexpr size_t kXdpBurst = 4;
+    std::vector<OutgoingPacket> burst;
+    for (size_t i = 0; i < kXdpBurst; ++i) {
+        burst.push_back(OutgoingPacket{ .data = hello, .size = i + 1, .addr = replyTo, .result = {} });
+    }
+    auto batchSent = server->sendBatch(burst);
+    if (!batchSent || *batchSent != kXdpBurst) {
+        teardown();
+        std::cerr << "AF_XDP batched send failed." << std::endl;
+        return 1;
+    }
+    for (size_t i = 0; i < kXdpBurst; ++i) {
+        auto echo = peer->recvFromUntil(ReceivedPacket{ .data = buffer, .size = 0, .capacity = sizeof(buffer), .addr = {} }, inOneSecond());
+        if (!echo || echo->size != i + 1) {
+            teardown();
+            std::cerr << "Peer missed AF_XDP batched datagram " << i << "." << std::endl;
+            return 1;
+        }
+        (void)peer->sendTo(*localAddr, buffer, echo->size);
+    }
+
+    std::vector<uint8_t> storage(kXdpBurst * 2048);
+    std::vector<ReceivedPacket> packets;
+    for (size_t i = 0; i < kXdpBurst; ++i) {
+        packets.push_back(ReceivedPacket{ .data = storage.data() + i * 2048, .size = 0, .capacity = 2048, .addr = {} });
+    }
+    size_t batched = 0;
+    const auto batchDeadline = inOneSecond();
+    while (batched < kXdpBurst) {
+        auto count = server->recvBatchUntil(std::span<ReceivedPacket>(packets).subspan(batched), batchDeadline);
+        if (!count) {
+            break;
+        }
+        batched += *count;
+    }
+    auto metrics = server->metrics();
+    if (batched != kXdpBurst || !metrics || metrics->packetsReceived != 1 + kXdpBurst || metrics->packetsSent != 1 + kXdpBurst) {
+        teardown();
+        std::cerr << "AF_XDP batched receive or its metrics came up short." << std::endl;
+        return 1;
+    }
+    server->close();
+
+    // Only one group per interface at a time, so dial once the listener is gone. The kernel lets go
+    // of the queue a moment after close(), so give it that moment.
+    auto dialedResult = (*factory)->dial(*peerAddr);
+    for (int i = 0; i < 100 && !dialedResult && dialedResult.error() == ErrorCode::BindFailed; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        dialedResult = (*factory)->dial(*peerAddr);
+    }
+    if (!dialedResult) {
+        teardown();
+        std::cerr << "Failed to dial over AF_XDP: " << to_string(dialedResult) << std::endl;
+        return 1;
+    }
+    auto& dialed = *dialedResult;
+    if (auto sent = dialed->send(hello, sizeof(hello)); !sent) {
+        teardown();
+        std::cerr << "Dialed AF_XDP send failed: " << to_string(sent) << std::endl;
+        return 1;
+    }
+    auto dialedHello = peer->recvFromUntil(ReceivedPacket{ .data = buffer, .size = 0, .capacity = sizeof(buffer), .addr = {} }, inOneSecond());
+    if (!dialedHello || dialedHello->addr.ip() != "10.177.0.1") {
+        teardown();
+        std::cerr << "Peer didn't receive from the dialed AF_XDP socket." << std::endl;
+        return 1;
+    }
+    (void)peer->sendTo(dialedHello->addr, hello, sizeof(hello));
+    auto dialedReply = dialed->recvFromUntil(inOneSecond());
+    if (!dialedReply || dialedReply->size != sizeof(hello)) {
+        teardown();
+        std::cerr << "Dialed AF_XDP socket didn't receive the reply." << std::endl;
+        return 1;
+    }
+
+    dialed->close();
+    peer->close();
+    teardown();
+    return 0;
+}
+#endif
+
+// The compile-time Socket<Backend> must behave like the ISocket it wraps.
+template <class Backend>
+int runStaticSocket(const char* name) {
+    auto serverAddr = Addr::Create("127.0.0.1", 12354);
+    if (!serverAddr) {
+        std::cerr << "Failed to create static socket address: " << to_string(serverAddr) << std::endl;
+        return 1;
+    }
+    auto server = Socket<Backend>::Listen(*serverAddr);
+    if (!server && server.error() == ErrorCode::Unsupported) {
+        std::cout << "Skipping the static " << name << " socket: " << to_string(server) << std::endl;
+        return 0;
+    }
+    auto client = Socket<Backend>::Dial(*serverAddr);
+    if (!server || !client) {
+        std::cerr << "Failed to create static " << name << " sockets." << std::endl;
+        return 1;
+    }
+
+    constexpr uint8_t kDatagrams = 8;
+    for (uint8_t i = 0; i < kDatagrams; ++i) {
+        if (auto sent = client->send(&i, 1); !sent) {
+            std::cerr << "Static send failed: " << to_string(sent) << std::endl;
+            return 1;
+        }
+    }
+    if (auto flushed = client->flushPaced(); !flushed) {
+        std::cerr << "Static flush failed: " << to_string(flushed) << std::endl;
+        return 1;
+    }
+    auto pool = PacketPool::Create(PacketPoolOptions{ .bufferSize = 2048, .bufferCount = 16 });
+    if (!pool) {
+        std::cerr << "Failed to create a packet pool: " << to_string(pool) << std::endl;
+        return 1;
+    }
+    PooledPacket packets[kDatagrams];
+    size_t received = 0;
+    for (int attempt = 0; attempt < 100 && received < kDatagrams; ++attempt) {
+        auto batch = server->recvBatchPooled(**pool, std::span<PooledPacket>(packets + received, kDatagrams - received));
+        if (batch) {
+            received += *batch;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    if (received != kDatagrams) {
+        std::cerr << "Static " << name << " socket received " << received << " of " << int(kDatagrams) << " datagrams." << std::endl;
+        return 1;
+    }
+
+    // The type-erased view is the same socket.
+    ISocket& erased = server->erased();
+    auto erasedHandle = erased.getHandle();
+    auto staticHandle = server->getHandle();
+    if (!erasedHandle || !staticHandle || *erasedHandle != *staticHandle) {
+        std::cerr << "erased() doesn't refer to the same socket." << std::endl;
+        return 1;
+    }
+    std::unique_ptr<ISocket> released = std::move(*client).release();
+    if (auto sent = released->send(packets[0].data(), 1); !sent) {
+        std::cerr << "Released socket can't send: " << to_string(sent) << std::endl;
+        return 1;
+    }
+    if (!flushSends(*released)) {
+        return 1;
+    }
+    if (server->recvFromUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(100))) {
+        return 0;
+    }
+    std::cerr << "Nothing arrived from the released socket." << std::endl;
+    return 1;
+}
+
+int main () {
+    // We're an integration test so we'll use the get_socket_factory() to get the socket factory
+    // and create a socket. This is the same as the client code.
+    if (runIntegration(get_socket_factory()) != 0) {
+        return 1;
+    }
+
+    // Every backend must behave identically, so run the same checks through io_uring where we have it.
+    auto ioUringFactory = get_io_uring_socket_factory();
+    if (ioUringFactory) {
+        std::cout << "Repeating with the io_uring backend..." << std::endl;
+        set_socket_factory(*ioUringFactory);
+        int result = runIntegration(get_socket_factory());
+        reset_socket_factory();
+        if (result != 0) {
+            return 1;
+        }
+    } else {
+        std::cout << "Skipping the io_uring backend: " << to_string(ioUringFactory) << std::endl;
+    }
+
+    std::cout << "Using compile-time backends..." << std::endl;
+    if (runStaticSocket<NativeBackend>("native") != 0 || runStaticSocket<IoUringBackend>("io_uring") != 0) {
+        return 1;
+    }
+
+#if defined(__linux__)
+    // Generic mode works on any interface; Auto tries the veth driver's native hook first.
+    for (XdpMode mode : { XdpMode::Generic, XdpMode::Auto }) {
+        std::cout << "Exchanging datagrams over AF_XDP (" << (mode == XdpMode::Generic ? "generic" : "auto") << " mode)..." << std::endl;
+        if (runXdp(mode) != 0) {
+            return 1;
+        }
+    }
+#endif
+
     std::cout << "Test completed successfully." << std::endl;
     return 0;
 }
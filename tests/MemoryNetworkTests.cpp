@@ -0,0 +1,372 @@
+#include <pulse/net/udp/memory_network.h>
+#include <pulse/net/udp/udp.h>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace pulse::net::udp;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            std::cerr << "Check failed at line " << __LINE__ << ": " #cond << std::endl; \
+            return 1;                                                               \
+        }                                                                           \
+    } while (0)
+
+constexpr int64_t kMillisecond = 1'000'000;
+
+Addr addr(const char* ip, uint16_t port) {
+    return *Addr::Create(ip, port);
+}
+
+// Sequence numbers of everything `socket` can receive right now.
+std::vector<uint32_t> drain(ISocket& socket) {
+    std::vector<uint32_t> received;
+    while (auto packet = socket.recvFrom()) {
+        uint32_t seq = 0;
+        std::memcpy(&seq, packet->data, sizeof(seq));
+        received.push_back(seq);
+    }
+    return received;
+}
+
+void sendSequence(ISocket& socket, uint32_t count) {
+    for (uint32_t seq = 0; seq < count; ++seq) {
+        (void)socket.send(reinterpret_cast<const uint8_t*>(&seq), sizeof(seq));
+    }
+}
+
+int runExchange() {
+    auto network = MemoryNetwork::Create();
+    CHECK(network);
+    auto server = (*network)->listen(addr(Addr::kAnyIPv4, 7000));
+    CHECK(server);
+    auto client = (*network)->dial(addr("127.0.0.1", 7000));
+    CHECK(client);
+    CHECK(!(*network)->listen(addr(Addr::kAnyIPv4, 7000)));
+
+    const uint8_t hello[] = "hello";
+    CHECK((*client)->send(hello, sizeof(hello)));
+    auto request = (*server)->recvFrom();
+    CHECK(request);
+    CHECK(request->size == sizeof(hello) && std::memcmp(request->data, hello, sizeof(hello)) == 0);
+    CHECK(!(*server)->recvFrom() && (*server)->recvFrom().error() == ErrorCode::WouldBlock);
+
+    // The wildcard listener answers as loopback, so the connected client accepts the reply.
+    const uint8_t world[] = "world";
+    CHECK((*server)->sendTo(request->addr, world, sizeof(world)));
+    uint8_t buffer[2048];
+    auto reply = (*client)->recvFrom(ReceivedPacket{ .data = buffer, .size = 0, .capacity = sizeof(buffer), .addr = {} });
+    CHECK(reply);
+    CHECK(reply->addr == addr("127.0.0.1", 7000) && std::memcmp(buffer, world, sizeof(world)) == 0);
+
+    // Buffers smaller than maxDatagramSize are refused before anything is dequeued.
+    CHECK((*server)->sendTo(request->addr, world, sizeof(world)));
+    uint8_t tiny[16];
+    auto refused = (*client)->recvFrom(ReceivedPacket{ .data = tiny, .size = 0, .capacity = sizeof(tiny), .addr = {} });
+    CHECK(!refused && refused.error() == ErrorCode::InvalidArgument);
+    ReceivedPacket tinyBatch[1] = { ReceivedPacket{ .data = tiny, .size = 0, .capacity = sizeof(tiny), .addr = {} } };
+    auto refusedBatch = (*client)->recvBatch(tinyBatch);
+    CHECK(!refusedBatch && refusedBatch.error() == ErrorCode::InvalidArgument);
+    CHECK((*client)->recvFrom());
+
+    // A connected socket ignores everyone but its peer.
+    auto stranger = (*network)->listen(addr("127.0.0.1", 7001));
+    CHECK(stranger);
+    CHECK((*stranger)->sendTo(request->addr, hello, sizeof(hello)));
+    CHECK(!(*client)->recvFrom());
+
+    // Nothing to poll here, so a deadline receive backs off in sleeps and still gives up on time.
+    auto idle = (*client)->recvFromUntil(std::chrono::steady_clock::now() + std::chrono::milliseconds(5));
+    CHECK(!idle && idle.error() == ErrorCode::Timeout);
+    std::thread replier([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        (void)(*server)->sendTo(request->addr, world, sizeof(world));
+    });
+    auto late = (*client)->recvFromUntil(std::chrono::steady_clock::now() + std::chrono::seconds(2));
+    replier.join();
+    CHECK(late && late->size == sizeof(world));
+
+    sendSequence(**client, 10);
+    auto pool = PacketPool::Create(PacketPoolOptions{ .bufferSize = 2048, .bufferCount = 16 });
+    CHECK(pool);
+    PooledPacket packets[16];
+    auto batch = (*server)->recvBatchPooled(**pool, packets);
+    CHECK(batch && *batch == 10);
+    for (uint32_t i = 0; i < 10; ++i) {
+        CHECK(std::memcmp(packets[i].data(), &i, sizeof(i)) == 0);
+    }
+
+    CHECK((*stranger)->sendTo(addr("127.0.0.1", 7999), hello, sizeof(hello)));
+    auto stats = (*network)->stats();
+    CHECK(stats.sent == 16);
+    CHECK(stats.delivered == 14);
+    CHECK(stats.unreachable == 1);
+
+    CHECK(!(*server)->getHandle());
+    CHECK(!(*network)->listen(addr("127.0.0.1", 0), { .pacingRate = 1000 }));
+    (*server)->close();
+    CHECK(!(*server)->recvFrom() && (*server)->recvFrom().error() == ErrorCode::InvalidSocket);
+    CHECK((*client)->send(hello, sizeof(hello)));
+    CHECK((*network)->stats().unreachable == 2);
+    return 0;
+}
+
+int runLatencyAndBandwidth() {
+    auto network = MemoryNetwork::Create({ .latencyNs = 10 * kMillisecond, .bandwidth = 40'000, .manualClock = true });
+    CHECK(network);
+    auto server = (*network)->listen(addr("127.0.0.1", 7000));
+    auto client = (*network)->dial(addr("127.0.0.1", 7000));
+    CHECK(server && client);
+
+    // 4-byte datagrams at 40 kB/s leave 100 us apart, then travel 10 ms.
+    sendSequence(**client, 5);
+    CHECK(drain(**server).empty());
+    (*network)->advance(10 * kMillisecond - 1);
+    CHECK(drain(**server).empty());
+    (*network)->advance(1);
+    CHECK(drain(**server).size() == 1);
+    (*network)->advance(300'000);
+    CHECK(drain(**server).size() == 3);
+    (*network)->advance(100'000);
+    CHECK(drain(**server) == std::vector<uint32_t>{ 4 });
+    return 0;
+}
+
+// Sequence numbers the server sees when the client sends `count` datagrams through `options`.
+std::vector<uint32_t> impaired(const MemoryNetworkOptions& options, uint32_t count) {
+    auto network = MemoryNetwork::Create(options);
+    auto server = (*network)->listen(addr("127.0.0.1", 7000));
+    auto client = (*network)->dial(addr("127.0.0.1", 7000));
+    if (!server || !client) {
+        return {};
+    }
+    std::vector<uint32_t> received;
+    for (uint32_t seq = 0; seq < count; ++seq) {
+        (void)(*client)->send(reinterpret_cast<const uint8_t*>(&seq), sizeof(seq));
+        (*network)->advance(kMillisecond);
+        for (uint32_t value : drain(**server)) {
+            received.push_back(value);
+        }
+    }
+    (*network)->advance(1000 * kMillisecond);
+    for (uint32_t value : drain(**server)) {
+        received.push_back(value);
+    }
+    return received;
+}
+
+int runImpairments() {
+    constexpr uint32_t kCount = 10'000;
+
+    const MemoryNetworkOptions lossy{ .lossRate = 0.3, .seed = 42, .manualClock = true };
+    auto first = impaired(lossy, kCount);
+    CHECK(first.size() > kCount * 65 / 100 && first.size() < kCount * 75 / 100);
+    CHECK(impaired(lossy, kCount) == first);
+    CHECK(impaired({ .lossRate = 0.3, .seed = 43, .manualClock = true }, kCount) != first);
+
+    auto duplicated = impaired({ .duplicateRate = 1.0, .manualClock = true }, 100);
+    CHECK(duplicated.size() == 200);
+    CHECK(duplicated[0] == 0 && duplicated[1] == 0 && duplicated[199] == 99);
+
+    // Half skip the 10 ms latency and overtake up to ten datagrams still in flight.
+    auto reordered = impaired({ .latencyNs = 10 * kMillisecond, .reorderRate = 0.5, .seed = 7, .manualClock = true }, 1000);
+    CHECK(reordered.size() == 1000);
+    size_t inversions = 0;
+    for (size_t i = 1; i < reordered.size(); ++i) {
+        inversions += reordered[i] < reordered[i - 1];
+    }
+    CHECK(inversions > 100);
+
+    auto jittered = impaired({ .latencyNs = 5 * kMillisecond, .jitterNs = 5 * kMillisecond, .seed = 7, .manualClock = true }, 1000);
+    CHECK(jittered.size() == 1000);
+    return 0;
+}
+
+int runLimits() {
+    auto network = MemoryNetwork::Create({ .queueCapacity = 8 });
+    CHECK(network);
+    auto server = (*network)->listen(addr("127.0.0.1", 7000), { .maxDatagramSize = 100, .metrics = true });
+    auto client = (*network)->dial(addr("127.0.0.1", 7000));
+    CHECK(server && client);
+
+    sendSequence(**client, 20);
+    CHECK(drain(**server).size() == 8);
+    CHECK((*network)->stats().overflowed == 12);
+    auto metrics = (*server)->metrics();
+    CHECK(metrics && metrics->kernelDrops == 12 && metrics->packetsReceived == 8);
+
+    std::vector<uint8_t> large(200, 'x');
+    CHECK((*client)->send(large.data(), large.size()));
+    auto truncated = (*server)->recvFrom();
+    CHECK(!truncated && truncated.error() == ErrorCode::Truncated);
+
+    CHECK(!MemoryNetwork::Create({ .lossRate = 1.5 }));
+    CHECK(!MemoryNetwork::Create({ .queueCapacity = 0 }));
+    return 0;
+}
+
+int runSharded() {
+    auto network = MemoryNetwork::Create();
+    CHECK(network);
+    auto shards = (*network)->listenSharded(addr("127.0.0.1", 7000), 4);
+    CHECK(shards && shards->size() == 4);
+
+    std::vector<std::unique_ptr<ISocket>> clients;
+    for (size_t i = 0; i < 16; ++i) {
+        auto client = (*network)->dial(addr("127.0.0.1", 7000));
+        CHECK(client);
+        sendSequence(**client, 3);
+        clients.push_back(std::move(*client));
+    }
+    size_t total = 0;
+    for (auto& shard : *shards) {
+        size_t received = drain(*shard).size();
+        CHECK(received % 3 == 0); // Each client sticks to one shard
+        total += received;
+    }
+    CHECK(total == 48);
+    return 0;
+}
+
+int runThreads() {
+    auto network = MemoryNetwork::Create({ .queueCapacity = 1024 });
+    CHECK(network);
+    auto server = (*network)->listen(addr("127.0.0.1", 7000));
+    auto client = (*network)->dial(addr("127.0.0.1", 7000));
+    CHECK(server && client);
+
+    constexpr uint32_t kCount = 200'000;
+    std::thread sender([&] { sendSequence(**client, kCount); });
+    uint8_t storage[32][2048];
+    ReceivedPacket packets[32];
+    size_t received = 0;
+    uint32_t last = 0;
+    bool ordered = true;
+    while (received + (*network)->stats().overflowed < kCount) {
+        for (size_t i = 0; i < 32; ++i) {
+            packets[i] = ReceivedPacket{ .data = storage[i], .size = 0, .capacity = sizeof(storage[i]), .addr = {} };
+        }
+        auto count = (*server)->recvBatch(packets);
+        for (size_t i = 0; count && i < *count; ++i) {
+            uint32_t seq = 0;
+            std::memcpy(&seq, packets[i].data, sizeof(seq));
+            ordered &= received == 0 || seq > last;
+            last = seq;
+            ++received;
+        }
+    }
+    sender.join();
+    CHECK(ordered);
+    CHECK((*network)->stats().delivered == received);
+    return 0;
+}
+
+// An ISocket written against the original interface, overriding only what was pure virtual then; the
+// batch operations added since must work through their defaults.
+class MinimalSocket final : public ISocket {
+public:
+    explicit MinimalSocket(std::unique_ptr<ISocket> inner) : inner_(std::move(inner)) {}
+
+    std::expected<void, Error> sendTo(const Addr& addr, const uint8_t* data, size_t length) override {
+        return inner_->sendTo(addr, data, length);
+    }
+    std::expected<void, Error> send(const uint8_t* data, size_t length) override {
+        return inner_->send(data, length);
+    }
+    std::expected<ReceivedPacket, Error> recvFrom() override {
+        return inner_->recvFrom();
+    }
+    std::expected<ReceivedPacket, Error> recvFrom(ReceivedPacket&& packet) override {
+        return inner_->recvFrom(std::move(packet));
+    }
+    std::expected<int, Error> getHandle() const override {
+        return inner_->getHandle();
+    }
+    void close() override {
+        inner_->close();
+    }
+
+private:
+    std::unique_ptr<ISocket> inner_;
+};
+
+// A factory written before SocketOptions: it overrides only the option-less listen() and dial().
+class MinimalFactory final : public ISocketFactory {
+public:
+    explicit MinimalFactory(MemoryNetwork& network) : network_(network) {}
+
+    std::expected<std::unique_ptr<ISocket>, Error> listen(const Addr& bindAddr) override {
+        return network_.listen(bindAddr);
+    }
+    std::expected<std::unique_ptr<ISocket>, Error> dial(const Addr& remoteAddr) override {
+        return network_.dial(remoteAddr);
+    }
+
+private:
+    MemoryNetwork& network_;
+};
+
+int runMinimalSocket() {
+    auto network = MemoryNetwork::Create();
+    CHECK(network);
+
+    MinimalFactory minimal(**network);
+    ISocketFactory& factory = minimal;
+    CHECK(factory.listen(addr("127.0.0.1", 7100)));
+    auto withOptions = factory.dial(addr("127.0.0.1", 7100), { .metrics = true });
+    CHECK(!withOptions && withOptions.error() == ErrorCode::Unsupported);
+    auto listened = (*network)->listen(addr("127.0.0.1", 7000));
+    auto dialed = (*network)->dial(addr("127.0.0.1", 7000));
+    CHECK(listened && dialed);
+    MinimalSocket server(std::move(*listened));
+    MinimalSocket client(std::move(*dialed));
+
+    uint8_t storage[4][2048];
+    ReceivedPacket packets[4];
+    for (size_t i = 0; i < 4; ++i) {
+        packets[i] = ReceivedPacket{ .data = storage[i], .size = 0, .capacity = sizeof(storage[i]), .addr = {} };
+    }
+    CHECK(!server.recvBatch(packets) && server.recvBatch(packets).error() == ErrorCode::WouldBlock);
+    sendSequence(client, 3);
+    auto received = server.recvBatch(packets);
+    CHECK(received && *received == 3);
+    for (uint32_t i = 0; i < 3; ++i) {
+        CHECK(packets[i].size == sizeof(i) && std::memcmp(packets[i].data, &i, sizeof(i)) == 0);
+    }
+
+    const uint8_t payload[] = "abcdefghij";
+    OutgoingPacket outgoing[2] = {
+        OutgoingPacket{ .data = payload, .size = 4, .addr = packets[0].addr, .result = {} },
+        OutgoingPacket{ .data = payload + 4, .size = 4, .addr = packets[0].addr, .result = {} },
+    };
+    auto sent = server.sendBatch(outgoing);
+    CHECK(sent && *sent == 2 && outgoing[0].result && outgoing[1].result);
+    auto segmented = client.sendSegmented(addr("127.0.0.1", 7000), payload, 10, 4);
+    CHECK(segmented && *segmented == 3);
+    CHECK(!client.sendSegmented(addr("127.0.0.1", 7000), payload, 10, 0));
+
+    auto echoed = client.recvBatch(packets);
+    CHECK(echoed && *echoed == 2 && std::memcmp(packets[1].data, "efgh", 4) == 0);
+    auto segments = server.recvBatch(packets);
+    CHECK(segments && *segments == 3 && packets[2].size == 2 && std::memcmp(packets[2].data, "ij", 2) == 0);
+
+    // Past the first failure nothing more is attempted, and the failure is on every packet left.
+    server.close();
+    auto closed = server.sendBatch(outgoing);
+    CHECK(!closed && closed.error() == ErrorCode::InvalidSocket && !outgoing[1].result);
+    return 0;
+}
+
+int main() {
+    if (runExchange() != 0 || runLatencyAndBandwidth() != 0 || runImpairments() != 0 || runLimits() != 0 || runSharded() != 0 || runThreads() != 0
+        || runMinimalSocket() != 0) {
+        return 1;
+    }
+    std::cout << "MemoryNetwork checks passed." << std::endl;
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include <pulse/net/udp/memory_network.h>
+#include <pulse/net/udp/packet_capture.h>
+#include <pulse/net/udp/udp.h>
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace pulse::net::udp;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            std::cerr << "Check failed at line " << __LINE__ << ": " #cond << std::endl; \
+            return 1;                                                               \
+        }                                                                           \
+    } while (0)
+
+Addr addr(const char* ip, uint16_t port) {
+    return *Addr::Create(ip, port);
+}
+
+std::string tempPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+std::vector<uint8_t> readFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+uint32_t u32(const std::vector<uint8_t>& bytes, size_t offset) {
+    uint32_t value = 0;
+    std::memcpy(&value, bytes.data() + offset, sizeof(value));
+    return value;
+}
+
+uint16_t be16(const std::vector<uint8_t>& bytes, size_t offset) {
+    return static_cast<uint16_t>(bytes[offset] << 8 | bytes[offset + 1]);
+}
+
+// One packet out of a capture file: the raw IP packet and the block's direction flags (pcapng only).
+struct CapturedPacket {
+    std::vector<uint8_t> data;
+    uint32_t original = 0;
+    uint32_t flags = 0;
+};
+
+// Walks a pcapng file's Enhanced Packet Blocks, or a pcap file's records.
+std::vector<CapturedPacket> parse(const std::vector<uint8_t>& file) {
+    std::vector<CapturedPacket> packets;
+    if (file.size() >= 24 && u32(file, 0) == 0xA1B23C4D) {
+        for (size_t offset = 24; offset + 16 <= file.size();) {
+            const uint32_t captured = u32(file, offset + 8);
+            packets.push_back({ { file.begin() + offset + 16, file.begin() + offset + 16 + captured }, u32(file, offset + 12), 0 });
+            offset += 16 + captured;
+        }
+        return packets;
+    }
+    for (size_t offset = 0; offset + 12 <= file.size();) {
+        const uint32_t type = u32(file, offset);
+        const uint32_t length = u32(file, offset + 4);
+        if (length < 12 || offset + length > file.size()) {
+            break;
+        }
+        if (type == 6) {
+            const uint32_t captured = u32(file, offset + 20);
+            const size_t options = offset + 28 + ((captured + 3) & ~3u);
+            const uint32_t flags = u32(file, options) == 0x00040002 ? u32(file, options + 4) : 0;
+            packets.push_back({ { file.begin() + offset + 28, file.begin() + offset + 28 + captured }, u32(file, offset + 24), flags });
+        }
+        offset += length;
+    }
+    return packets;
+}
+
+int runPcapNg() {
+    const std::string path = tempPath("pulsenet_capture_test.pcapng");
+    auto capture = PacketCapture::Create({ .path = path });
+    CHECK(capture);
+
+    auto network = MemoryNetwork::Create();
+    CHECK(network);
+    auto server = (*network)->listen(addr("127.0.0.1", 7000), { .capture = *capture });
+    auto client = (*network)->dial(addr("127.0.0.1", 7000));
+    CHECK(server && client);
+
+    const uint8_t hello[] = "hello";
+    CHECK((*client)->send(hello, sizeof(hello)));
+    auto request = (*server)->recvFrom();
+    CHECK(request);
+    const uint8_t world[] = "world!";
+    CHECK((*server)->sendTo(request->addr, world, sizeof(world)));
+    (*capture)->flush();
+    CHECK((*capture)->stats().written == 2);
+
+    auto file = readFile(path);
+    CHECK(file.size() > 60);
+    CHECK(u32(file, 0) == 0x0A0D0D0A && u32(file, 8) == 0x1A2B3C4D);
+    CHECK(u32(file, 28) == 1 && (u32(file, 36) & 0xFFFF) == 101);
+
+    auto packets = parse(file);
+    CHECK(packets.size() == 2);
+
+    // Received: client to server, inbound, IPv4 with a valid header.
+    const auto& in = packets[0].data;
+    CHECK(packets[0].flags == 1);
+    CHECK(in.size() == 28 + sizeof(hello) && packets[0].original == in.size());
+    CHECK(in[0] == 0x45 && in[9] == 17 && be16(in, 2) == in.size());
+    CHECK(in[16] == 127 && in[19] == 1 && be16(in, 22) == 7000);
+    CHECK(be16(in, 20) == request->addr.port());
+    uint32_t sum = 0;
+    for (size_t i = 0; i < 20; i += 2) {
+        sum += be16(in, i);
+    }
+    CHECK(((sum & 0xFFFF) + (sum >> 16)) == 0xFFFF);
+    CHECK(std::memcmp(in.data() + 28, hello, sizeof(hello)) == 0);
+
+    // Sent: server to client, outbound.
+    const auto& out = packets[1].data;
+    CHECK(packets[1].flags == 2);
+    CHECK(be16(out, 20) == 7000 && be16(out, 22) == request->addr.port());
+    CHECK(std::memcmp(out.data() + 28, world, sizeof(world)) == 0);
+    std::remove(path.c_str());
+    return 0;
+}
+
+int runSnapAndSample() {
+    const std::string path = tempPath("pulsenet_capture_test.pcap");
+    auto capture = PacketCapture::Create({ .path = path, .format = CaptureFormat::Pcap, .snapLength = 8, .sampleEvery = 4 });
+    CHECK(capture);
+
+    auto network = MemoryNetwork::Create();
+    CHECK(network);
+    auto server = (*network)->listen(addr("127.0.0.1", 7000));
+    auto client = (*network)->dial(addr("127.0.0.1", 7000), { .capture = *capture });
+    CHECK(server && client);
+
+    std::vector<uint8_t> payload(100, 'x');
+    for (int i = 0; i < 20; ++i) {
+        CHECK((*client)->send(payload.data(), payload.size()));
+    }
+    (*capture)->setEnabled(false);
+    for (int i = 0; i < 20; ++i) {
+        CHECK((*client)->send(payload.data(), payload.size()));
+    }
+    (*capture)->flush();
+
+    auto file = readFile(path);
+    CHECK(file.size() >= 24 && u32(file, 0) == 0xA1B23C4D && u32(file, 20) == 101);
+    auto packets = parse(file);
+    CHECK(packets.size() == 5);
+    for (const auto& packet : packets) {
+        CHECK(packet.data.size() == 28 + 8);
+        CHECK(packet.original == 28 + 100);
+        CHECK(be16(packet.data, 24) == 108); // UDP length is the original's
+    }
+    std::remove(path.c_str());
+    return 0;
+}
+
+int runRotation() {
+    const std::string path = tempPath("pulsenet_capture_rotate.pcapng");
+    auto capture = PacketCapture::Create({ .path = path, .snapLength = 64, .rotateBytes = 1000, .maxFiles = 2 });
+    CHECK(capture);
+
+    auto network = MemoryNetwork::Create();
+    CHECK(network);
+    auto server = (*network)->listen(addr("127.0.0.1", 7000), { .capture = *capture });
+    auto client = (*network)->dial(addr("127.0.0.1", 7000));
+    CHECK(server && client);
+
+    // About 140 bytes a block, so each file takes seven or so.
+    std::vector<uint8_t> payload(64, 'y');
+    for (int i = 0; i < 40; ++i) {
+        CHECK((*client)->send(payload.data(), payload.size()));
+        CHECK((*server)->recvFrom());
+    }
+    (*capture)->flush();
+    auto stats = (*capture)->stats();
+    CHECK(stats.written == 40 && stats.dropped == 0);
+    CHECK(stats.files >= 5);
+
+    // Only the newest two remain.
+    const std::string newest = path + "." + std::to_string(stats.files - 1);
+    const std::string previous = path + "." + std::to_string(stats.files - 2);
+    CHECK(std::filesystem::exists(newest) && std::filesystem::exists(previous));
+    CHECK(!std::filesystem::exists(path) && !std::filesystem::exists(path + ".1"));
+    CHECK(u32(readFile(newest), 0) == 0x0A0D0D0A);
+    std::remove(newest.c_str());
+    std::remove(previous.c_str());
+
+    // A directory squatting on the next file's name: the rotation fails and the rest is dropped.
+    const std::string blocked = tempPath("pulsenet_capture_blocked.pcapng");
+    std::filesystem::create_directory(blocked + ".1");
+    auto stuck = PacketCapture::Create({ .path = blocked, .snapLength = 64, .rotateBytes = 100 });
+    CHECK(stuck);
+    for (int i = 0; i < 5; ++i) {
+        (*stuck)->record(CaptureDirection::Sent, addr("127.0.0.1", 1), addr("127.0.0.1", 2), payload.data(), payload.size());
+    }
+    (*stuck)->flush();
+    stats = (*stuck)->stats();
+    CHECK(stats.written == 1 && stats.dropped == 4 && stats.files == 1);
+    stuck->reset();
+    std::remove(blocked.c_str());
+    std::filesystem::remove(blocked + ".1");
+    return 0;
+}
+
+int runOverflowAndErrors() {
+    const std::string path = tempPath("pulsenet_capture_small.pcapng");
+    // Room for two datagrams; the writer only wakes every ten seconds unless flushed.
+    auto capture = PacketCapture::Create({ .path = path, .snapLength = 0, .ringBytes = 1, .flushInterval = std::chrono::seconds(10) });
+    CHECK(capture);
+    const uint8_t byte = 1;
+    for (int i = 0; i < 10; ++i) {
+        (*capture)->record(CaptureDirection::Sent, addr("127.0.0.1", 1), addr("127.0.0.1", 2), &byte, 1);
+    }
+    auto stats = (*capture)->stats();
+    CHECK(stats.captured == 2 && stats.dropped == 8);
+    (*capture)->flush();
+    CHECK((*capture)->stats().written == 2);
+    capture->reset();
+    std::remove(path.c_str());
+
+    CHECK(!PacketCapture::Create({}));
+    CHECK(!PacketCapture::Create({ .path = path, .sampleEvery = 0 }));
+    auto missing = PacketCapture::Create({ .path = tempPath("no_such_directory/capture.pcapng") });
+    CHECK(!missing && missing.error() == ErrorCode::InvalidArgument);
+    return 0;
+}
+
+int runLoopback() {
+    const std::string path = tempPath("pulsenet_capture_loopback.pcapng");
+    auto capture = PacketCapture::Create({ .path = path });
+    CHECK(capture);
+
+    auto* factory = get_socket_factory();
+    auto server = factory->listen(addr("127.0.0.1", 12355), { .capture = *capture });
+    auto client = factory->dial(addr("127.0.0.1", 12355), { .capture = *capture });
+    CHECK(server && client);
+
+    const uint8_t ping[] = "ping";
+    CHECK((*client)->send(ping, sizeof(ping)));
+    CHECK((*server)->recvFromUntil(std::chrono::steady_clock::now() + std::chrono::seconds(1)));
+    (*capture)->flush();
+
+    auto packets = parse(readFile(path));
+    CHECK(packets.size() == 2);
+    CHECK(packets[0].flags == 2 && packets[1].flags == 1);
+    CHECK(packets[0].data == packets[1].data); // Both ends saw the same datagram
+    CHECK(be16(packets[0].data, 22) == 12355);
+    std::remove(path.c_str());
+    return 0;
+}
+
+int main() {
+    if (runPcapNg() != 0 || runSnapAndSample() != 0 || runRotation() != 0 || runOverflowAndErrors() != 0 || runLoopback() != 0) {
+        return 1;
+    }
+    std::cout << "PacketCapture checks passed." << std::endl;
+    return 0;
+}
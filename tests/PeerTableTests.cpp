@@ -0,0 +1,176 @@
+#include <pulse/net/udp/peer_table.h>
+#include <iostream>
+#include <iomanip>
+#include <unordered_map>
+#include <vector>
+#include <chrono>
+#include <string>
+
+using namespace pulse::net::udp;
+
+struct Session {
+    uint64_t packets = 0;
+    uint32_t id = 0;
+};
+
+std::vector<Addr> makePeers(size_t count) {
+    std::vector<Addr> peers;
+    peers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        std::string ip = "10." + std::to_string((i >> 16) & 0xFF) + "." + std::to_string((i >> 8) & 0xFF) + "." + std::to_string(i & 0xFF);
+        peers.push_back(*Addr::Create(ip, static_cast<uint16_t>(1024 + (i % 50000))));
+    }
+    return peers;
+}
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            std::cerr << "Check failed at line " << __LINE__ << ": " #cond << std::endl; \
+            return 1;                                                               \
+        }                                                                           \
+    } while (0)
+
+int runCorrectness() {
+    constexpr size_t kPeers = 20000;
+    auto peers = makePeers(kPeers);
+
+    PeerTable<Session> table;
+    CHECK(!table.find(peers[0]));
+
+    auto [first, inserted] = table.tryEmplace(peers[0], Session{ .packets = 0, .id = 0 });
+    CHECK(inserted);
+    Session* firstSession = table.get(first);
+    CHECK(firstSession != nullptr);
+
+    for (size_t i = 1; i < kPeers; ++i) {
+        auto [handle, added] = table.tryEmplace(peers[i], Session{ .packets = 0, .id = static_cast<uint32_t>(i) });
+        CHECK(added);
+        CHECK(table.get(handle)->id == i);
+    }
+    CHECK(table.size() == kPeers);
+
+    // Growth rebuilt the index many times over; the first session must not have moved.
+    CHECK(table.get(first) == firstSession);
+    CHECK(*table.addressOf(first) == peers[0]);
+
+    for (size_t i = 0; i < kPeers; ++i) {
+        auto handle = table.find(peers[i]);
+        CHECK(handle);
+        CHECK(table.get(handle)->id == i);
+    }
+
+    // Looking up an existing peer must not insert a second copy.
+    auto [again, insertedAgain] = table.tryEmplace(peers[5], Session{ .packets = 0, .id = 999999 });
+    CHECK(!insertedAgain);
+    CHECK(table.get(again)->id == 5);
+    Session& found = table.findOrEmplace(peers[5], Session{ .packets = 0, .id = 999999 });
+    CHECK(&found == table.get(again) && table.size() == kPeers);
+
+    // Erase every other peer by handle, then make sure the survivors are still reachable.
+    std::vector<PeerTable<Session>::Handle> erased;
+    for (size_t i = 0; i < kPeers; i += 2) {
+        auto handle = table.find(peers[i]);
+        CHECK(table.erase(handle));
+        erased.push_back(handle);
+    }
+    CHECK(table.size() == kPeers / 2);
+    for (size_t i = 0; i < kPeers; ++i) {
+        CHECK(static_cast<bool>(table.find(peers[i])) == (i % 2 == 1));
+    }
+
+    // Stale handles stay stale, even once their slots are handed to new peers.
+    auto fresh = makePeers(kPeers * 2);
+    for (size_t i = kPeers; i < kPeers + kPeers / 2; ++i) {
+        CHECK(table.tryEmplace(fresh[i], Session{}).second);
+    }
+    for (const auto& handle : erased) {
+        CHECK(table.get(handle) == nullptr);
+        CHECK(!table.erase(handle));
+    }
+
+    // Churn: tombstones must be recycled instead of growing the index forever.
+    PeerTable<Session> churn;
+    for (size_t round = 0; round < 200; ++round) {
+        for (size_t i = 0; i < 100; ++i) {
+            CHECK(churn.tryEmplace(fresh[round * 100 + i], Session{}).second);
+        }
+        for (size_t i = 0; i < 100; ++i) {
+            CHECK(churn.erase(fresh[round * 100 + i]));
+        }
+    }
+    CHECK(churn.empty());
+
+    size_t visited = 0;
+    table.forEach([&](PeerTable<Session>::Handle, const Addr&, Session& session) {
+        ++session.packets;
+        ++visited;
+    });
+    CHECK(visited == table.size());
+
+    // Moving hands every peer over and leaves the source empty but usable.
+    PeerTable<Session> moved(std::move(table));
+    CHECK(moved.size() == visited && moved.find(peers[1]));
+    CHECK(table.empty() && !table.find(peers[1]));
+    CHECK(table.tryEmplace(peers[1], Session{}).second && table.size() == 1);
+    table = std::move(moved);
+    CHECK(table.size() == visited && table.get(again)->id == 5);
+    CHECK(moved.empty() && !moved.find(peers[1]) && !moved.get(again));
+    CHECK(moved.tryEmplace(peers[1], Session{}).second);
+
+    table.clear();
+    CHECK(table.empty());
+    CHECK(!table.find(peers[1]));
+    CHECK(table.get(again) == nullptr);
+
+    return 0;
+}
+
+// Per-packet lookup cost against the unordered_map servers use today. Informational only.
+void runLookupBench() {
+    constexpr size_t kPeers = 10000;
+    constexpr size_t kLookups = 5000000;
+    auto peers = makePeers(kPeers);
+
+    std::vector<size_t> order(kLookups);
+    uint64_t state = 88172645463325252ull;
+    for (auto& index : order) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        index = static_cast<size_t>(state % kPeers);
+    }
+
+    PeerTable<Session> table(kPeers);
+    std::unordered_map<Addr, Session> map;
+    map.reserve(kPeers);
+    for (const auto& peer : peers) {
+        (void)table.tryEmplace(peer, Session{});
+        map.emplace(peer, Session{});
+    }
+
+    auto time = [&](auto&& lookup) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t index : order) {
+            lookup(peers[index]);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / kLookups;
+    };
+
+    double tableNs = time([&](const Addr& addr) { ++table.get(addr)->packets; });
+    double mapNs = time([&](const Addr& addr) { ++map.find(addr)->second.packets; });
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "Lookup+update over " << kPeers << " peers: PeerTable " << tableNs << " ns, "
+              << "unordered_map " << mapNs << " ns" << std::endl;
+}
+
+int main() {
+    if (runCorrectness() != 0) {
+        return 1;
+    }
+    std::cout << "PeerTable checks passed." << std::endl;
+
+    runLookupBench();
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include <pulse/net/udp/rx_pipeline.h>
+#include <pulse/net/udp/udp.h>
+#include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace pulse::net::udp;
+
+#define CHECK(cond)                                                                 \
+    do {                                                                            \
+        if (!(cond)) {                                                              \
+            std::cerr << "Check failed at line " << __LINE__ << ": " #cond << std::endl; \
+            return 1;                                                               \
+        }                                                                           \
+    } while (0)
+
+int runSpscRing() {
+    constexpr uint64_t kValues = 1'000'000;
+    SpscRing<uint64_t> ring(1000);
+    CHECK(ring.capacity() == 1024);
+
+    std::thread producer([&] {
+        for (uint64_t i = 1; i <= kValues;) {
+            uint64_t value = i;
+            if (ring.tryPush(std::move(value))) {
+                ++i;
+            }
+        }
+    });
+
+    uint64_t expected = 1;
+    while (expected <= kValues) {
+        if (auto value = ring.tryPop()) {
+            CHECK(*value == expected);
+            ++expected;
+        }
+    }
+    producer.join();
+    CHECK(!ring.tryPop());
+    return 0;
+}
+
+int runMpmcRing() {
+    constexpr uint64_t kPerProducer = 200'000;
+    constexpr size_t kThreads = 2;
+    MpmcRing<uint64_t> ring(64);
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> popped{0};
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            for (uint64_t i = 1; i <= kPerProducer;) {
+                uint64_t value = i;
+                if (ring.tryPush(std::move(value))) {
+                    ++i;
+                }
+            }
+        });
+        threads.emplace_back([&] {
+            while (popped.load(std::memory_order_relaxed) < kThreads * kPerProducer) {
+                if (auto value = ring.tryPop()) {
+                    sum.fetch_add(*value, std::memory_order_relaxed);
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    CHECK(popped.load() == kThreads * kPerProducer);
+    CHECK(sum.load() == kThreads * kPerProducer * (kPerProducer + 1) / 2);
+    return 0;
+}
+
+// Pumps until the socket has nothing more to read.
+size_t pumpAll(RxPipeline& pipeline) {
+    size_t dispatched = 0;
+    for (int idle = 0; idle < 50;) {
+        auto result = pipeline.pump();
+        if (result && *result > 0) {
+            dispatched += *result;
+            idle = 0;
+        } else {
+            ++idle;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return dispatched;
+}
+
+int runPipeline() {
+    auto serverAddr = Addr::Create("127.0.0.1", 12352);
+    CHECK(serverAddr);
+    auto server = get_socket_factory()->listen(*serverAddr);
+    CHECK(server);
+    auto pool = PacketPool::Create(PacketPoolOptions{ .bufferSize = 2048, .bufferCount = 256 });
+    CHECK(pool);
+
+    constexpr size_t kClients = 4;
+    constexpr uint8_t kPerClient = 20;
+    std::vector<std::unique_ptr<ISocket>> clients;
+    for (size_t i = 0; i < kClients; ++i) {
+        auto client = get_socket_factory()->dial(*serverAddr);
+        CHECK(client);
+        clients.push_back(std::move(*client));
+    }
+    auto sendAll = [&](uint8_t count) {
+        for (uint8_t seq = 0; seq < count; ++seq) {
+            for (auto& client : clients) {
+                (void)client->send(&seq, 1);
+            }
+        }
+    };
+
+    // PeerHash: a peer sticks to one worker and its datagrams stay in order.
+    {
+        auto pipeline = RxPipeline::Create(**server, **pool, RxPipelineOptions{ .workers = 3, .queueCapacity = 256 });
+        CHECK(pipeline);
+        sendAll(kPerClient);
+        CHECK(pumpAll(**pipeline) == kClients * kPerClient);
+
+        std::vector<std::pair<Addr, uint8_t>> seen;
+        for (size_t worker = 0; worker < 3; ++worker) {
+            while (auto packet = (*pipeline)->pop(worker)) {
+                CHECK(packet->size() == 1);
+                CHECK(packet->addr().hash() % 3 == worker);
+                bool found = false;
+                for (auto& [addr, next] : seen) {
+                    if (addr == packet->addr()) {
+                        CHECK(packet->data()[0] == next);
+                        ++next;
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    CHECK(packet->data()[0] == 0);
+                    seen.emplace_back(packet->addr(), 1);
+                }
+            }
+        }
+        CHECK(seen.size() == kClients);
+        for (const auto& entry : seen) {
+            CHECK(entry.second == kPerClient);
+        }
+        CHECK((*pool)->available() == (*pool)->bufferCount());
+    }
+
+    // A worker that falls behind under Drop: its ring fills, the rest are counted and freed.
+    {
+        auto pipeline = RxPipeline::Create(**server, **pool, RxPipelineOptions{ .workers = 1, .queueCapacity = 8 });
+        CHECK(pipeline);
+        sendAll(kPerClient);
+        CHECK(pumpAll(**pipeline) == 8);
+        auto stats = (*pipeline)->stats();
+        CHECK(stats.received == kClients * kPerClient);
+        CHECK(stats.dispatched == 8);
+        CHECK(stats.dropped == kClients * kPerClient - 8);
+        CHECK((*pipeline)->queueStats(0).depth == 8);
+        CHECK((*pool)->available() == (*pool)->bufferCount() - 8);
+    }
+    CHECK((*pool)->available() == (*pool)->bufferCount());
+
+    // Stall instead: nothing is dropped, pump() waits on the worker, and order holds.
+    {
+        auto pipeline = RxPipeline::Create(**server, **pool, RxPipelineOptions{ .workers = 2, .queueCapacity = 8, .dispatch = DispatchPolicy::RoundRobin, .overflow = OverflowPolicy::Stall });
+        CHECK(pipeline);
+        sendAll(kPerClient);
+
+        std::atomic<bool> done{false};
+        std::atomic<size_t> handled{0};
+        std::vector<std::thread> workers;
+        for (size_t worker = 0; worker < 2; ++worker) {
+            workers.emplace_back([&, worker] {
+                PooledPacket packets[4];
+                while (!done.load(std::memory_order_relaxed)) {
+                    const size_t count = (*pipeline)->popBatch(worker, packets);
+                    handled.fetch_add(count, std::memory_order_relaxed);
+                    for (size_t i = 0; i < count; ++i) {
+                        packets[i].reset();
+                    }
+                    std::this_thread::sleep_for(std::chrono::microseconds(200)); // A slow worker
+                }
+            });
+        }
+        const size_t dispatched = pumpAll(**pipeline);
+        while (handled.load() < kClients * kPerClient) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        done = true;
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        auto stats = (*pipeline)->stats();
+        CHECK(dispatched == kClients * kPerClient);
+        CHECK(stats.dropped == 0);
+        CHECK(stats.stalls > 0);
+        CHECK((*pipeline)->queueStats(0).dispatched == (*pipeline)->queueStats(1).dispatched);
+    }
+
+    // Shared: any worker can pop anything from the one MPMC ring.
+    {
+        auto pipeline = RxPipeline::Create(**server, **pool, RxPipelineOptions{ .workers = 2, .dispatch = DispatchPolicy::Shared });
+        CHECK(pipeline);
+        sendAll(2);
+        CHECK(pumpAll(**pipeline) == kClients * 2);
+        CHECK((*pipeline)->queueStats(0).depth == kClients * 2);
+        size_t popped = 0;
+        while ((*pipeline)->pop(popped % 2)) {
+            ++popped;
+        }
+        CHECK(popped == kClients * 2);
+    }
+
+    CHECK(!RxPipeline::Create(**server, **pool, RxPipelineOptions{ .workers = 0 }));
+    CHECK(!RxPipeline::Create(**server, **pool, RxPipelineOptions{ .batchSize = 65 }));
+    return 0;
+}
+
+int main() {
+    if (runSpscRing() != 0 || runMpmcRing() != 0) {
+        return 1;
+    }
+    std::cout << "Ring checks passed." << std::endl;
+
+    if (runPipeline() != 0) {
+        return 1;
+    }
+    std::cout << "RxPipeline checks passed." << std::endl;
+    return 0;
+}
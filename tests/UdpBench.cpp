@@ -0,0 +1,561 @@
+#include <pulse/net/udp/udp.h>
+#include <pulse/net/udp/memory_network.h>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <algorithm>
+#include <charconv>
+
+using namespace pulse::net::udp;
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchConfig {
+    std::string backend = "default";
+    std::vector<std::string> scenarios = {"throughput", "rtt", "recvbatch"};
+    std::vector<size_t> payloads = {64, 512, 1400};
+    std::vector<size_t> threads = {1, 2, 4};
+    std::chrono::milliseconds duration{1000};
+    uint16_t basePort = 9200;
+};
+
+// Log-linear histogram in the spirit of HdrHistogram: each power of two is split into 64 linear
+// sub-buckets, so every recorded value is reported to within 1/64 of itself, with no allocation
+// after construction and a cheap merge across threads.
+class LatencyHistogram {
+public:
+    LatencyHistogram() : counts_(kSubBuckets + 64 * kHalfBuckets) {}
+
+    void record(uint64_t value) {
+        ++counts_[indexOf(value)];
+        ++total_;
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+        sum_ += value;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+        sum_ += other.sum_;
+    }
+
+    // Highest value equivalent to the one at `quantile`, like HdrHistogram reports it.
+    uint64_t percentile(double quantile) const {
+        if (total_ == 0) {
+            return 0;
+        }
+        const auto target = std::max<uint64_t>(1, static_cast<uint64_t>(quantile * static_cast<double>(total_) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts_.size(); ++i) {
+            seen += counts_[i];
+            if (seen >= target) {
+                return std::min(highestEquivalent(i), max_);
+            }
+        }
+        return max_;
+    }
+
+    uint64_t count() const { return total_; }
+    uint64_t min() const { return total_ ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return total_ ? static_cast<double>(sum_) / static_cast<double>(total_) : 0.0; }
+
+private:
+    static constexpr size_t kSubBuckets = 128;
+    static constexpr size_t kHalfBuckets = kSubBuckets / 2;
+
+    // Values below 128 get a bucket each; above that, the top seven bits pick the bucket.
+    static size_t indexOf(uint64_t value) {
+        const int shift = std::max(0, static_cast<int>(std::bit_width(value)) - 7);
+        if (shift == 0) {
+            return static_cast<size_t>(value);
+        }
+        return kSubBuckets + static_cast<size_t>(shift - 1) * kHalfBuckets + static_cast<size_t>((value >> shift) - kHalfBuckets);
+    }
+
+    static uint64_t highestEquivalent(size_t index) {
+        if (index < kSubBuckets) {
+            return index;
+        }
+        const size_t shift = (index - kSubBuckets) / kHalfBuckets + 1;
+        const uint64_t sub = (index - kSubBuckets) % kHalfBuckets + kHalfBuckets;
+        return ((sub + 1) << shift) - 1;
+    }
+
+    std::vector<uint64_t> counts_;
+    uint64_t total_ = 0;
+    uint64_t min_ = UINT64_MAX;
+    uint64_t max_ = 0;
+    uint64_t sum_ = 0;
+};
+
+// One line of the JSON report, written by hand to keep the bench dependency free.
+class JsonRecord {
+public:
+    JsonRecord& field(std::string_view name, std::string_view value) {
+        separator();
+        out_ << '"' << name << "\":\"" << value << '"';
+        return *this;
+    }
+
+    JsonRecord& field(std::string_view name, double value) {
+        separator();
+        out_ << '"' << name << "\":" << std::fixed << std::setprecision(3) << value;
+        return *this;
+    }
+
+    JsonRecord& field(std::string_view name, uint64_t value) {
+        separator();
+        out_ << '"' << name << "\":" << value;
+        return *this;
+    }
+
+    std::string str() const { return out_.str() + "}"; }
+
+private:
+    void separator() {
+        out_ << (first_ ? "{" : ",");
+        first_ = false;
+    }
+
+    std::ostringstream out_;
+    bool first_ = true;
+};
+
+struct SocketPair {
+    std::unique_ptr<ISocket> server;
+    std::unique_ptr<ISocket> client;
+};
+
+std::expected<SocketPair, Error> openPair(ISocketFactory& factory, uint16_t port, size_t payload) {
+    auto addr = Addr::Create("127.0.0.1", port);
+    if (!addr) {
+        return std::unexpected(addr.error());
+    }
+    const SocketOptions options{
+        .maxDatagramSize = std::max<size_t>(payload, 2048),
+        .receiveBufferSize = 4 << 20,
+        .sendBufferSize = 4 << 20,
+    };
+    auto server = factory.listen(*addr, options);
+    if (!server) {
+        return std::unexpected(server.error());
+    }
+    auto client = factory.dial(*addr, options);
+    if (!client) {
+        return std::unexpected(client.error());
+    }
+    return SocketPair{ std::move(*server), std::move(*client) };
+}
+
+// Receive buffers for recvBatch(), refreshed before every call since it reorders entries.
+struct RecvBuffers {
+    RecvBuffers(size_t count, size_t size) : storage(count * size), packets(count), size(size) {}
+
+    std::span<ReceivedPacket> reset() {
+        for (size_t i = 0; i < packets.size(); ++i) {
+            packets[i] = ReceivedPacket{ .data = storage.data() + i * size, .size = 0, .capacity = size, .addr = {} };
+        }
+        return packets;
+    }
+
+    std::vector<uint8_t> storage;
+    std::vector<ReceivedPacket> packets;
+    size_t size;
+};
+
+// A worker's packet count, alone on its cache line so workers on different cores don't falsely share.
+struct alignas(64) PaddedCounter {
+    uint64_t value = 0;
+};
+
+// Every sender blasts batches at its own server for the whole window while a receiver drains it.
+// Reports what arrived: with more senders than cores the kernel drops the excess, and that shows.
+std::optional<std::string> runThroughput(ISocketFactory& factory, const BenchConfig& config, size_t payload, size_t threads) {
+    std::vector<SocketPair> pairs;
+    for (size_t i = 0; i < threads; ++i) {
+        auto pair = openPair(factory, static_cast<uint16_t>(config.basePort + i), payload);
+        if (!pair) {
+            std::cerr << "throughput: failed to open sockets: " << to_string(pair) << std::endl;
+            return std::nullopt;
+        }
+        pairs.push_back(std::move(*pair));
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<PaddedCounter> sent(threads);
+    std::vector<PaddedCounter> received(threads);
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i] {
+            std::vector<uint8_t> data(payload, 0xAB);
+            std::vector<OutgoingPacket> batch(32, OutgoingPacket{ .data = data.data(), .size = payload, .addr = {}, .result = {} });
+            auto addr = Addr::Create("127.0.0.1", static_cast<uint16_t>(config.basePort + i));
+            for (auto& packet : batch) {
+                packet.addr = *addr;
+            }
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto count = pairs[i].client->sendBatch(batch);
+                if (count && *count > 0) {
+                    sent[i].value += *count;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        workers.emplace_back([&, i] {
+            RecvBuffers buffers(64, std::max<size_t>(payload, 2048));
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto count = pairs[i].server->recvBatch(buffers.reset());
+                if (count) {
+                    received[i].value += *count;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    const auto start = Clock::now();
+    std::this_thread::sleep_for(config.duration);
+    stop = true;
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    uint64_t totalSent = 0;
+    uint64_t totalReceived = 0;
+    for (size_t i = 0; i < threads; ++i) {
+        totalSent += sent[i].value;
+        totalReceived += received[i].value;
+    }
+    const double pps = static_cast<double>(totalReceived) / seconds;
+
+    std::cerr << "throughput payload=" << payload << " threads=" << threads << ": "
+              << std::fixed << std::setprecision(3) << pps / 1e6 << " Mpps, "
+              << pps * static_cast<double>(payload) / 1e6 << " MB/s" << std::endl;
+
+    return JsonRecord()
+        .field("scenario", "throughput")
+        .field("payload", static_cast<uint64_t>(payload))
+        .field("threads", static_cast<uint64_t>(threads))
+        .field("seconds", seconds)
+        .field("sent", totalSent)
+        .field("received", totalReceived)
+        .field("pps", pps)
+        .field("bytes_per_sec", pps * static_cast<double>(payload))
+        .str();
+}
+
+// Each thread plays ping-pong with its own echo thread, one datagram in flight at a time.
+std::optional<std::string> runRtt(ISocketFactory& factory, const BenchConfig& config, size_t payload, size_t threads) {
+    payload = std::max(payload, sizeof(uint64_t)); // Room for the sequence number
+
+    std::vector<SocketPair> pairs;
+    for (size_t i = 0; i < threads; ++i) {
+        auto pair = openPair(factory, static_cast<uint16_t>(config.basePort + i), payload);
+        if (!pair) {
+            std::cerr << "rtt: failed to open sockets: " << to_string(pair) << std::endl;
+            return std::nullopt;
+        }
+        pairs.push_back(std::move(*pair));
+    }
+
+    std::atomic<bool> stop{false};
+    std::vector<LatencyHistogram> histograms(threads);
+    std::vector<uint64_t> lost(threads, 0);
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i] {
+            auto& server = *pairs[i].server;
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto packet = server.recvFrom();
+                if (!packet) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                (void)server.sendTo(packet->addr, packet->data, packet->size);
+            }
+        });
+        workers.emplace_back([&, i] {
+            auto& client = *pairs[i].client;
+            std::vector<uint8_t> data(payload, 0xCD);
+            for (uint64_t sequence = 0; !stop.load(std::memory_order_relaxed); ++sequence) {
+                std::memcpy(data.data(), &sequence, sizeof(sequence));
+                const auto sentAt = Clock::now();
+                if (!client.send(data.data(), data.size())) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                // A reply that takes longer than this is counted as lost; stale replies are skipped.
+                const auto deadline = sentAt + std::chrono::milliseconds(100);
+                while (true) {
+                    auto reply = client.recvFrom();
+                    if (reply) {
+                        uint64_t echoed = 0;
+                        std::memcpy(&echoed, reply->data, sizeof(echoed));
+                        if (echoed == sequence) {
+                            histograms[i].record(static_cast<uint64_t>(std::chrono::nanoseconds(Clock::now() - sentAt).count()));
+                            break;
+                        }
+                        continue;
+                    }
+                    if (Clock::now() > deadline || stop.load(std::memory_order_relaxed)) {
+                        ++lost[i];
+                        break;
+                    }
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::this_thread::sleep_for(config.duration);
+    stop = true;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    LatencyHistogram merged;
+    uint64_t totalLost = 0;
+    for (size_t i = 0; i < threads; ++i) {
+        merged.merge(histograms[i]);
+        totalLost += lost[i];
+    }
+
+    std::cerr << "rtt payload=" << payload << " threads=" << threads << ": p50 " << merged.percentile(0.5)
+              << " ns, p99 " << merged.percentile(0.99) << " ns, p99.9 " << merged.percentile(0.999)
+              << " ns over " << merged.count() << " round trips" << std::endl;
+
+    return JsonRecord()
+        .field("scenario", "rtt")
+        .field("payload", static_cast<uint64_t>(payload))
+        .field("threads", static_cast<uint64_t>(threads))
+        .field("samples", merged.count())
+        .field("lost", totalLost)
+        .field("min_ns", merged.min())
+        .field("mean_ns", merged.mean())
+        .field("p50_ns", merged.percentile(0.5))
+        .field("p99_ns", merged.percentile(0.99))
+        .field("p999_ns", merged.percentile(0.999))
+        .field("max_ns", merged.max())
+        .str();
+}
+
+// Queues a round of datagrams on the server, then times only the drain. This isolates the
+// receive path cost from the sender, which matters on small machines where both share a core.
+std::optional<std::string> runRecvBatch(ISocketFactory& factory, const BenchConfig& config, size_t payload, size_t batchSize) {
+    constexpr size_t kRoundSize = 128; // Small enough that the default receive buffer holds a full round
+
+    auto pair = openPair(factory, config.basePort, payload);
+    if (!pair) {
+        std::cerr << "recvbatch: failed to open sockets: " << to_string(pair) << std::endl;
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> data(payload, 0xAB);
+    RecvBuffers buffers(batchSize, std::max<size_t>(payload, 2048));
+    uint64_t packets = 0;
+    Clock::duration elapsed{0};
+
+    const auto until = Clock::now() + config.duration;
+    while (Clock::now() < until) {
+        size_t queued = 0;
+        for (size_t i = 0; i < kRoundSize; ++i) {
+            if (pair->client->send(data.data(), data.size())) {
+                ++queued;
+            }
+        }
+        (void)pair->client->flushPaced(); // io_uring queues the round until the client's next receive
+
+        size_t drained = 0;
+        const auto start = Clock::now();
+        while (drained < queued) {
+            auto count = pair->server->recvBatch(buffers.reset());
+            if (!count) {
+                break; // Anything still missing was dropped by the kernel.
+            }
+            drained += *count;
+        }
+        elapsed += Clock::now() - start;
+        packets += drained;
+    }
+
+    const double seconds = std::chrono::duration<double>(elapsed).count();
+    const double nsPerPacket = packets ? seconds * 1e9 / static_cast<double>(packets) : 0.0;
+    std::cerr << "recvbatch payload=" << payload << " batch=" << batchSize << ": "
+              << std::fixed << std::setprecision(1) << nsPerPacket << " ns/packet" << std::endl;
+
+    return JsonRecord()
+        .field("scenario", "recvbatch")
+        .field("payload", static_cast<uint64_t>(payload))
+        .field("batch", static_cast<uint64_t>(batchSize))
+        .field("packets", packets)
+        .field("ns_per_packet", nsPerPacket)
+        .field("pps", seconds > 0 ? static_cast<double>(packets) / seconds : 0.0)
+        .str();
+}
+
+// A positive decimal number and nothing else, or nullopt.
+std::optional<size_t> parseNumber(std::string_view text) {
+    size_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size() || value == 0) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<std::vector<size_t>> parseList(std::string_view text) {
+    std::vector<size_t> values;
+    while (!text.empty()) {
+        const size_t comma = text.find(',');
+        auto value = parseNumber(text.substr(0, comma));
+        if (!value) {
+            return std::nullopt;
+        }
+        values.push_back(*value);
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    }
+    if (values.empty()) {
+        return std::nullopt;
+    }
+    return values;
+}
+
+std::vector<std::string> parseNames(std::string_view text) {
+    std::vector<std::string> names;
+    while (!text.empty()) {
+        const size_t comma = text.find(',');
+        names.emplace_back(text.substr(0, comma));
+        text = comma == std::string_view::npos ? std::string_view() : text.substr(comma + 1);
+    }
+    return names;
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--backend default|io_uring|memory] [--scenarios throughput,rtt,recvbatch]\n"
+              << "       [--payloads 64,512,1400] [--threads 1,2,4] [--duration-ms 1000] [--port 9200]\n"
+              << "Results go to stdout as JSON; progress goes to stderr." << std::endl;
+}
+
+std::expected<ISocketFactory*, Error> factoryFor(std::string_view backend) {
+    if (backend == "default") {
+        return get_socket_factory();
+    }
+    if (backend == "io_uring") {
+        return get_io_uring_socket_factory();
+    }
+    if (backend == "memory") {
+        // No kernel at all, so what's left is the library's own cost.
+        static auto network = MemoryNetwork::Create();
+        if (!network) {
+            return std::unexpected(network.error());
+        }
+        return network->get();
+    }
+    return make_unexpected(ErrorCode::InvalidArgument, "Unknown backend");
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view flag = argv[i];
+        if (flag == "--help" || i + 1 == argc) {
+            printUsage(argv[0]);
+            return flag == "--help" ? 0 : 1;
+        }
+        const std::string_view value = argv[++i];
+        bool valid = true;
+        if (flag == "--backend") {
+            config.backend = value;
+        } else if (flag == "--scenarios") {
+            config.scenarios = parseNames(value);
+        } else if (flag == "--payloads") {
+            auto payloads = parseList(value);
+            valid = payloads.has_value();
+            config.payloads = payloads.value_or(std::vector<size_t>{});
+        } else if (flag == "--threads") {
+            auto threads = parseList(value);
+            valid = threads.has_value();
+            config.threads = threads.value_or(std::vector<size_t>{});
+        } else if (flag == "--duration-ms") {
+            auto ms = parseNumber(value);
+            valid = ms.has_value();
+            config.duration = std::chrono::milliseconds(ms.value_or(0));
+        } else if (flag == "--port") {
+            auto port = parseNumber(value);
+            valid = port && *port <= 65535;
+            config.basePort = static_cast<uint16_t>(port.value_or(0));
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    auto factory = factoryFor(config.backend);
+    if (!factory) {
+        std::cerr << "Backend " << config.backend << " unavailable: " << to_string(factory) << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> records;
+    auto keep = [&](std::optional<std::string> record) {
+        if (record) {
+            records.push_back(std::move(*record));
+        }
+        return record.has_value();
+    };
+
+    bool ok = true;
+    for (const auto& scenario : config.scenarios) {
+        for (size_t payload : config.payloads) {
+            if (scenario == "throughput") {
+                for (size_t threads : config.threads) {
+                    ok &= keep(runThroughput(**factory, config, payload, threads));
+                }
+            } else if (scenario == "rtt") {
+                for (size_t threads : config.threads) {
+                    ok &= keep(runRtt(**factory, config, payload, threads));
+                }
+            } else if (scenario == "recvbatch") {
+                for (size_t batchSize : {1, 8, 32, 64}) {
+                    ok &= keep(runRecvBatch(**factory, config, payload, batchSize));
+                }
+            } else {
+                std::cerr << "Unknown scenario: " << scenario << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    std::cout << "{\"backend\":\"" << config.backend << "\",\"duration_ms\":" << config.duration.count()
+              << ",\"hardware_threads\":" << std::thread::hardware_concurrency() << ",\"results\":[";
+    for (size_t i = 0; i < records.size(); ++i) {
+        std::cout << (i ? ",\n  " : "\n  ") << records[i];
+    }
+    std::cout << "\n]}" << std::endl;
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,661 @@
+#include <pulse/net/udp/udp.h>
+#include <pulse/net/udp/memory_network.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <iterator>
+#include <vector>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <optional>
+#include <algorithm>
+
+using namespace pulse::net::udp;
+
+using Clock = std::chrono::steady_clock;
+
+struct ReplayConfig {
+    std::string file;
+    std::string target;
+    std::string backend = "default";
+    double speed = 1.0;           // 2.0 replays twice as fast; 0 sends as fast as the sockets take it
+    size_t loops = 1;
+    size_t batch = 32;
+    size_t maxSockets = 1024;     // Sources beyond this share sockets
+    std::optional<uint16_t> dstPort; // Only datagrams originally sent to this port
+};
+
+// One UDP datagram out of the capture, ready to send.
+struct TracePacket {
+    int64_t timeNs = 0;  // Since the first datagram kept
+    size_t offset = 0;   // Into Trace::payloads
+    uint32_t size = 0;
+    uint32_t socket = 0; // Which local socket stands in for its original source
+};
+
+struct Trace {
+    std::vector<TracePacket> packets;
+    std::vector<uint8_t> payloads;
+    size_t sources = 0;
+    uint64_t skipped = 0;   // Not UDP, fragmented, filtered out, or an unknown link type
+    uint64_t truncated = 0; // Cut short by the capture's snap length; sent as captured
+};
+
+// Reads fields in the file's byte order, whichever that is.
+struct Reader {
+    const std::vector<uint8_t>& bytes;
+    bool swapped = false;
+
+    uint16_t u16(size_t offset) const {
+        uint16_t value = 0;
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return swapped ? std::byteswap(value) : value;
+    }
+
+    uint32_t u32(size_t offset) const {
+        uint32_t value = 0;
+        std::memcpy(&value, bytes.data() + offset, sizeof(value));
+        return swapped ? std::byteswap(value) : value;
+    }
+};
+
+uint16_t be16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] << 8 | p[1]);
+}
+
+// Collects the UDP datagrams in a capture, one link-layer frame at a time, and gives each distinct
+// source address and port its own socket slot.
+class TraceBuilder {
+public:
+    TraceBuilder(Trace& trace, const ReplayConfig& config) : trace_(trace), config_(config) {}
+
+    void add(uint32_t linkType, int64_t timeNs, const uint8_t* frame, size_t captured, size_t original) {
+        const auto ip = ipOffset(linkType, frame, captured);
+        if (!ip || *ip >= captured) {
+            ++trace_.skipped;
+            return;
+        }
+        addIp(timeNs, frame + *ip, captured - *ip, original - std::min(original, *ip));
+    }
+
+private:
+    using SourceKey = std::array<uint8_t, 19>; // Family, address, port
+
+    static std::optional<size_t> ipOffset(uint32_t linkType, const uint8_t* frame, size_t captured) {
+        switch (linkType) {
+            case 0:   // BSD loopback: a 4-byte family, then the packet
+            case 108:
+                return 4;
+            case 12:  // Raw IP, under its older numbers too
+            case 14:
+            case 101:
+            case 228:
+            case 229:
+                return 0;
+            case 113: // Linux cooked capture
+                return 16;
+            case 276: // Linux cooked capture v2
+                return 20;
+            case 1: { // Ethernet, through any VLAN tags
+                size_t offset = 12;
+                while (offset + 2 <= captured) {
+                    const uint16_t type = be16(frame + offset);
+                    if (type == 0x8100 || type == 0x88A8) {
+                        offset += 4;
+                        continue;
+                    }
+                    return offset + 2;
+                }
+                return std::nullopt;
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+
+    void addIp(int64_t timeNs, const uint8_t* ip, size_t captured, size_t original) {
+        SourceKey source{};
+        size_t header = 0;
+        uint8_t protocol = 0;
+        if (captured >= 20 && ip[0] >> 4 == 4) {
+            header = (ip[0] & 0x0F) * 4u;
+            protocol = ip[9];
+            if ((be16(ip + 6) & 0x3FFF) != 0) { // A fragment; only whole datagrams replay sensibly
+                ++trace_.skipped;
+                return;
+            }
+            source[0] = 4;
+            std::memcpy(source.data() + 1, ip + 12, 4);
+        } else if (captured >= 40 && ip[0] >> 4 == 6) {
+            header = 40;
+            protocol = ip[6];
+            // Step over hop-by-hop, routing and destination options headers.
+            while ((protocol == 0 || protocol == 43 || protocol == 60) && header + 8 <= captured) {
+                protocol = ip[header];
+                header += (ip[header + 1] + 1u) * 8u;
+            }
+            source[0] = 6;
+            std::memcpy(source.data() + 1, ip + 8, 16);
+        }
+        if (protocol != 17 || header < 20 || header + 8 > captured) {
+            ++trace_.skipped;
+            return;
+        }
+
+        const uint8_t* udp = ip + header;
+        const uint16_t dstPort = be16(udp + 2);
+        if (config_.dstPort && dstPort != *config_.dstPort) {
+            ++trace_.skipped;
+            return;
+        }
+        std::memcpy(source.data() + 17, udp, 2);
+
+        const size_t length = be16(udp + 4) >= 8 ? be16(udp + 4) - 8u : 0;
+        const size_t available = std::min(length, captured - header - 8);
+        if (available < length || original < header + 8 + length) {
+            ++trace_.truncated;
+        }
+
+        if (trace_.packets.empty()) {
+            firstNs_ = timeNs;
+        }
+        auto [slot, added] = sources_.try_emplace(source, static_cast<uint32_t>(sources_.size()));
+        trace_.packets.push_back(TracePacket{
+            .timeNs = std::max<int64_t>(0, timeNs - firstNs_),
+            .offset = trace_.payloads.size(),
+            .size = static_cast<uint32_t>(available),
+            .socket = static_cast<uint32_t>(slot->second % config_.maxSockets),
+        });
+        trace_.payloads.insert(trace_.payloads.end(), udp + 8, udp + 8 + available);
+        trace_.sources = sources_.size();
+    }
+
+    Trace& trace_;
+    const ReplayConfig& config_;
+    std::map<SourceKey, uint32_t> sources_;
+    int64_t firstNs_ = 0;
+};
+
+std::optional<Trace> loadPcap(const std::vector<uint8_t>& bytes, const ReplayConfig& config) {
+    const uint32_t magic = Reader{ bytes }.u32(0);
+    Reader in{ bytes, magic == 0xD4C3B2A1 || magic == 0x4D3CB2A1 };
+    const bool nanoseconds = magic == 0xA1B23C4D || magic == 0x4D3CB2A1;
+    const uint32_t linkType = in.u32(20) & 0xFFFF;
+
+    Trace trace;
+    TraceBuilder builder(trace, config);
+    for (size_t offset = 24; offset + 16 <= bytes.size();) {
+        const uint32_t captured = in.u32(offset + 8);
+        if (offset + 16 + captured > bytes.size()) {
+            break; // Cut off mid-record, as a capture still being written is
+        }
+        const int64_t timeNs = static_cast<int64_t>(in.u32(offset)) * 1'000'000'000
+                             + static_cast<int64_t>(in.u32(offset + 4)) * (nanoseconds ? 1 : 1000);
+        builder.add(linkType, timeNs, bytes.data() + offset + 16, captured, in.u32(offset + 12));
+        offset += 16 + captured;
+    }
+    return trace;
+}
+
+std::optional<Trace> loadPcapNg(const std::vector<uint8_t>& bytes, const ReplayConfig& config) {
+    struct Interface {
+        uint32_t linkType = 0;
+        uint64_t unitsPerSecond = 1'000'000; // if_tsresol, microseconds unless it says otherwise
+    };
+
+    Trace trace;
+    TraceBuilder builder(trace, config);
+    Reader in{ bytes };
+    std::vector<Interface> interfaces;
+    for (size_t offset = 0; offset + 12 <= bytes.size();) {
+        if (Reader{ bytes }.u32(offset) == 0x0A0D0D0A) {
+            // A new section, which may switch byte order and starts its own interface list.
+            in.swapped = Reader{ bytes }.u32(offset + 8) == 0x4D3C2B1A;
+            interfaces.clear();
+        }
+        const uint32_t type = in.u32(offset);
+        const uint32_t length = in.u32(offset + 4);
+        if (length < 12 || length % 4 != 0 || offset + length > bytes.size()) {
+            break;
+        }
+
+        if (type == 1 && length >= 20) {
+            Interface interface{ .linkType = in.u16(offset + 8) };
+            for (size_t option = offset + 16; option + 4 <= offset + length - 4;) {
+                const uint16_t code = in.u16(option);
+                const uint16_t size = in.u16(option + 2);
+                if (code == 0) {
+                    break;
+                }
+                if (code == 9 && size >= 1) {
+                    const uint8_t resolution = bytes[option + 4];
+                    interface.unitsPerSecond = 1;
+                    for (uint8_t i = 0; i < (resolution & 0x7F); ++i) {
+                        interface.unitsPerSecond *= (resolution & 0x80) ? 2 : 10;
+                    }
+                }
+                option += 4 + ((size + 3u) & ~3u);
+            }
+            interfaces.push_back(interface);
+        } else if (type == 6 && length >= 32) {
+            const uint32_t id = in.u32(offset + 8);
+            const uint32_t captured = in.u32(offset + 20);
+            if (id < interfaces.size() && captured <= length - 28) {
+                const auto& interface = interfaces[id];
+                const uint64_t units = static_cast<uint64_t>(in.u32(offset + 12)) << 32 | in.u32(offset + 16);
+                const auto timeNs = static_cast<int64_t>(units / interface.unitsPerSecond * 1'000'000'000
+                                                        + units % interface.unitsPerSecond * 1'000'000'000 / interface.unitsPerSecond);
+                builder.add(interface.linkType, timeNs, bytes.data() + offset + 28, captured, in.u32(offset + 24));
+            }
+        }
+        offset += length;
+    }
+    return trace;
+}
+
+std::optional<Trace> loadTrace(const ReplayConfig& config) {
+    std::ifstream file(config.file, std::ios::binary);
+    if (!file) {
+        std::cerr << "Can't open " << config.file << std::endl;
+        return std::nullopt;
+    }
+    const std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (bytes.size() < 24) {
+        std::cerr << config.file << " is too short to be a capture" << std::endl;
+        return std::nullopt;
+    }
+    const uint32_t magic = Reader{ bytes }.u32(0);
+    if (magic == 0x0A0D0D0A) {
+        return loadPcapNg(bytes, config);
+    }
+    if (magic == 0xA1B2C3D4 || magic == 0xD4C3B2A1 || magic == 0xA1B23C4D || magic == 0x4D3CB2A1) {
+        return loadPcap(bytes, config);
+    }
+    std::cerr << config.file << " is neither pcap nor pcapng" << std::endl;
+    return std::nullopt;
+}
+
+// Send-side tallies, plus target and achieved counts per 100 ms window for the peaks.
+struct ReplayStats {
+    static constexpr int64_t kWindowNs = 100'000'000;
+
+    uint64_t sent = 0;
+    uint64_t wouldBlock = 0;
+    uint64_t errors = 0;
+    uint64_t replies = 0;
+    int64_t lateSumNs = 0;
+    int64_t lateMaxNs = 0;
+    uint64_t lateOverMs = 0;
+    std::vector<uint64_t> targetWindows;
+    std::vector<uint64_t> sentWindows;
+
+    static void count(std::vector<uint64_t>& windows, int64_t timeNs) {
+        const auto index = static_cast<size_t>(std::max<int64_t>(0, timeNs) / kWindowNs);
+        if (index >= windows.size()) {
+            windows.resize(index + 1, 0);
+        }
+        ++windows[index];
+    }
+
+    static double peakPps(const std::vector<uint64_t>& windows) {
+        const uint64_t peak = windows.empty() ? 0 : *std::max_element(windows.begin(), windows.end());
+        return static_cast<double>(peak) * 1e9 / static_cast<double>(kWindowNs);
+    }
+};
+
+// Everything queued for one socket since its last sendBatch(), with the times each was due.
+struct PendingBatch {
+    std::vector<OutgoingPacket> packets;
+    std::vector<int64_t> dueNs;
+};
+
+class Replayer {
+public:
+    Replayer(const Trace& trace, const ReplayConfig& config, std::vector<std::unique_ptr<ISocket>> sockets, const Addr& target)
+        : trace_(trace), config_(config), sockets_(std::move(sockets)), target_(target), pending_(sockets_.size()) {}
+
+    ReplayStats run() {
+        const size_t total = trace_.packets.size() * config_.loops;
+        // Loops follow each other with the trace's mean gap between them.
+        const int64_t last = trace_.packets.back().timeNs;
+        span_ = last + (trace_.packets.size() > 1 ? last / static_cast<int64_t>(trace_.packets.size() - 1) : 0);
+
+        start_ = Clock::now();
+        int64_t nextDrainNs = 0;
+        int64_t nextReportNs = 1'000'000'000;
+        uint64_t reportedSent = 0;
+        size_t reportedTarget = 0;
+        size_t next = 0;
+        while (next < total) {
+            int64_t now = elapsedNs();
+            while (next < total && dueNs(next) <= now) {
+                queue(next++);
+            }
+            flush();
+
+            now = elapsedNs();
+            if (now >= nextDrainNs) {
+                drainReplies();
+                nextDrainNs = now + 10'000'000;
+            }
+            if (now >= nextReportNs) {
+                std::cerr << "t=" << nextReportNs / 1'000'000'000 << "s target " << next - reportedTarget << " pps, sent "
+                          << stats_.sent - reportedSent << " pps" << std::endl;
+                reportedTarget = next;
+                reportedSent = stats_.sent;
+                nextReportNs += 1'000'000'000;
+            }
+            if (next < total) {
+                waitUntil(std::min(dueNs(next), nextDrainNs));
+            }
+        }
+        drainReplies();
+        elapsedSeconds_ = static_cast<double>(elapsedNs()) / 1e9;
+        return stats_;
+    }
+
+    double elapsedSeconds() const { return elapsedSeconds_; }
+    double scheduledSeconds() const { return static_cast<double>(dueNs(trace_.packets.size() * config_.loops - 1)) / 1e9; }
+
+private:
+    int64_t elapsedNs() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_).count();
+    }
+
+    int64_t dueNs(size_t index) const {
+        if (config_.speed <= 0) {
+            return 0;
+        }
+        const auto& packet = trace_.packets[index % trace_.packets.size()];
+        const int64_t traceNs = static_cast<int64_t>(index / trace_.packets.size()) * span_ + packet.timeNs;
+        return static_cast<int64_t>(static_cast<double>(traceNs) / config_.speed);
+    }
+
+    // Sleeps most of the way and spins the rest, so datagrams leave close to their time.
+    void waitUntil(int64_t dueNs) const {
+        constexpr int64_t kSpinNs = 100'000;
+        const int64_t now = elapsedNs();
+        if (dueNs - now > 2 * kSpinNs) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(dueNs - now - kSpinNs));
+        }
+        while (elapsedNs() < dueNs) {
+            std::this_thread::yield();
+        }
+    }
+
+    void queue(size_t index) {
+        const auto& packet = trace_.packets[index % trace_.packets.size()];
+        const int64_t due = dueNs(index);
+        ReplayStats::count(stats_.targetWindows, due);
+        auto& batch = pending_[packet.socket];
+        if (batch.packets.empty()) {
+            dirty_.push_back(packet.socket);
+        }
+        batch.packets.push_back(OutgoingPacket{
+            .data = trace_.payloads.data() + packet.offset,
+            .size = packet.size,
+            .addr = target_,
+            .result = make_unexpected(ErrorCode::SendFailed),
+        });
+        batch.dueNs.push_back(due);
+        if (batch.packets.size() >= config_.batch) {
+            send(packet.socket);
+        }
+    }
+
+    void flush() {
+        for (uint32_t socket : dirty_) {
+            send(socket);
+        }
+        dirty_.clear();
+    }
+
+    // Sends what's queued for one socket. Datagrams the socket won't take now are counted, not retried:
+    // retrying would push everything behind them late.
+    void send(uint32_t socket) {
+        auto& batch = pending_[socket];
+        if (batch.packets.empty()) {
+            return;
+        }
+        (void)sockets_[socket]->sendBatch(batch.packets);
+        const int64_t now = elapsedNs();
+        for (size_t i = 0; i < batch.packets.size(); ++i) {
+            const auto& result = batch.packets[i].result;
+            if (result) {
+                ++stats_.sent;
+                ReplayStats::count(stats_.sentWindows, now);
+                const int64_t late = std::max<int64_t>(0, now - batch.dueNs[i]);
+                stats_.lateSumNs += late;
+                stats_.lateMaxNs = std::max(stats_.lateMaxNs, late);
+                stats_.lateOverMs += late > 1'000'000;
+            } else if (result.error() == ErrorCode::WouldBlock) {
+                ++stats_.wouldBlock;
+            } else {
+                ++stats_.errors;
+            }
+        }
+        batch.packets.clear();
+        batch.dueNs.clear();
+    }
+
+    // Counts whatever the server sent back, so a staging run shows it's answering.
+    void drainReplies() {
+        for (auto& socket : sockets_) {
+            while (true) {
+                for (size_t i = 0; i < replies_.size(); ++i) {
+                    replies_[i] = ReceivedPacket{ .data = replyStorage_[i].data(), .size = 0, .capacity = replyStorage_[i].size(), .addr = {} };
+                }
+                auto count = socket->recvBatch(replies_);
+                if (count) {
+                    stats_.replies += *count;
+                } else if (count.error() == ErrorCode::Truncated) {
+                    ++stats_.replies;
+                } else {
+                    break;
+                }
+            }
+        }
+    }
+
+    const Trace& trace_;
+    const ReplayConfig& config_;
+    std::vector<std::unique_ptr<ISocket>> sockets_;
+    Addr target_;
+    std::vector<PendingBatch> pending_;
+    std::vector<uint32_t> dirty_;
+    std::array<std::array<uint8_t, 2048>, 32> replyStorage_{};
+    std::array<ReceivedPacket, 32> replies_{};
+    ReplayStats stats_;
+    Clock::time_point start_;
+    int64_t span_ = 0;
+    double elapsedSeconds_ = 0;
+};
+
+std::optional<size_t> parseNumber(std::string_view text) {
+    size_t value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size() || value == 0) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<uint16_t> parsePort(std::string_view text) {
+    auto port = parseNumber(text);
+    if (!port || *port > 65535) {
+        return std::nullopt;
+    }
+    return static_cast<uint16_t>(*port);
+}
+
+// Any finite, non-negative multiplier; 0 is valid and means as fast as possible.
+std::optional<double> parseSpeed(std::string_view text) {
+    double value = 0;
+    const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size() || !std::isfinite(value) || value < 0) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+// "127.0.0.1:7777" or "[::1]:7777".
+std::expected<Addr, Error> parseTarget(std::string_view text) {
+    const size_t colon = text.rfind(':');
+    if (colon == std::string_view::npos || colon + 1 == text.size()) {
+        return make_unexpected(ErrorCode::InvalidArgument, "Target must be host:port");
+    }
+    std::string_view host = text.substr(0, colon);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') {
+        host = host.substr(1, host.size() - 2);
+    }
+    auto port = parsePort(text.substr(colon + 1));
+    if (!port) {
+        return make_unexpected(ErrorCode::InvalidArgument, "Port must be 1 to 65535");
+    }
+    return Addr::Create(std::string(host), *port);
+}
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " --file capture.pcapng --target host:port [--speed 1.0] [--loops 1]\n"
+              << "       [--dst-port 7777] [--batch 32] [--sockets 1024] [--backend default|io_uring|memory]\n"
+              << "Replays the UDP payloads in a pcap or pcapng file at their recorded times divided by --speed\n"
+              << "(0 sends as fast as possible), one local socket per original source. The summary goes to\n"
+              << "stdout as JSON; per-second progress goes to stderr." << std::endl;
+}
+
+std::expected<ISocketFactory*, Error> factoryFor(std::string_view backend) {
+    if (backend == "default") {
+        return get_socket_factory();
+    }
+    if (backend == "io_uring") {
+        return get_io_uring_socket_factory();
+    }
+    if (backend == "memory") {
+        // Goes nowhere unless something in this process listens; handy for checking a capture parses.
+        static auto network = MemoryNetwork::Create();
+        if (!network) {
+            return std::unexpected(network.error());
+        }
+        return network->get();
+    }
+    return make_unexpected(ErrorCode::InvalidArgument, "Unknown backend");
+}
+
+int main(int argc, char* argv[]) {
+    ReplayConfig config;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view flag = argv[i];
+        if (flag == "--help" || i + 1 == argc) {
+            printUsage(argv[0]);
+            return flag == "--help" ? 0 : 1;
+        }
+        const std::string_view value = argv[++i];
+        bool valid = true;
+        if (flag == "--file") {
+            config.file = value;
+        } else if (flag == "--target") {
+            config.target = value;
+        } else if (flag == "--backend") {
+            config.backend = value;
+        } else if (flag == "--speed") {
+            auto speed = parseSpeed(value);
+            valid = speed.has_value();
+            config.speed = speed.value_or(0.0);
+        } else if (flag == "--loops") {
+            auto loops = parseNumber(value);
+            valid = loops.has_value();
+            config.loops = loops.value_or(0);
+        } else if (flag == "--batch") {
+            auto batch = parseNumber(value);
+            valid = batch.has_value();
+            config.batch = batch.value_or(0);
+        } else if (flag == "--sockets") {
+            auto sockets = parseNumber(value);
+            valid = sockets.has_value();
+            config.maxSockets = sockets.value_or(0);
+        } else if (flag == "--dst-port") {
+            auto port = parsePort(value);
+            valid = port.has_value();
+            config.dstPort = port;
+        } else {
+            valid = false;
+        }
+        if (!valid) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.file.empty() || config.target.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    auto target = parseTarget(config.target);
+    if (!target) {
+        std::cerr << "Bad target " << config.target << ": " << to_string(target) << std::endl;
+        return 1;
+    }
+    auto trace = loadTrace(config);
+    if (!trace) {
+        return 1;
+    }
+    if (trace->packets.empty()) {
+        std::cerr << "No UDP datagrams to replay in " << config.file << " (" << trace->skipped << " skipped)" << std::endl;
+        return 1;
+    }
+
+    auto factory = factoryFor(config.backend);
+    if (!factory) {
+        std::cerr << "Backend " << config.backend << " unavailable: " << to_string(factory) << std::endl;
+        return 1;
+    }
+    const Addr local = *Addr::Create(target->isIPv6() ? Addr::kAnyIPv6 : Addr::kAnyIPv4, 0);
+    std::vector<std::unique_ptr<ISocket>> sockets;
+    for (size_t i = 0; i < std::min(trace->sources, config.maxSockets); ++i) {
+        auto socket = (*factory)->listen(local, { .sendBufferSize = 1 << 20 });
+        if (!socket) {
+            std::cerr << "Failed to open socket " << i << ": " << to_string(socket) << std::endl;
+            return 1;
+        }
+        sockets.push_back(std::move(*socket));
+    }
+    std::cerr << "Replaying " << trace->packets.size() << " datagrams from " << trace->sources << " sources on "
+              << sockets.size() << " sockets" << (config.loops > 1 ? ", " + std::to_string(config.loops) + " times" : "") << std::endl;
+
+    Replayer replayer(*trace, config, std::move(sockets), *target);
+    const ReplayStats stats = replayer.run();
+
+    const uint64_t packets = trace->packets.size() * config.loops;
+    const double scheduled = replayer.scheduledSeconds();
+    const double elapsed = replayer.elapsedSeconds();
+    const double targetPps = scheduled > 0 ? static_cast<double>(packets) / scheduled : 0.0;
+    const double achievedPps = elapsed > 0 ? static_cast<double>(stats.sent) / elapsed : 0.0;
+    std::cerr << std::fixed << std::setprecision(0) << "Sent " << stats.sent << " of " << packets << " in "
+              << std::setprecision(3) << elapsed << " s: " << std::setprecision(0) << achievedPps << " pps against a target of "
+              << targetPps << " pps" << std::endl;
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "{\"file\":\"" << config.file << "\",\"backend\":\"" << config.backend << "\",\"speed\":" << config.speed
+              << ",\"loops\":" << config.loops << ",\"sources\":" << trace->sources << ",\"sockets\":" << std::min(trace->sources, config.maxSockets)
+              << ",\"skipped\":" << trace->skipped << ",\"truncated\":" << trace->truncated
+              << ",\"packets\":" << packets << ",\"sent\":" << stats.sent << ",\"would_block\":" << stats.wouldBlock
+              << ",\"errors\":" << stats.errors << ",\"replies\":" << stats.replies
+              << ",\"scheduled_seconds\":" << scheduled << ",\"elapsed_seconds\":" << elapsed
+              << ",\"target_pps\":" << targetPps << ",\"achieved_pps\":" << achievedPps
+              << ",\"peak_target_pps\":" << ReplayStats::peakPps(stats.targetWindows)
+              << ",\"peak_achieved_pps\":" << ReplayStats::peakPps(stats.sentWindows)
+              << ",\"late_mean_us\":" << (stats.sent ? static_cast<double>(stats.lateSumNs) / static_cast<double>(stats.sent) / 1e3 : 0.0)
+              << ",\"late_max_us\":" << static_cast<double>(stats.lateMaxNs) / 1e3
+              << ",\"late_over_1ms\":" << stats.lateOverMs << "}" << std::endl;
+
+    return stats.sent == packets ? 0 : 1;
+}